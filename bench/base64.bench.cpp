@@ -0,0 +1,104 @@
+//
+// Created by konstantin on 17.10.26.
+//
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+#include "base64.hpp"
+
+namespace {
+    constexpr size_t INPUT_SIZE = 16 * 1024 * 1024;
+    constexpr int REPETITIONS = 20;
+
+    template <typename F>
+    double gigabytes_per_second(size_t bytes, F&& f) {
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < REPETITIONS; ++i)
+            f();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return static_cast<double>(bytes) * REPETITIONS / elapsed.count() / 1e9;
+    }
+
+    template <typename F>
+    double nanoseconds_per_call(size_t calls, F&& f) {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < calls; ++i)
+            f();
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / static_cast<double>(calls);
+    }
+}
+
+int main() {
+    using namespace pinepp;
+    const auto default_kernel = base64_active_kernel();
+    std::string input(INPUT_SIZE, '\0');
+    for (size_t i = 0; i < input.size(); ++i)
+        input[i] = static_cast<char>((i * 7919 + 13) % 256);
+    const auto encoded = base64_encode(input);
+
+    const std::pair<base64_kernel, const char*> kernels[] = {
+            {base64_kernel::SCALAR, "scalar"},
+            {base64_kernel::SSE41, "sse4.1"},
+            {base64_kernel::AVX2, "avx2"},
+            {base64_kernel::AVX512, "avx512"}
+    };
+
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto& [kernel, name] : kernels) {
+        if (!base64_select_kernel(kernel)) {
+            std::cout << std::setw(8) << name << "  not supported\n";
+            continue;
+        }
+        size_t sink = 0;
+        const auto encode = gigabytes_per_second(input.size(), [&] { sink += base64_encode(input).size(); });
+        const auto decode = gigabytes_per_second(encoded.size(), [&] { sink += base64_decode(encoded).size(); });
+        std::cout << std::setw(8) << name << "  encode " << std::setw(6) << encode << " GB/s"
+                  << "  decode " << std::setw(6) << decode << " GB/s"
+                  << (sink == 0 ? " (no output)" : "") << '\n';
+    }
+
+    base64_select_kernel(default_kernel);
+    base64_set_parallelism(1024 * 1024);
+    size_t sink = 0;
+    const auto encode = gigabytes_per_second(input.size(), [&] { sink += base64_encode(input).size(); });
+    const auto decode = gigabytes_per_second(encoded.size(), [&] { sink += base64_decode(encoded).size(); });
+    std::cout << "parallel  encode " << std::setw(6) << encode << " GB/s"
+              << "  decode " << std::setw(6) << decode << " GB/s"
+              << (sink == 0 ? " (no output)" : "") << '\n';
+    base64_set_parallelism(std::numeric_limits<size_t>::max());
+
+    const auto mime = base64_mime::encode(input);
+    const auto lenient = gigabytes_per_second(mime.size(), [&] { sink += base64_decode_lenient(mime).size(); });
+    std::cout << " lenient  decode " << std::setw(6) << lenient << " GB/s (MIME line breaks)"
+              << (sink == 0 ? " (no output)" : "") << '\n';
+
+    std::vector<std::string_view> fields;
+    for (size_t offset = 0, len = 20; offset + len <= input.size() && fields.size() < 1000000; offset += len) {
+        fields.emplace_back(input.data() + offset, len);
+        len = 20 + (len * 7) % 181;
+    }
+    size_t field_bytes = 0;
+    for (const auto field : fields)
+        field_bytes += field.size();
+    const auto single = gigabytes_per_second(field_bytes, [&] {
+        for (const auto field : fields)
+            sink += base64_encode(field).size();
+    });
+    const auto batched = gigabytes_per_second(field_bytes, [&] { sink += base64_encode_batch(fields).size(); });
+    std::cout << "\n" << fields.size() << " fields of 20-200 bytes  one call per field " << std::setw(6) << single
+              << " GB/s  batched " << std::setw(6) << batched << " GB/s\n";
+
+    std::cout << "\nper-call decode latency\n";
+    for (size_t size = 16; size <= 1024 * 1024; size *= 4) {
+        const auto token = base64_encode(input.substr(0, size));
+        size_t sink = 0;
+        const auto latency = nanoseconds_per_call(INPUT_SIZE / size, [&] { sink += base64_decode(token).size(); });
+        std::cout << std::setw(8) << size << " B  " << std::setw(12) << latency << " ns"
+                  << (sink == 0 ? " (no output)" : "") << '\n';
+    }
+}
@@ -0,0 +1,222 @@
+//
+// Created by konstantin on 17.10.26.
+//
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "atomic_bit_pattern.hpp"
+#include "bit_pattern.hpp"
+#include "bit_span.hpp"
+
+namespace {
+    constexpr size_t PATTERN_BITS = 128 * 1024 * 1024;
+    constexpr int REPETITIONS = 20;
+
+    template <typename F>
+    double gigabytes_per_second(size_t bytes, F&& f) {
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < REPETITIONS; ++i)
+            f();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return static_cast<double>(bytes) * REPETITIONS / elapsed.count() / 1e9;
+    }
+
+    template <typename F>
+    double nanoseconds_per_call(size_t calls, F&& f) {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < calls; ++i)
+            f();
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / static_cast<double>(calls);
+    }
+}
+
+int main() {
+    using namespace pinepp;
+    const auto default_kernel = bit_pattern_active_kernel();
+    bit_pattern bp1{PATTERN_BITS};
+    bit_pattern bp2{PATTERN_BITS};
+    for (size_t i = 0; i < PATTERN_BITS; ++i) {
+        bp1.set_bit(i, (i * 7919 + 13) % 3 == 0);
+        bp2.set_bit(i, (i * 104729 + 7) % 5 == 0);
+    }
+    // TWO OPERANDS READ AND ONE RESULT WRITTEN
+    const size_t bytes = 3 * PATTERN_BITS / 8;
+
+    const std::pair<bit_pattern_kernel, const char*> kernels[] = {
+            {bit_pattern_kernel::SCALAR, "scalar"},
+            {bit_pattern_kernel::AVX2, "avx2"},
+            {bit_pattern_kernel::AVX512, "avx512"}
+    };
+
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto& [kernel, name] : kernels) {
+        if (!bit_pattern_select_kernel(kernel)) {
+            std::cout << std::setw(8) << name << "  not supported\n";
+            continue;
+        }
+        // THE OPERATORS ARE LAZY, SO EVERY RESULT IS EVALUATED INTO A FRESH PATTERN
+        size_t sink = 0;
+        const auto conjunction = gigabytes_per_second(bytes, [&] { sink += bit_pattern{bp1 & bp2}.size(); });
+        const auto disjunction = gigabytes_per_second(bytes, [&] { sink += bit_pattern{bp1 | bp2}.size(); });
+        const auto exclusive = gigabytes_per_second(bytes, [&] { sink += bit_pattern{bp1 ^ bp2}.size(); });
+        const auto negation = gigabytes_per_second(bytes * 2 / 3, [&] { sink += bit_pattern{~bp1}.size(); });
+        // A WHOLE EXPRESSION STILL READS EVERY OPERAND ONCE AND WRITES THE DESTINATION ONCE
+        bit_pattern dst{PATTERN_BITS};
+        const auto fused = gigabytes_per_second(bytes, [&] {
+            dst = (bp1 & bp2) | ~(bp1 ^ bp2);
+            sink += dst.size();
+        });
+        std::cout << std::setw(8) << name << "  and " << std::setw(6) << conjunction << " GB/s"
+                  << "  or " << std::setw(6) << disjunction << " GB/s"
+                  << "  xor " << std::setw(6) << exclusive << " GB/s"
+                  << "  not " << std::setw(6) << negation << " GB/s"
+                  << "  (a & b) | ~(a ^ b) " << std::setw(6) << fused << " GB/s"
+                  << (sink == 0 ? " (no output)" : "") << '\n';
+    }
+    bit_pattern_select_kernel(default_kernel);
+
+    // PARSING AND FORMATTING MOVE ONE CHARACTER PER BIT OR PER 4 BITS
+    std::cout << "\nparsing and formatting " << PATTERN_BITS / 1024 / 1024 << " Mbit\n";
+    const bit_pattern text{bp1 ^ (bp2 << 1)};
+    const auto binary = text.str();
+    const auto hex = text.hex_str();
+    for (const auto& [kernel, name] : kernels) {
+        if (!bit_pattern_select_kernel(kernel))
+            continue;
+        size_t sink = 0;
+        const auto parse_binary = gigabytes_per_second(binary.size(), [&] { sink += bit_pattern{binary}.size(); });
+        const auto parse_hex = gigabytes_per_second(hex.size(), [&] { sink += bit_pattern{hex}.size(); });
+        std::cout << std::setw(8) << name << "  parse binary " << std::setw(6) << parse_binary << " GB/s"
+                  << "  parse hex " << std::setw(6) << parse_hex << " GB/s"
+                  << (sink == 0 ? " (no output)" : "") << '\n';
+    }
+    bit_pattern_select_kernel(default_kernel);
+    size_t formatted = 0;
+    const auto format_binary = gigabytes_per_second(binary.size(), [&] { formatted += text.str().size(); });
+    const auto format_hex = gigabytes_per_second(hex.size(), [&] { formatted += text.hex_str().size(); });
+    std::cout << "          str " << std::setw(6) << format_binary << " GB/s  hex_str " << std::setw(6) << format_hex
+              << " GB/s" << (formatted == 0 ? " (no output)" : "") << '\n';
+
+    // REVERSING AND CONCATENATING MOVE WHOLE WORDS, BUILDING APPENDS ONE BIT AT A TIME
+    std::cout << "\nreshaping " << PATTERN_BITS / 1024 / 1024 << " Mbit\n";
+    for (const auto& [kernel, name] : kernels) {
+        if (!bit_pattern_select_kernel(kernel))
+            continue;
+        bit_pattern reversed{text};
+        const auto reversing = gigabytes_per_second(binary.size() / 8, [&] { reversed.reverse(); });
+        std::cout << std::setw(8) << name << "  reverse " << std::setw(6) << reversing << " GB/s"
+                  << (reversed.size() == 0 ? " (no output)" : "") << '\n';
+    }
+    bit_pattern_select_kernel(default_kernel);
+    size_t built = 0;
+    const auto concatenation = gigabytes_per_second(binary.size() / 4, [&] { built += (text + text).size(); });
+    const auto pushing = nanoseconds_per_call(100, [&] {
+        bit_pattern pattern;
+        for (size_t i = 0; i < 1'000'000; ++i)
+            pattern.push_back(i % 3 == 0);
+        built += pattern.size();
+    }) / 1'000'000;
+    std::cout << "           +  " << std::setw(6) << concatenation << " GB/s  push_back " << std::setw(6) << pushing
+              << " ns/bit" << (built == 0 ? " (no output)" : "") << '\n';
+
+    // VISITING THE SET BITS COSTS TIME PER SET BIT RATHER THAN PER BIT
+    std::cout << "\nvisiting the set bits of " << PATTERN_BITS / 1024 / 1024 << " Mbit\n";
+    for (size_t stride : {2ul, 64ul, 4096ul}) {
+        bit_pattern sparse{PATTERN_BITS};
+        for (size_t i = 0; i < PATTERN_BITS; i += stride)
+            sparse[i] = true;
+        size_t visited = 0;
+        const auto ranged = nanoseconds_per_call(1, [&] {
+            for (size_t i : sparse.set_bits())
+                visited += i;
+        });
+        const auto found = nanoseconds_per_call(1, [&] {
+            for (auto i = sparse.find_first(); i != bit_pattern::npos; i = sparse.find_next(i))
+                visited += i;
+        });
+        const auto iterated = nanoseconds_per_call(1, [&] {
+            for (int bit : sparse)
+                visited += static_cast<size_t>(bit);
+        });
+        std::cout << "  every " << std::setw(4) << stride << "th bit  set_bits " << std::setw(9) << ranged / 1e6
+                  << " ms  find_next " << std::setw(9) << found / 1e6 << " ms  iterator " << std::setw(9)
+                  << iterated / 1e6 << " ms" << (visited == 0 ? " (no output)" : "") << '\n';
+    }
+
+    // SPANS WORK ON SLICES IN PLACE. UNALIGNED SPANS PUT EVERY SOURCE WORD TOGETHER FROM TWO
+    std::cout << "\nspans of " << PATTERN_BITS / 1024 / 1024 - 1 << " Mbit\n";
+    {
+        bit_pattern dst{bp1};
+        const auto slice = PATTERN_BITS - 1024 * 1024;
+        const bit_span to{dst, 64, slice};
+        const auto aligned = gigabytes_per_second(slice / 4, [&] { to ^= const_bit_span{bp2, 128, slice}; });
+        const auto unaligned = gigabytes_per_second(slice / 4, [&] { to ^= const_bit_span{bp2, 131, slice}; });
+        size_t counted = 0;
+        const auto counting = gigabytes_per_second(slice / 8, [&] { counted += to.count_range(3, slice - 3); });
+        std::cout << "     aligned ^= " << std::setw(6) << aligned << " GB/s  unaligned ^= " << std::setw(6) << unaligned
+                  << " GB/s  count_range " << std::setw(6) << counting << " GB/s"
+                  << (counted == 0 ? " (no output)" : "") << '\n';
+    }
+
+    // COMPARING AND HASHING READ EVERY WORD ONCE
+    const bit_pattern text_copy{text};
+    size_t compared = 0;
+    const auto equality = gigabytes_per_second(binary.size() / 4, [&] { compared += text == text_copy; });
+    const auto hashing = gigabytes_per_second(binary.size() / 8, [&] { compared += text.hash() & 1; });
+    std::cout << "           == " << std::setw(6) << equality << " GB/s     hash " << std::setw(6) << hashing
+              << " GB/s" << (compared == 0 ? " (no output)" : "") << '\n';
+
+    // SHORT PATTERNS ARE BOUND BY THE COST OF A CALL AND ITS ALLOCATIONS RATHER THAN BY BANDWIDTH
+    std::cout << "\nper-call latency of short patterns\n";
+    for (size_t len : {64ul, 128ul, 129ul, 512ul}) {
+        bit_pattern small1{len};
+        bit_pattern small2{len, true};
+        small1.set_bit(0, true);
+        size_t sink = 0;
+        const auto copy = nanoseconds_per_call(10'000'000, [&] {
+            bit_pattern copied{small1};
+            sink += copied.size();
+        });
+        const auto conjunction = nanoseconds_per_call(10'000'000, [&] { sink += bit_pattern{small1 & small2}.count(); });
+        const auto hashing = nanoseconds_per_call(10'000'000, [&] { sink += std::hash<bit_pattern>{}(small1) & 1; });
+        std::cout << std::setw(8) << len << " bits  copy " << std::setw(6) << copy << " ns  and " << std::setw(6)
+                  << conjunction << " ns  hash " << std::setw(6) << hashing << " ns"
+                  << (sink == 0 ? " (no output)" : "") << '\n';
+    }
+
+    // THREADS WALK THE SAME SCATTERED ORDER OF BITS FROM DIFFERENT STARTING POINTS, SO EVERY BIT IS CLAIMED BY EACH
+    // THREAD ONCE, BUT THEY RARELY HIT THE SAME CACHE LINE AT THE SAME TIME
+    std::cout << "\natomic_bit_pattern test_and_set of 16M bits\n";
+    for (unsigned threads : {1u, 2u, 4u, 8u}) {
+        constexpr size_t BITS = 16 * 1024 * 1024;
+        atomic_bit_pattern visited{BITS};
+        std::vector<size_t> claims(threads);
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                // COUNTED LOCALLY, THE SLOTS OF claims SHARE A CACHE LINE
+                size_t claimed = 0;
+                for (size_t i = 0; i < BITS; ++i) {
+                    const auto step = i + t * BITS / threads;
+                    if (!visited.test_and_set(step * 2654435761u % BITS, std::memory_order_relaxed))
+                        claimed++;
+                }
+                claims[t] = claimed;
+            });
+        }
+        for (auto& worker : workers)
+            worker.join();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        size_t claimed = 0;
+        for (auto c : claims)
+            claimed += c;
+        std::cout << std::setw(8) << threads << " threads  " << std::setw(7)
+                  << static_cast<double>(BITS) * threads / elapsed.count() / 1e6 << " M ops/s  claimed "
+                  << claimed << " bits\n";
+    }
+}
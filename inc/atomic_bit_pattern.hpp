@@ -0,0 +1,130 @@
+//
+// Created by konstantin on 17.10.26.
+//
+
+#ifndef PINEPP_ATOMIC_BIT_PATTERN_HPP
+#define PINEPP_ATOMIC_BIT_PATTERN_HPP
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "bit_pattern.hpp"
+
+namespace pinepp {
+
+    /**
+     * @brief A fixed size bit pattern that many threads can read and write at the same time without locks
+     * @details The bits are stored in std::atomic<uint64_t> words, numbered like the words of bit_pattern. Every
+     * operation on a single bit or word is one atomic read-modify-write, so concurrent writers never lose updates.
+     * Operations that touch several words, like snapshot(), are not atomic as a whole.
+     */
+    class atomic_bit_pattern {
+        static_assert(std::atomic<uint64_t>::is_always_lock_free, "atomic_bit_pattern requires lock-free words");
+    public:
+        /**
+         * @details Constructs a pattern of \p n bits that are all 0
+         * @param n The amount of bits in the pattern
+         */
+        explicit atomic_bit_pattern(size_t n);
+
+        /**
+         * @details Constructs a pattern with the same bits as \p pattern
+         */
+        explicit atomic_bit_pattern(const bit_pattern& pattern);
+
+        atomic_bit_pattern(const atomic_bit_pattern&) = delete;
+        atomic_bit_pattern& operator=(const atomic_bit_pattern&) = delete;
+        /**
+         * @details Moving a pattern is not thread-safe. The moved-from pattern is left empty.
+         */
+        atomic_bit_pattern(atomic_bit_pattern&& other) noexcept;
+        atomic_bit_pattern& operator=(atomic_bit_pattern&& other) noexcept;
+        ~atomic_bit_pattern() = default;
+
+        /**
+         * @returns The amount of bits in the pattern
+         */
+        [[nodiscard]] size_t size() const noexcept { return m_Len; }
+
+        /**
+         * @returns The amount of words the bits are stored in
+         */
+        [[nodiscard]] size_t word_count() const noexcept { return (m_Len + 63) / 64; }
+
+        /**
+         * @returns The value of the bit at position \p index
+         * @throws std::out_of_range if \p index is not less than size()
+         */
+        [[nodiscard]] bool test(size_t index, std::memory_order order = std::memory_order_seq_cst) const;
+
+        /**
+         * @details Sets the bit at position \p index to 1 with a single fetch_or, like std::atomic_flag.
+         * @returns The previous value of the bit, so exactly one of several threads setting the same bit gets false
+         * @throws std::out_of_range if \p index is not less than size()
+         */
+        bool test_and_set(size_t index, std::memory_order order = std::memory_order_seq_cst);
+
+        /**
+         * @details Sets the bit at position \p index to 0 with a single fetch_and.
+         * @returns The previous value of the bit
+         * @throws std::out_of_range if \p index is not less than size()
+         */
+        bool test_and_reset(size_t index, std::memory_order order = std::memory_order_seq_cst);
+
+        /**
+         * @details Sets the bit at position \p index to 1 if \p value is true or 0 otherwise.
+         * @throws std::out_of_range if \p index is not less than size()
+         */
+        void set_bit(size_t index, bool value, std::memory_order order = std::memory_order_seq_cst);
+
+        /**
+         * @returns The word at position \p word, the bits past size() being 0
+         * @throws std::out_of_range if \p word is not less than word_count()
+         */
+        [[nodiscard]] uint64_t load_word(size_t word, std::memory_order order = std::memory_order_seq_cst) const;
+
+        /**
+         * @details ORs \p mask into the word at position \p word. Bits of \p mask past size() are ignored.
+         * @returns The previous value of the word
+         * @throws std::out_of_range if \p word is not less than word_count()
+         */
+        uint64_t fetch_or_word(size_t word, uint64_t mask, std::memory_order order = std::memory_order_seq_cst);
+
+        /**
+         * @details ANDs \p mask into the word at position \p word.
+         * @returns The previous value of the word
+         * @throws std::out_of_range if \p word is not less than word_count()
+         */
+        uint64_t fetch_and_word(size_t word, uint64_t mask, std::memory_order order = std::memory_order_seq_cst);
+
+        /**
+         * @details XORs \p mask into the word at position \p word. Bits of \p mask past size() are ignored.
+         * @returns The previous value of the word
+         * @throws std::out_of_range if \p word is not less than word_count()
+         */
+        uint64_t fetch_xor_word(size_t word, uint64_t mask, std::memory_order order = std::memory_order_seq_cst);
+
+        /**
+         * @details Copies the bits into a regular bit_pattern, loading every word on its own with \p order. Words
+         * changed while the snapshot is taken may or may not show the change, so the snapshot is only consistent
+         * if no thread is writing.
+         */
+        [[nodiscard]] bit_pattern snapshot(std::memory_order order = std::memory_order_relaxed) const;
+
+    private:
+        /**
+         * @throws std::out_of_range if \p word is not less than word_count()
+         */
+        void check_word(size_t word) const;
+        /**
+         * @returns The bits of word \p word that lie within the pattern
+         * @throws std::out_of_range if \p word is not less than word_count()
+         */
+        [[nodiscard]] uint64_t valid_bits(size_t word) const;
+
+        std::unique_ptr<std::atomic<uint64_t>[]> mp_Words;
+        size_t m_Len = 0;
+    };
+}
+
+#endif //PINEPP_ATOMIC_BIT_PATTERN_HPP
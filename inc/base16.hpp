@@ -0,0 +1,98 @@
+//
+// Created by konstantin on 17.10.26.
+//
+
+#ifndef PINEPP_BASE16_HPP
+#define PINEPP_BASE16_HPP
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include "base64.hpp"
+
+namespace pinepp {
+
+    /**
+     * @brief Enum class representing the case of the letters in a base16 encoding
+     */
+    enum class base16_case : uint8_t { LOWER, UPPER };
+
+    /**
+     * @returns The exact amount of characters in the base16 encoding of \p n bytes
+     */
+    constexpr size_t base16_encoded_size(size_t n) {
+        return 2 * n;
+    }
+
+    /**
+     * @details Computes the exact amount of bytes \p base16 decodes to. Does not validate the characters of
+     * \p base16.
+     * @throws std::invalid_argument if the length of \p base16 is odd
+     */
+    size_t base16_decoded_size(std::string_view base16);
+
+    /**
+     * @details Converts an ASCII string (std::string) to base16 (hexadecimal), two digits per byte with the most
+     * significant digit first. Uses the kernel selected by base64_select_kernel.
+     * @param str The string to encode
+     * @param letter_case The case of the digits a to f
+     * @returns A string containing the base16 representation of \p str
+     */
+    std::string base16_encode(std::string_view str, base16_case letter_case = base16_case::LOWER);
+
+    /**
+     * @details Converts a sequence of bytes to base16 (hexadecimal).
+     * @param bytes The bytes to encode
+     * @param letter_case The case of the digits a to f
+     * @returns A string containing the base16 representation of \p bytes
+     */
+    std::string base16_encode(std::span<const std::byte> bytes, base16_case letter_case = base16_case::LOWER);
+
+    /**
+     * @details Encodes \p str into a caller provided buffer without allocating.
+     * @param str The bytes to encode
+     * @param dst The buffer to write to. Must hold at least base16_encoded_size(str.size()) characters.
+     * @param letter_case The case of the digits a to f
+     * @returns The amount of characters written
+     * @throws std::invalid_argument if \p dst is too small
+     */
+    size_t base16_encode(std::string_view str, std::span<char> dst, base16_case letter_case = base16_case::LOWER);
+
+    /**
+     * @details Encodes \p bytes into a caller provided buffer without allocating.
+     * @param bytes The bytes to encode
+     * @param dst The buffer to write to. Must hold at least base16_encoded_size(bytes.size()) characters.
+     * @param letter_case The case of the digits a to f
+     * @returns The amount of characters written
+     * @throws std::invalid_argument if \p dst is too small
+     */
+    size_t base16_encode(std::span<const std::byte> bytes, std::span<char> dst,
+                         base16_case letter_case = base16_case::LOWER);
+
+    /**
+     * @details Converts a base16 encoding to an ASCII string (std::string). Accepts digits of either case and
+     * performs validity check on the base16 string.
+     * @param input The base16 string to decode
+     * @returns An ASCII string
+     */
+    std::string base16_decode(std::string_view input);
+
+    /**
+     * @details Decodes \p input into a caller provided buffer without allocating. Performs validity check on the
+     * base16 string.
+     * @param input The base16 string to decode
+     * @param dst The buffer to write to. Must hold at least base16_decoded_size(input) bytes.
+     * @returns The amount of bytes written
+     * @throws std::invalid_argument if \p input is invalid or \p dst is too small
+     */
+    size_t base16_decode(std::string_view input, std::span<std::byte> dst);
+
+    /**
+     * @copydoc base16_decode(std::string_view, std::span<std::byte>)
+     */
+    size_t base16_decode(std::string_view input, std::span<char> dst);
+
+}
+
+#endif //PINEPP_BASE16_HPP
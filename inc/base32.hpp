@@ -0,0 +1,203 @@
+//
+// Created by konstantin on 17.10.26.
+//
+
+#ifndef PINEPP_BASE32_HPP
+#define PINEPP_BASE32_HPP
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include "base64.hpp"
+
+namespace pinepp {
+
+    /**
+     * @brief Enum class representing the alphabets of RFC 4648. STANDARD uses A to Z and 2 to 7, HEX uses 0 to 9
+     * and A to V and preserves the sort order of the encoded data.
+     */
+    enum class base32_alphabet : uint8_t { STANDARD, HEX };
+
+    /**
+     * @brief The block level building blocks of a base32 alphabet, dispatched to the kernel selected by
+     * base64_select_kernel
+     * @details A block is 5 bytes or 8 characters. Only instantiated for the alphabets in base32_alphabet. Use
+     * basic_base32 instead of calling these directly.
+     */
+    template <base32_alphabet A>
+    class base32_blocks {
+    public:
+        /**
+         * @details Encodes as many whole 5 byte blocks of \p src as possible.
+         * @returns The amount of bytes consumed
+         */
+        static size_t encode(const std::byte* src, size_t len, char* dst);
+
+        /**
+         * @details Encodes the last \p len < 5 bytes of an input, padded to 8 characters if \p pad is set.
+         * @returns The amount of characters written
+         */
+        static size_t encode_tail(const std::byte* src, size_t len, char* dst, bool pad);
+
+        /**
+         * @details Decodes whole 8 character blocks of \p src up to the first block containing an invalid character
+         * or padding.
+         * @returns The amount of characters consumed
+         */
+        static size_t decode(const char* src, size_t len, std::byte* dst);
+
+        /**
+         * @details Decodes the last block of an input. A block of 8 characters may be padded, shorter blocks must
+         * not be.
+         * @returns The amount of bytes written
+         * @throws std::invalid_argument if the block is invalid
+         */
+        static size_t decode_tail(const char* src, size_t len, std::byte* dst);
+    };
+
+    extern template class base32_blocks<base32_alphabet::STANDARD>;
+    extern template class base32_blocks<base32_alphabet::HEX>;
+
+    /**
+     * @brief A base32 dialect fixed at compile-time
+     * @details The dialect is made up of an alphabet and a padding policy, which works like the one of
+     * basic_base64. Decoding accepts lower case letters as well, as found in e.g. TOTP secrets.
+     */
+    template <base32_alphabet A, base64_padding P = base64_padding::REQUIRED>
+    class basic_base32 {
+        using blocks = base32_blocks<A>;
+
+        [[noreturn]] static void throw_invalid_encoding() {
+            throw std::invalid_argument{"Given string is not a valid base32 encoding"};
+        }
+
+        /**
+         * @returns The amount of bytes an unpadded final block of \p chars characters decodes to or 0 if no block
+         * has this length
+         */
+        static constexpr size_t tail_bytes(size_t chars) {
+            constexpr size_t bytes[8] = {0, 0, 1, 0, 2, 3, 0, 4};
+            return bytes[chars];
+        }
+
+    public:
+        /**
+         * @returns The exact amount of characters in the encoding of \p n bytes
+         */
+        static constexpr size_t encoded_size(size_t n) {
+            return P == base64_padding::REQUIRED ? (n + 4) / 5 * 8 : (n * 8 + 4) / 5;
+        }
+
+        /**
+         * @details Computes the exact amount of bytes \p encoding decodes to. Validates the amount of padding but
+         * not the characters.
+         * @throws std::invalid_argument if \p encoding can't be a valid encoding because of its length
+         */
+        static size_t decoded_size(std::string_view encoding) {
+            auto chars = encoding.size();
+            if (P == base64_padding::REQUIRED && chars % 8 != 0)
+                throw_invalid_encoding();
+            if (P != base64_padding::NONE && chars > 0 && chars % 8 == 0) {
+                while (chars > encoding.size() - 6 && encoding[chars - 1] == '=')
+                    chars--;
+            }
+            if (chars % 8 != 0 && tail_bytes(chars % 8) == 0)
+                throw_invalid_encoding();
+            return chars / 8 * 5 + tail_bytes(chars % 8);
+        }
+
+        /**
+         * @details Encodes \p bytes into a caller provided buffer.
+         * @param dst The buffer to write to. Must hold at least encoded_size(bytes.size()) characters.
+         * @returns The amount of characters written
+         * @throws std::invalid_argument if \p dst is too small
+         */
+        static size_t encode(std::span<const std::byte> bytes, std::span<char> dst) {
+            if (dst.size() < encoded_size(bytes.size()))
+                throw std::invalid_argument{"Destination buffer is too small for the base32 encoding"};
+            const auto consumed = blocks::encode(bytes.data(), bytes.size(), dst.data());
+            char* out = dst.data() + consumed / 5 * 8;
+            out += blocks::encode_tail(bytes.data() + consumed, bytes.size() - consumed, out,
+                                       P == base64_padding::REQUIRED);
+            return static_cast<size_t>(out - dst.data());
+        }
+
+        /**
+         * @copydoc encode(std::span<const std::byte>, std::span<char>)
+         */
+        static size_t encode(std::string_view str, std::span<char> dst) {
+            return encode(std::as_bytes(std::span{str}), dst);
+        }
+
+        /**
+         * @returns A string containing the encoding of \p bytes
+         */
+        static std::string encode(std::span<const std::byte> bytes) {
+            std::string result(encoded_size(bytes.size()), '\0');
+            encode(bytes, std::span{result});
+            return result;
+        }
+
+        /**
+         * @returns A string containing the encoding of \p str
+         */
+        static std::string encode(std::string_view str) {
+            return encode(std::as_bytes(std::span{str}));
+        }
+
+        /**
+         * @details Decodes \p encoding into a caller provided buffer. Performs validity check on the encoding.
+         * @param dst The buffer to write to. Must hold at least decoded_size(encoding) bytes.
+         * @returns The amount of bytes written
+         * @throws std::invalid_argument if \p encoding is invalid or \p dst is too small
+         */
+        static size_t decode(std::string_view encoding, std::span<std::byte> dst) {
+            const auto size = decoded_size(encoding);
+            if (dst.size() < size)
+                throw std::invalid_argument{"Destination buffer is too small for the decoded base32"};
+
+            const auto len = encoding.size();
+            if (len == 0)
+                return 0;
+            if (P == base64_padding::NONE && encoding.back() == '=')
+                throw_invalid_encoding();
+            const size_t tail = len % 8 == 0 ? 8 : len % 8;
+            if (blocks::decode(encoding.data(), len - tail, dst.data()) != len - tail)
+                throw_invalid_encoding();
+            blocks::decode_tail(encoding.data() + len - tail, tail, dst.data() + (len - tail) / 8 * 5);
+            return size;
+        }
+
+        /**
+         * @copydoc decode(std::string_view, std::span<std::byte>)
+         */
+        static size_t decode(std::string_view encoding, std::span<char> dst) {
+            return decode(encoding, std::as_writable_bytes(dst));
+        }
+
+        /**
+         * @returns A string containing the bytes \p encoding decodes to
+         * @throws std::invalid_argument if \p encoding is invalid
+         */
+        static std::string decode(std::string_view encoding) {
+            std::string result(decoded_size(encoding), '\0');
+            decode(encoding, std::span{result});
+            return result;
+        }
+    };
+
+    /**
+     * @brief The standard base32 of RFC 4648, section 6
+     */
+    using base32 = basic_base32<base32_alphabet::STANDARD>;
+
+    /**
+     * @brief The base32 of RFC 4648, section 7, with the extended hex alphabet
+     */
+    using base32hex = basic_base32<base32_alphabet::HEX>;
+
+}
+
+#endif //PINEPP_BASE32_HPP
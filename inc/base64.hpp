@@ -4,24 +4,821 @@
 
 #ifndef PINEPP_BASE64_HPP
 #define PINEPP_BASE64_HPP
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <span>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
 #include "bit_pattern.hpp"
 
 namespace pinepp {
 
+    /**
+     * @brief Enum class representing the instruction sets the base64 functions can be executed with
+     */
+    enum class base64_kernel : uint8_t { SCALAR, SSE41, AVX2, AVX512 };
+
+    /**
+     * @returns The kernel currently used by the base64 functions. Unless changed by base64_select_kernel, this is
+     * the widest kernel supported by the CPU, as reported by CPUID on first use.
+     */
+    base64_kernel base64_active_kernel();
+
+    /**
+     * @details Forces the base64 functions to use a specific kernel. This is mostly useful for benchmarking and
+     * testing. Not thread-safe with respect to concurrent encoding or decoding.
+     * @param kernel The kernel to use
+     * @returns False if the CPU doesn't support \p kernel, in which case the active kernel doesn't change
+     */
+    bool base64_select_kernel(base64_kernel kernel);
+
+    /**
+     * @details Enables the parallel mode of the base64 functions. Inputs of at least \p threshold bytes (when
+     * encoding) or characters (when decoding) are split into chunks of whole blocks which are processed on a
+     * shared thread pool, each chunk writing straight into its part of the output. The calling thread works on a
+     * chunk as well. Not thread-safe with respect to concurrent encoding or decoding.
+     * @param threshold The minimum input size to split. The default, std::numeric_limits<size_t>::max(), disables
+     * the parallel mode.
+     * @param threads The amount of chunks an input is split into, 0 meaning one per hardware thread
+     */
+    void base64_set_parallelism(size_t threshold, unsigned threads = 0);
+
+    /**
+     * @returns The minimum input size processed in parallel, as set by base64_set_parallelism
+     */
+    size_t base64_parallel_threshold();
+
+    /**
+     * @returns The exact amount of characters in the base64 encoding of \p n bytes
+     */
+    constexpr size_t base64_encoded_size(size_t n) {
+        return (n + 2) / 3 * 4;
+    }
+
+    /**
+     * @details Computes the exact amount of bytes \p base64 decodes to, taking padding into account. Does not
+     * validate the characters of \p base64.
+     * @throws std::invalid_argument if the length of \p base64 isn't a multiple of 4
+     */
+    size_t base64_decoded_size(std::string_view base64);
+
     /**
      * @details Converts an ASCII string (std::string) to base64.
      * @param str The string to encode
      * @returns A string containing the base64 representation of \p str
      */
-     std::string base64_encode(const std::string& str);
+     std::string base64_encode(std::string_view str);
+
+    /**
+     * @details Converts a sequence of bytes to base64.
+     * @param bytes The bytes to encode
+     * @returns A string containing the base64 representation of \p bytes
+     */
+     std::string base64_encode(std::span<const std::byte> bytes);
 
     /**
      * @details Converts a base64 encoding to an ASCII string (std::string). Performs validity check on base64 string.
      * @param input The base64 string to decode
      * @returns An ASCII string
      */
-     std::string base64_decode(const std::string& input);
+     std::string base64_decode(std::string_view input);
+
+    /**
+     * @details Encodes \p str into a caller provided buffer without allocating.
+     * @param str The bytes to encode
+     * @param dst The buffer to write to. Must hold at least base64_encoded_size(str.size()) characters.
+     * @returns The amount of characters written
+     * @throws std::invalid_argument if \p dst is too small
+     */
+     size_t base64_encode(std::string_view str, std::span<char> dst);
+
+    /**
+     * @details Encodes \p bytes into a caller provided buffer without allocating.
+     * @param bytes The bytes to encode
+     * @param dst The buffer to write to. Must hold at least base64_encoded_size(bytes.size()) characters.
+     * @returns The amount of characters written
+     * @throws std::invalid_argument if \p dst is too small
+     */
+     size_t base64_encode(std::span<const std::byte> bytes, std::span<char> dst);
+
+    /**
+     * @details Decodes \p input into a caller provided buffer without allocating. Performs validity check on the
+     * base64 string.
+     * @param input The base64 string to decode
+     * @param dst The buffer to write to. Must hold at least base64_decoded_size(input) bytes.
+     * @returns The amount of bytes written
+     * @throws std::invalid_argument if \p input is invalid or \p dst is too small
+     */
+     size_t base64_decode(std::string_view input, std::span<std::byte> dst);
+
+    /**
+     * @copydoc base64_decode(std::string_view, std::span<std::byte>)
+     */
+     size_t base64_decode(std::string_view input, std::span<char> dst);
+
+    /**
+     * @details Converts a base64 encoding to an ASCII string (std::string), skipping spaces, tabs and line breaks
+     * like the ones in PEM or MIME encodings. Performs validity check on the remaining characters.
+     * @param input The base64 string to decode
+     * @returns An ASCII string
+     */
+     std::string base64_decode_lenient(std::string_view input);
+
+    class base64_batch;
+
+    /**
+     * @details Converts many, typically small ASCII strings to base64 at once, storing all encodings in one
+     * contiguous buffer.
+     * @param inputs The strings to encode
+     * @returns The base64 representations of \p inputs
+     */
+     base64_batch base64_encode_batch(std::span<const std::string_view> inputs);
+
+    /**
+     * @details Encodes the file at \p src into the file at \p dst, which is created or truncated. Both files are
+     * memory-mapped and the encoding is written straight into the mapping of \p dst, so memory usage doesn't grow
+     * with the size of the file.
+     * @param src The location of the file to encode
+     * @param dst The location where to save the encoding
+     * @throws std::runtime_error if a file can't be opened, sized or mapped
+     * @throws std::invalid_argument if \p src and \p dst are the same file
+     */
+    void base64_encode_file(const std::string& src, const std::string& dst);
+
+    /**
+     * @details Decodes the base64 file at \p src into the file at \p dst like base64_encode_file. Line breaks and
+     * other whitespace are skipped like in base64_decode_lenient, so wrapped files and files ending in a line break
+     * are accepted. If \p src is invalid, \p dst is removed again.
+     * @param src The location of the base64 file to decode
+     * @param dst The location where to save the decoded bytes
+     * @throws std::runtime_error if a file can't be opened, sized or mapped
+     * @throws std::invalid_argument if \p src is not a valid base64 encoding or \p src and \p dst are the same file
+     */
+    void base64_decode_file(const std::string& src, const std::string& dst);
+
+    /**
+     * @brief Enum class representing the alphabets of RFC 4648. URL replaces '+' and '/' by '-' and '_'.
+     */
+    enum class base64_alphabet : uint8_t { STANDARD, URL };
+
+    /**
+     * @brief Enum class representing how a base64 dialect treats padding
+     * @details REQUIRED always pads to a multiple of 4 characters. NONE never pads and rejects padding. OPTIONAL
+     * doesn't pad when encoding but accepts both padded and unpadded input when decoding.
+     */
+    enum class base64_padding : uint8_t { REQUIRED, NONE, OPTIONAL };
+
+    /**
+     * @brief A string literal usable as a template argument
+     * @details Used to pass base64 payloads to the compile-time overloads of basic_base64. The terminating null
+     * character isn't part of the string.
+     */
+    template <size_t N>
+    struct fixed_string {
+        char data[N]{};
+
+        constexpr fixed_string(const char (&str)[N]) {
+            std::copy_n(str, N, data);
+        }
+
+        [[nodiscard]] constexpr size_t size() const {
+            return N - 1;
+        }
+
+        [[nodiscard]] constexpr std::string_view view() const {
+            return {data, N - 1};
+        }
+
+        [[nodiscard]] constexpr std::array<char, N - 1> array() const {
+            std::array<char, N - 1> result{};
+            std::copy_n(data, N - 1, result.begin());
+            return result;
+        }
+    };
+
+    /**
+     * @brief The block level building blocks of a base64 alphabet, dispatched to the active kernel
+     * @details Only instantiated for the alphabets in base64_alphabet. Use basic_base64 instead of calling these
+     * directly.
+     */
+    template <base64_alphabet A>
+    class base64_blocks {
+    public:
+        /**
+         * @details Encodes as many whole 3 byte blocks of \p src as possible.
+         * @returns The amount of bytes consumed
+         */
+        static size_t encode(const std::byte* src, size_t len, char* dst);
+
+        /**
+         * @details Encodes the last \p len < 3 bytes of an input, padded to 4 characters if \p pad is set.
+         * @returns The amount of characters written
+         */
+        static size_t encode_tail(const std::byte* src, size_t len, char* dst, bool pad);
+
+        /**
+         * @details Decodes whole 4 character blocks of \p src up to the first block containing an invalid character
+         * or padding.
+         * @returns The amount of characters consumed
+         */
+        static size_t decode(const char* src, size_t len, std::byte* dst);
+
+        /**
+         * @details Decodes the last block of an input. A block of 4 characters may be padded, shorter blocks must
+         * not be.
+         * @returns The amount of bytes written
+         * @throws std::invalid_argument if the block is invalid
+         */
+        static size_t decode_tail(const char* src, size_t len, std::byte* dst);
+
+        /**
+         * @details Decodes \p src while skipping whitespace anywhere in it.
+         * @returns The amount of bytes written
+         * @throws std::invalid_argument if \p src is invalid under \p padding or \p dst is too small
+         */
+        static size_t decode_lenient(std::string_view src, std::span<std::byte> dst, base64_padding padding);
+
+        /**
+         * @details Encodes \p count inputs back to back, resolving the kernel once for the whole batch.
+         * @returns The amount of characters written
+         */
+        static size_t encode_batch(const std::string_view* inputs, size_t count, char* dst, bool pad);
+    };
+
+    /**
+     * @details Computes the exact amount of bytes \p base64 decodes to when whitespace is skipped. Does not
+     * validate the characters of \p base64.
+     * @throws std::invalid_argument if \p base64 can't be valid under \p padding because of its length
+     */
+    size_t base64_decoded_size_lenient(std::string_view base64, base64_padding padding = base64_padding::REQUIRED);
+
+    extern template class base64_blocks<base64_alphabet::STANDARD>;
+    extern template class base64_blocks<base64_alphabet::URL>;
+
+    /**
+     * @brief The encodings of a batch of inputs, stored back to back in one contiguous buffer
+     * @details The encoding of the i-th input spans the characters [offsets()[i], offsets()[i + 1]) of data().
+     */
+    class base64_batch {
+    public:
+        base64_batch() = default;
+
+        base64_batch(std::string data, std::vector<size_t> offsets)
+                : m_Data(std::move(data)), m_Offsets(std::move(offsets)) {}
+
+        /**
+         * @returns The amount of encodings in the batch
+         */
+        [[nodiscard]] size_t size() const {
+            return m_Offsets.size() - 1;
+        }
+
+        /**
+         * @returns The encoding of the input at \p index
+         */
+        [[nodiscard]] std::string_view operator[](size_t index) const {
+            return std::string_view{m_Data}.substr(m_Offsets[index], m_Offsets[index + 1] - m_Offsets[index]);
+        }
+
+        [[nodiscard]] const std::string& data() const {
+            return m_Data;
+        }
+
+        [[nodiscard]] std::span<const size_t> offsets() const {
+            return m_Offsets;
+        }
+
+    private:
+        std::string m_Data;
+        std::vector<size_t> m_Offsets{0};
+    };
+
+    /**
+     * @brief A base64 dialect fixed at compile-time
+     * @details The dialect is made up of an alphabet, a padding policy and the length of the lines the encoding is
+     * broken into with CRLF, 0 meaning no line breaks. All dialects share the SIMD kernels of base64_encode and
+     * base64_decode and don't allocate besides the overloads returning a std::string.
+     */
+    template <base64_alphabet A, base64_padding P = base64_padding::REQUIRED, size_t LineLength = 0>
+    class basic_base64 {
+        static_assert(LineLength % 4 == 0, "Line length must be a multiple of 4");
+
+        using blocks = base64_blocks<A>;
+
+        [[noreturn]] static constexpr void throw_invalid_encoding() {
+            throw std::invalid_argument{"Given string is not a valid base64 encoding"};
+        }
+
+        /**
+         * @brief Scalar counterpart of base64_blocks used during constant evaluation
+         */
+        struct constexpr_blocks {
+            static constexpr char encode_char(unsigned value) {
+                if (value < 26)
+                    return static_cast<char>('A' + value);
+                if (value < 52)
+                    return static_cast<char>('a' + value - 26);
+                if (value < 62)
+                    return static_cast<char>('0' + value - 52);
+                if (A == base64_alphabet::URL)
+                    return value == 62 ? '-' : '_';
+                return value == 62 ? '+' : '/';
+            }
+
+            static constexpr unsigned decode_char(char c) {
+                for (unsigned value = 0; value < 64; ++value) {
+                    if (encode_char(value) == c)
+                        return value;
+                }
+                throw_invalid_encoding();
+            }
+
+            static constexpr size_t encode(const char* src, size_t len, char* dst) {
+                const auto bytes_in_whole_blocks = len / 3 * 3;
+                for (size_t i = 0; i < bytes_in_whole_blocks; i += 3) {
+                    const auto block = static_cast<uint8_t>(src[i]) << 16 | static_cast<uint8_t>(src[i + 1]) << 8 |
+                                       static_cast<uint8_t>(src[i + 2]);
+                    for (int j = 0; j < 4; ++j)
+                        *dst++ = encode_char(block >> (18 - 6 * j) & 63);
+                }
+                return bytes_in_whole_blocks;
+            }
+
+            static constexpr size_t encode_tail(const char* src, size_t len, char* dst, bool pad) {
+                if (len == 0)
+                    return 0;
+                const auto block = static_cast<uint8_t>(src[0]) << 16 |
+                                   (len == 2 ? static_cast<uint8_t>(src[1]) << 8 : 0);
+                for (size_t j = 0; j <= len; ++j)
+                    dst[j] = encode_char(block >> (18 - 6 * j) & 63);
+                if (!pad)
+                    return len + 1;
+                for (size_t j = len + 1; j < 4; ++j)
+                    dst[j] = '=';
+                return 4;
+            }
+
+            static constexpr size_t decode(const char* src, size_t len, char* dst) {
+                const auto chars_in_whole_blocks = len / 4 * 4;
+                for (size_t i = 0; i < chars_in_whole_blocks; i += 4) {
+                    if (src[i + 3] == '=')
+                        return i;
+                    decode_tail(src + i, 4, dst);
+                    dst += 3;
+                }
+                return chars_in_whole_blocks;
+            }
+
+            static constexpr size_t decode_tail(const char* src, size_t len, char* dst) {
+                if (len == 0)
+                    return 0;
+                if (len == 4 && src[3] == '=')
+                    len -= src[2] == '=' ? 2 : 1;
+                if (len < 2)
+                    throw_invalid_encoding();
+                unsigned block = 0;
+                for (size_t j = 0; j < 4; ++j)
+                    block = block << 6 | (j < len ? decode_char(src[j]) : 0);
+                for (size_t j = 0; j + 1 < len; ++j)
+                    dst[j] = static_cast<char>(block >> (16 - 8 * j) & 0xff);
+                return len - 1;
+            }
+        };
+
+        template <typename Blocks, typename Byte>
+        static constexpr size_t encode_with(const Byte* src, size_t len, char* out) {
+            const char* const begin = out;
+            if constexpr (LineLength > 0) {
+                constexpr size_t line_bytes = LineLength / 4 * 3;
+                while (len > line_bytes) {
+                    out += Blocks::encode(src, line_bytes, out) / 3 * 4;
+                    *out++ = '\r';
+                    *out++ = '\n';
+                    src += line_bytes;
+                    len -= line_bytes;
+                }
+            }
+            const auto consumed = Blocks::encode(src, len, out);
+            out += consumed / 3 * 4;
+            out += Blocks::encode_tail(src + consumed, len - consumed, out, P == base64_padding::REQUIRED);
+            return static_cast<size_t>(out - begin);
+        }
+
+        template <typename Blocks, typename Byte>
+        static constexpr void decode_with(const char* src, size_t len, Byte* out) {
+            if constexpr (LineLength > 0) {
+                while (len > LineLength) {
+                    if (Blocks::decode(src, LineLength, out) != LineLength ||
+                        src[LineLength] != '\r' || src[LineLength + 1] != '\n')
+                        throw_invalid_encoding();
+                    out += LineLength / 4 * 3;
+                    src += LineLength + 2;
+                    len -= LineLength + 2;
+                }
+            }
+            if (len == 0)
+                return;
+            if (P == base64_padding::NONE && src[len - 1] == '=')
+                throw_invalid_encoding();
+
+            const size_t tail = len % 4 == 0 ? 4 : len % 4;
+            if (Blocks::decode(src, len - tail, out) != len - tail)
+                throw_invalid_encoding();
+            out += (len - tail) / 4 * 3;
+            Blocks::decode_tail(src + len - tail, tail, out);
+        }
+
+    public:
+        /**
+         * @returns The exact amount of characters in the encoding of \p n bytes, including line breaks
+         */
+        static constexpr size_t encoded_size(size_t n) {
+            const size_t chars = P == base64_padding::REQUIRED ? (n + 2) / 3 * 4 : (n * 4 + 2) / 3;
+            if constexpr (LineLength > 0) {
+                if (chars > 0)
+                    return chars + 2 * ((chars - 1) / LineLength);
+            }
+            return chars;
+        }
+
+        /**
+         * @details Computes the exact amount of bytes \p encoding decodes to. Validates the layout of padding and
+         * line breaks but not the characters.
+         * @throws std::invalid_argument if \p encoding can't be a valid encoding because of its length
+         */
+        static constexpr size_t decoded_size(std::string_view encoding) {
+            size_t chars = encoding.size();
+            if constexpr (LineLength > 0) {
+                const auto last_line = chars % (LineLength + 2);
+                if (chars > 0 && (last_line == 0 || last_line > LineLength))
+                    throw_invalid_encoding();
+                chars -= 2 * (chars / (LineLength + 2));
+            }
+            if (chars % 4 == 1 || (P == base64_padding::REQUIRED && chars % 4 != 0))
+                throw_invalid_encoding();
+
+            size_t padding = 0;
+            if (P != base64_padding::NONE && chars > 0 && chars % 4 == 0) {
+                padding = encoding.back() == '=' ? 1 : 0;
+                padding += padding && encoding[encoding.size() - 2] == '=' ? 1 : 0;
+            }
+            return chars / 4 * 3 + (chars % 4 ? chars % 4 - 1 : 0) - padding;
+        }
+
+        /**
+         * @details Encodes \p bytes into a caller provided buffer.
+         * @param dst The buffer to write to. Must hold at least encoded_size(bytes.size()) characters.
+         * @returns The amount of characters written
+         * @throws std::invalid_argument if \p dst is too small
+         */
+        static size_t encode(std::span<const std::byte> bytes, std::span<char> dst) {
+            if (dst.size() < encoded_size(bytes.size()))
+                throw std::invalid_argument{"Destination buffer is too small for the base64 encoding"};
+            return encode_with<blocks>(bytes.data(), bytes.size(), dst.data());
+        }
+
+        /**
+         * @copydoc encode(std::span<const std::byte>, std::span<char>)
+         * @details Can be evaluated at compile-time.
+         */
+        static constexpr size_t encode(std::string_view str, std::span<char> dst) {
+            if (!std::is_constant_evaluated())
+                return encode(std::as_bytes(std::span{str}), dst);
+            if (dst.size() < encoded_size(str.size()))
+                throw std::invalid_argument{"Destination buffer is too small for the base64 encoding"};
+            return encode_with<constexpr_blocks>(str.data(), str.size(), dst.data());
+        }
+
+        /**
+         * @returns A string containing the encoding of \p bytes
+         */
+        static std::string encode(std::span<const std::byte> bytes) {
+            std::string result(encoded_size(bytes.size()), '\0');
+            encode(bytes, std::span{result});
+            return result;
+        }
+
+        /**
+         * @returns A string containing the encoding of \p str
+         */
+        static std::string encode(std::string_view str) {
+            return encode(std::as_bytes(std::span{str}));
+        }
+
+        /**
+         * @details Decodes \p encoding into a caller provided buffer. Performs validity check on the encoding.
+         * @param dst The buffer to write to. Must hold at least decoded_size(encoding) bytes.
+         * @returns The amount of bytes written
+         * @throws std::invalid_argument if \p encoding is invalid or \p dst is too small
+         */
+        static size_t decode(std::string_view encoding, std::span<std::byte> dst) {
+            const auto size = decoded_size(encoding);
+            if (dst.size() < size)
+                throw std::invalid_argument{"Destination buffer is too small for the decoded base64"};
+            decode_with<blocks>(encoding.data(), encoding.size(), dst.data());
+            return size;
+        }
+
+        /**
+         * @copydoc decode(std::string_view, std::span<std::byte>)
+         * @details Can be evaluated at compile-time.
+         */
+        static constexpr size_t decode(std::string_view encoding, std::span<char> dst) {
+            if (!std::is_constant_evaluated())
+                return decode(encoding, std::as_writable_bytes(dst));
+            const auto size = decoded_size(encoding);
+            if (dst.size() < size)
+                throw std::invalid_argument{"Destination buffer is too small for the decoded base64"};
+            decode_with<constexpr_blocks>(encoding.data(), encoding.size(), dst.data());
+            return size;
+        }
+
+        /**
+         * @returns A string containing the bytes \p encoding decodes to
+         * @throws std::invalid_argument if \p encoding is invalid
+         */
+        static std::string decode(std::string_view encoding) {
+            std::string result(decoded_size(encoding), '\0');
+            decode(encoding, std::span{result});
+            return result;
+        }
+
+        /**
+         * @returns The total amount of characters in the encodings of \p inputs
+         */
+        static size_t batch_encoded_size(std::span<const std::string_view> inputs) {
+            size_t size = 0;
+            for (const auto input : inputs)
+                size += encoded_size(input.size());
+            return size;
+        }
+
+        /**
+         * @details Encodes many, typically small inputs back to back into one caller provided buffer without
+         * allocating. The kernel is resolved once for the whole batch instead of once per input.
+         * @param inputs The inputs to encode
+         * @param dst The buffer to write to. Must hold at least batch_encoded_size(inputs) characters.
+         * @param offsets Receives the offset of each encoding in \p dst followed by the total size. Must hold at least
+         * inputs.size() + 1 elements.
+         * @returns The amount of characters written
+         * @throws std::invalid_argument if \p dst or \p offsets is too small
+         */
+        static size_t encode_batch(std::span<const std::string_view> inputs, std::span<char> dst,
+                                   std::span<size_t> offsets) {
+            if (offsets.size() < inputs.size() + 1)
+                throw std::invalid_argument{"Offset buffer is too small for the batch"};
+            offsets[0] = 0;
+            for (size_t i = 0; i < inputs.size(); ++i)
+                offsets[i + 1] = offsets[i] + encoded_size(inputs[i].size());
+            if (dst.size() < offsets[inputs.size()])
+                throw std::invalid_argument{"Destination buffer is too small for the base64 encoding"};
+
+            if constexpr (LineLength == 0) {
+                return blocks::encode_batch(inputs.data(), inputs.size(), dst.data(), P == base64_padding::REQUIRED);
+            } else {
+                for (size_t i = 0; i < inputs.size(); ++i)
+                    encode_with<blocks>(reinterpret_cast<const std::byte*>(inputs[i].data()), inputs[i].size(),
+                                        dst.data() + offsets[i]);
+                return offsets[inputs.size()];
+            }
+        }
+
+        /**
+         * @details Encodes many, typically small inputs into one contiguous buffer. Allocates the buffer and the
+         * offsets once instead of a string per input.
+         * @returns The encodings of \p inputs
+         */
+        static base64_batch encode_batch(std::span<const std::string_view> inputs) {
+            std::string data(batch_encoded_size(inputs), '\0');
+            std::vector<size_t> offsets(inputs.size() + 1);
+            encode_batch(inputs, std::span{data}, std::span{offsets});
+            return {std::move(data), std::move(offsets)};
+        }
+
+        /**
+         * @details Encodes \p bytes, at compile-time if used in a constant expression.
+         * @returns An array containing the encoding of \p bytes
+         */
+        template <size_t N>
+        static constexpr auto encode(const std::array<char, N>& bytes) {
+            std::array<char, encoded_size(N)> result{};
+            encode(std::string_view{bytes.data(), N}, std::span{result});
+            return result;
+        }
+
+        /**
+         * @returns An array containing the encoding of the string literal \p S, computed at compile-time
+         */
+        template <fixed_string S>
+        static consteval auto encode() {
+            return encode(S.array());
+        }
+
+        /**
+         * @details Decodes the string literal \p S at compile-time, e.g. to embed assets without decoding them at
+         * startup. An invalid encoding fails to compile.
+         * @returns An array containing the bytes \p S decodes to
+         */
+        template <fixed_string S>
+        static consteval auto decode() {
+            std::array<char, decoded_size(S.view())> result{};
+            decode(S.view(), std::span{result});
+            return result;
+        }
+
+        /**
+         * @returns The exact amount of bytes \p encoding decodes to when whitespace is skipped
+         * @throws std::invalid_argument if \p encoding can't be a valid encoding because of its length
+         */
+        static size_t decoded_size_lenient(std::string_view encoding) {
+            return base64_decoded_size_lenient(encoding, P);
+        }
+
+        /**
+         * @details Decodes \p encoding like decode, but skips spaces, tabs and line breaks anywhere in it instead of
+         * requiring the line layout of the dialect. Runs of characters between whitespace are decoded in place by
+         * the SIMD kernels, the input is never copied.
+         * @param dst The buffer to write to. Must hold at least decoded_size_lenient(encoding) bytes.
+         * @returns The amount of bytes written
+         * @throws std::invalid_argument if \p encoding is invalid or \p dst is too small
+         */
+        static size_t decode_lenient(std::string_view encoding, std::span<std::byte> dst) {
+            return blocks::decode_lenient(encoding, dst, P);
+        }
+
+        /**
+         * @copydoc decode_lenient(std::string_view, std::span<std::byte>)
+         */
+        static size_t decode_lenient(std::string_view encoding, std::span<char> dst) {
+            return decode_lenient(encoding, std::as_writable_bytes(dst));
+        }
+
+        /**
+         * @returns A string containing the bytes \p encoding decodes to when whitespace is skipped
+         * @throws std::invalid_argument if \p encoding is invalid
+         */
+        static std::string decode_lenient(std::string_view encoding) {
+            std::string result(decoded_size_lenient(encoding), '\0');
+            decode_lenient(encoding, std::span{result});
+            return result;
+        }
+    };
+
+    /**
+     * @brief The standard base64 of RFC 4648, section 4. Used by base64_encode and base64_decode.
+     */
+    using base64 = basic_base64<base64_alphabet::STANDARD>;
+
+    /**
+     * @brief The URL and filename safe base64 of RFC 4648, section 5, without padding
+     */
+    using base64url = basic_base64<base64_alphabet::URL, base64_padding::NONE>;
+
+    /**
+     * @brief The MIME base64 of RFC 2045, broken into lines of 76 characters
+     */
+    using base64_mime = basic_base64<base64_alphabet::STANDARD, base64_padding::REQUIRED, 76>;
+
+    /**
+     * @brief The base64 of PEM files (RFC 7468), broken into lines of 64 characters
+     */
+    using base64_pem = basic_base64<base64_alphabet::STANDARD, base64_padding::REQUIRED, 64>;
+
+    /**
+     * @returns An array containing the standard base64 encoding of the string literal \p S, computed at
+     * compile-time
+     */
+    template <fixed_string S>
+    consteval auto base64_encode() {
+        return base64::encode<S>();
+    }
+
+    /**
+     * @details Decodes the standard base64 string literal \p S at compile-time. An invalid encoding fails to compile.
+     * @returns An array containing the bytes \p S decodes to
+     */
+    template <fixed_string S>
+    consteval auto base64_decode() {
+        return base64::decode<S>();
+    }
+
+    /**
+     * @brief A base64_encoder encodes data that arrives in chunks of arbitrary size with a fixed amount of memory
+     * @details Bytes that don't fill a whole 3 byte block are carried over to the next call of update. The encoding
+     * is passed to the sink in pieces of at most a few kilobytes, so neither the whole input nor the whole output
+     * ever has to be in memory.
+     */
+    class base64_encoder {
+    public:
+        /**
+         * @brief A callable receiving consecutive pieces of the output. The data is only valid during the call.
+         */
+        using sink = std::function<void(std::string_view)>;
+
+        /**
+         * @param out The sink receiving the encoding
+         */
+        explicit base64_encoder(sink out);
+
+        /**
+         * @details Encodes the next chunk of the input.
+         * @param chunk The bytes to encode
+         */
+        void update(std::string_view chunk);
+
+        /**
+         * @details Encodes the bytes carried over from the last chunk including padding. The encoder can be reused for
+         * a new input afterwards.
+         */
+        void finish();
+
+    private:
+        sink m_Sink;
+        std::array<char, 4096> m_Buffer{};
+        std::byte m_Carry[3]{};
+        size_t m_CarryLen{0};
+    };
+
+    /**
+     * @brief A base64_decoder decodes base64 that arrives in chunks of arbitrary size with a fixed amount of memory
+     * @details Characters that don't fill a whole 4 character block are carried over to the next call of update.
+     * Like base64_decode, it throws std::invalid_argument as soon as it sees invalid input.
+     */
+    class base64_decoder {
+    public:
+        /**
+         * @brief A callable receiving consecutive pieces of the output. The data is only valid during the call.
+         */
+        using sink = std::function<void(std::string_view)>;
+
+        /**
+         * @param out The sink receiving the decoded bytes
+         */
+        explicit base64_decoder(sink out);
+
+        /**
+         * @details Decodes the next chunk of the input.
+         * @param chunk The base64 characters to decode
+         */
+        void update(std::string_view chunk);
+
+        /**
+         * @details Checks that the input ended on a whole block. The decoder can be reused for a new input afterwards.
+         */
+        void finish();
+
+    private:
+        sink m_Sink;
+        std::array<char, 3072> m_Buffer{};
+        char m_Carry[4]{};
+        size_t m_CarryLen{0};
+        bool m_Finished{false};
+    };
+
+    /**
+     * @brief An output iterator accepting chars that is not a raw pointer. Pointers and arrays should use the
+     * bounds-checked std::span overloads instead.
+     */
+    template <typename T>
+    concept char_output_iterator = std::output_iterator<T, char> && !std::is_pointer_v<T>;
+
+    /**
+     * @details Encodes \p str and writes the encoding to \p out, e.g. a std::back_insert_iterator or an
+     * std::ostreambuf_iterator. Works in pieces of a few kilobytes and doesn't allocate.
+     * @param str The bytes to encode
+     * @param out The iterator to write to
+     * @returns The iterator one past the last character written
+     */
+    template <char_output_iterator O>
+    O base64_encode(std::string_view str, O out) {
+        base64_encoder encoder{[&out](std::string_view piece) { out = std::copy(piece.begin(), piece.end(), out); }};
+        encoder.update(str);
+        encoder.finish();
+        return out;
+    }
+
+    /**
+     * @details Decodes \p input and writes the decoded bytes to \p out. Works in pieces of a few kilobytes and
+     * doesn't allocate. If \p input is invalid, std::invalid_argument is thrown, possibly after some bytes have
+     * already been written.
+     * @param input The base64 string to decode
+     * @param out The iterator to write to
+     * @returns The iterator one past the last byte written
+     */
+    template <char_output_iterator O>
+    O base64_decode(std::string_view input, O out) {
+        base64_decoder decoder{[&out](std::string_view piece) { out = std::copy(piece.begin(), piece.end(), out); }};
+        decoder.update(input);
+        decoder.finish();
+        return out;
+    }
 
 }
 
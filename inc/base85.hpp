@@ -0,0 +1,82 @@
+//
+// Created by konstantin on 17.10.26.
+//
+
+#ifndef PINEPP_BASE85_HPP
+#define PINEPP_BASE85_HPP
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace pinepp {
+
+    /**
+     * @returns The amount of characters in the Ascii85 encoding of \p n bytes if no group is shortened to 'z'.
+     * The actual encoding may be shorter.
+     */
+    constexpr size_t base85_max_encoded_size(size_t n) {
+        return n / 4 * 5 + (n % 4 == 0 ? 0 : n % 4 + 1);
+    }
+
+    /**
+     * @details Computes the exact amount of bytes \p base85 decodes to, taking 'z' groups and whitespace into
+     * account. Does not validate the characters of \p base85.
+     * @throws std::invalid_argument if \p base85 can't be a valid encoding because of its length
+     */
+    size_t base85_decoded_size(std::string_view base85);
+
+    /**
+     * @details Converts an ASCII string (std::string) to Ascii85 as used by PostScript and PDF, without the <~ ~>
+     * delimiters. Every group of 4 bytes becomes 5 characters from '!' to 'u', all zero groups become 'z'.
+     * @param str The string to encode
+     * @returns A string containing the Ascii85 representation of \p str
+     */
+    std::string base85_encode(std::string_view str);
+
+    /**
+     * @details Converts a sequence of bytes to Ascii85.
+     * @param bytes The bytes to encode
+     * @returns A string containing the Ascii85 representation of \p bytes
+     */
+    std::string base85_encode(std::span<const std::byte> bytes);
+
+    /**
+     * @details Encodes \p bytes into a caller provided buffer without allocating.
+     * @param bytes The bytes to encode
+     * @param dst The buffer to write to. Must hold at least base85_max_encoded_size(bytes.size()) characters.
+     * @returns The amount of characters written
+     * @throws std::invalid_argument if \p dst is too small
+     */
+    size_t base85_encode(std::span<const std::byte> bytes, std::span<char> dst);
+
+    /**
+     * @copydoc base85_encode(std::span<const std::byte>, std::span<char>)
+     */
+    size_t base85_encode(std::string_view str, std::span<char> dst);
+
+    /**
+     * @details Converts an Ascii85 encoding to an ASCII string (std::string). Whitespace is skipped, everything
+     * else is validated.
+     * @param input The Ascii85 string to decode
+     * @returns An ASCII string
+     */
+    std::string base85_decode(std::string_view input);
+
+    /**
+     * @details Decodes \p input into a caller provided buffer without allocating.
+     * @param input The Ascii85 string to decode
+     * @param dst The buffer to write to. Must hold at least base85_decoded_size(input) bytes.
+     * @returns The amount of bytes written
+     * @throws std::invalid_argument if \p input is invalid or \p dst is too small
+     */
+    size_t base85_decode(std::string_view input, std::span<std::byte> dst);
+
+    /**
+     * @copydoc base85_decode(std::string_view, std::span<std::byte>)
+     */
+    size_t base85_decode(std::string_view input, std::span<char> dst);
+
+}
+
+#endif //PINEPP_BASE85_HPP
@@ -4,10 +4,85 @@
 
 #ifndef PINEPP_BIT_PATTERN_HPP
 #define PINEPP_BIT_PATTERN_HPP
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <concepts>
 #include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
 #include <ostream>
-#include <vector>
+#include <string>
+#include <type_traits>
 namespace pinepp {
+    /**
+     * @brief Enum class representing the instruction sets the bitwise operators of bit_pattern can be executed with
+     */
+    enum class bit_pattern_kernel : uint8_t { SCALAR, AVX2, AVX512 };
+
+    /**
+     * @returns The kernel currently used by the bitwise operators of bit_pattern. Unless changed by
+     * bit_pattern_select_kernel, this is the widest kernel supported by the CPU, as reported by CPUID on first use.
+     */
+    bit_pattern_kernel bit_pattern_active_kernel();
+
+    /**
+     * @details Forces the bitwise operators of bit_pattern to use a specific kernel. This is mostly useful for
+     * benchmarking and testing. Not thread-safe with respect to concurrent bitwise operations.
+     * @param kernel The kernel to use
+     * @returns False if the CPU doesn't support \p kernel, in which case the active kernel doesn't change
+     */
+    bool bit_pattern_select_kernel(bit_pattern_kernel kernel);
+
+    /**
+     * @brief The word level kernels behind the bitwise operators of bit_pattern, dispatched to the kernel selected
+     * by bit_pattern_select_kernel
+     * @details Every kernel combines \p n words of \p a and \p b into \p dst, which may alias either of them. Use the
+     * operators of bit_pattern instead of calling these directly.
+     */
+    struct bit_and_words {
+        static void apply(uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t n);
+    };
+
+    struct bit_or_words {
+        static void apply(uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t n);
+    };
+
+    struct bit_xor_words {
+        static void apply(uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t n);
+    };
+
+    struct bit_not_words {
+        static void apply(uint64_t* dst, const uint64_t* a, size_t n);
+    };
+
+    /**
+     * @brief Counts the bits set to 1 in \p n words of \p a with the selected kernel, like bit_pattern::count
+     */
+    struct bit_count_words {
+        static size_t apply(const uint64_t* a, size_t n);
+    };
+
+    /**
+     * @brief The amount of words a bitwise expression is evaluated in at once. Small enough for the intermediate
+     * results of a node to stay in the L1 cache.
+     */
+    constexpr size_t BIT_EXPRESSION_BLOCK = 256;
+
+    template <typename Derived>
+    class bit_expression_base;
+
+    /**
+     * @brief Satisfied by the nodes of a lazy bitwise expression over bit_patterns
+     */
+    template <typename T>
+    concept bit_expression = std::derived_from<std::remove_cvref_t<T>, bit_expression_base<std::remove_cvref_t<T>>>;
+
+    template <typename Pattern>
+    class bit_operand;
+
     /**
      * @brief A bit_pattern is an array of ones and zeroes that you can do bit-wise operations on
      */
@@ -27,12 +102,19 @@ namespace pinepp {
          */
         explicit bit_pattern(const std::string& str);
 
+        /**
+         * @details Constructs a pattern of \p n bits that all have the value \p value.
+         * @param n The amount of bits in the pattern
+         * @param value The value of every bit
+         */
+        explicit bit_pattern(size_t n, bool value = false);
+
         /**
          * @details
          * Copy constructor for the bit_pattern class.
          * @param other The bit_pattern to copy
          */
-        bit_pattern(const bit_pattern& other) = default;
+        bit_pattern(const bit_pattern& other);
 
         /**
          * @details
@@ -41,25 +123,178 @@ namespace pinepp {
          */
         bit_pattern(bit_pattern&& other) noexcept;
 
+        /**
+         * @details Evaluates a bitwise expression like (a & b) | ~c in a single pass over the words of its operands.
+         * Implicit, so expressions can be used wherever a bit_pattern is expected.
+         * @param expression The expression to evaluate
+         */
+        template <bit_expression E>
+        bit_pattern(const E& expression) { // NOLINT(google-explicit-constructor)
+            assign(expression);
+        }
+
+        /**
+         * @brief Returned by the find functions if there is no matching bit
+         */
+        static constexpr size_t npos = static_cast<size_t>(-1);
+
         /**
          * @returns The amount of bits in the pattern. This does not correspond to amount of memory used.
          */
         [[nodiscard]] size_t size() const;
 
+        /**
+         * @returns The amount of bits set to 1, counted with POPCNT on whole words where the CPU supports it
+         */
+        [[nodiscard]] size_t count() const noexcept;
+
+        /**
+         * @returns True if at least one bit is set to 1
+         */
+        [[nodiscard]] bool any() const noexcept;
+
+        /**
+         * @returns True if no bit is set to 1. This is the case for an empty pattern as well.
+         */
+        [[nodiscard]] bool none() const noexcept;
+
+        /**
+         * @returns True if every bit is set to 1. This is the case for an empty pattern as well.
+         */
+        [[nodiscard]] bool all() const noexcept;
+
+        /**
+         * @returns The index of the least significant bit set to 1 or npos if there is none
+         */
+        [[nodiscard]] size_t find_first() const noexcept;
+
+        /**
+         * @returns The index of the first bit set to 1 that is more significant than \p index or npos if there is
+         * none
+         */
+        [[nodiscard]] size_t find_next(size_t index) const noexcept;
+
+        /**
+         * @returns The index of the most significant bit set to 1 or npos if there is none
+         */
+        [[nodiscard]] size_t find_last() const noexcept;
+
+        /**
+         * @returns The amount of consecutive 0 bits, starting at the most significant bit. Like std::countl_zero,
+         * this is the size of the pattern if no bit is set.
+         */
+        [[nodiscard]] size_t countl_zero() const noexcept;
+
+        /**
+         * @returns The amount of consecutive 0 bits, starting at the least significant bit. Like
+         * std::countr_zero, this is the size of the pattern if no bit is set.
+         */
+        [[nodiscard]] size_t countr_zero() const noexcept;
+
+        /**
+         * @details Counts the bits set to 1 below \p index in constant time. The first call builds a rank/select
+         * directory with about 3.5% space overhead, which is kept until the pattern changes. Like every const member
+         * function, this can be called from several threads at once; threads racing on the first call may each
+         * build the directory, but all of them use the one published first.
+         * @returns The amount of bits set to 1 at positions less than \p index or count() if \p index is at least
+         * size()
+         */
+        [[nodiscard]] size_t rank1(size_t index) const;
+
+        /**
+         * @details Finds the k-th bit set to 1, counting from 0, in constant time. Shares the directory of rank1,
+         * so rank1(select1(k)) == k.
+         * @returns The index of the k-th bit set to 1 or npos if less than \p k + 1 bits are set
+         */
+        [[nodiscard]] size_t select1(size_t k) const;
+
         /**
          * @details
-         * Sets the bit at position \p m_Index to 1 if \p value is true or 0 otherwise.
+         * Sets the bit at position \p index to 1 if \p value is true or 0 otherwise.
          * @param index Position of the bit to modify
          * @param value Value of the bit to modify
+         * @throws std::out_of_range if \p index is not less than size()
          */
-        void set_bit(int index, bool value);
+        void set_bit(size_t index, bool value);
 
         /**
-         * @details Reverses the bit pattern.
+         * @details Reverses the bit pattern in place, whole words at a time with the active kernel.
          */
         void reverse();
 
+        /**
+         * @details Appends a bit on the most significant side, so it becomes the bit at index size() - 1. The words
+         * grow geometrically, so building a pattern bit by bit takes amortized constant time per bit.
+         * @param value Value of the new bit
+         */
+        bit_pattern& push_back(bool value);
+
+        /**
+         * @details Appends the \p n least significant bits of \p bits on the most significant side, the least
+         * significant of them becoming the bit at the old size().
+         * @param bits The bits to append. Bits above the lowest \p n are ignored.
+         * @param n The amount of bits to append
+         * @throws std::invalid_argument if \p n is greater than 64
+         */
+        bit_pattern& append(uint64_t bits, size_t n);
+
     private:
+        /**
+         * @details Owns the 64 bit words of a pattern. Patterns of up to INLINE_WORDS words are stored in the object
+         * itself, larger ones on the heap, aligned to 64 bytes, the size of an AVX-512 register. Unlike std::vector
+         * the buffer can be sized without zeroing words that are about to be overwritten anyway.
+         */
+        class word_buffer {
+        public:
+            word_buffer() = default;
+            word_buffer(const word_buffer& other);
+            word_buffer(word_buffer&& other) noexcept;
+            word_buffer& operator=(const word_buffer& other);
+            word_buffer& operator=(word_buffer&& other) noexcept;
+            ~word_buffer();
+
+            [[nodiscard]] size_t size() const noexcept { return m_Size; }
+            [[nodiscard]] uint64_t* data() noexcept { return mp_Data; }
+            [[nodiscard]] const uint64_t* data() const noexcept { return mp_Data; }
+            uint64_t& operator[](size_t i) noexcept { return mp_Data[i]; }
+            const uint64_t& operator[](size_t i) const noexcept { return mp_Data[i]; }
+
+            /**
+             * @details Resizes the buffer to \p n words. Existing words are kept, new words are 0.
+             */
+            void resize(size_t n);
+
+            /**
+             * @details Resizes the buffer to \p n words with unspecified values, for callers that overwrite all
+             * of them.
+             */
+            void resize_for_overwrite(size_t n);
+
+            /**
+             * @details Makes room for \p n words, at least doubling the capacity if it has to grow.
+             */
+            void reserve(size_t n);
+
+            void clear() noexcept { m_Size = 0; }
+        private:
+            /**
+             * @brief The amount of words stored without allocating, enough for patterns of up to 128 bits
+             */
+            static constexpr size_t INLINE_WORDS = 2;
+
+            [[nodiscard]] bool is_inline() const noexcept { return mp_Data == m_Inline; }
+            /**
+             * @details Takes over the words of \p other, which is left empty and inline. Requires the buffer to be
+             * empty and inline.
+             */
+            void steal(word_buffer& other) noexcept;
+
+            uint64_t* mp_Data = m_Inline;
+            size_t m_Size = 0;
+            size_t m_Capacity = INLINE_WORDS;
+            uint64_t m_Inline[INLINE_WORDS];
+        };
+
         /**
          * @details The bit_pattern::iterator class is a non-standard type of iterator that returns integers that
          * represent a bit in a given location. The iterator cannot be used to modify the pattern.
@@ -76,6 +311,138 @@ namespace pinepp {
             size_t m_Index = 0;
         };
     public:
+        /**
+         * @brief A writable proxy for a single bit, returned by the non-const operator[]
+         * @details Like std::vector<bool>::reference, it converts to bool and can be assigned a bool or another
+         * reference. Does not check bounds.
+         */
+        class reference {
+        public:
+            reference(const reference& other) = default;
+
+            reference& operator=(bool value) noexcept {
+                mp_BitPattern->mp_RankIndex.reset();
+                auto& word = mp_BitPattern->m_Words[m_Index / 64];
+                const auto mask = uint64_t{1} << (m_Index % 64);
+                word = value ? word | mask : word & ~mask;
+                return *this;
+            }
+
+            /**
+             * @details Assigns the value of the bit \p other refers to, not the reference itself
+             */
+            reference& operator=(const reference& other) noexcept {
+                return *this = static_cast<bool>(other);
+            }
+
+            operator bool() const noexcept {
+                return mp_BitPattern->m_Words[m_Index / 64] >> (m_Index % 64) & 1;
+            }
+
+            bool operator~() const noexcept {
+                return !static_cast<bool>(*this);
+            }
+
+            reference& flip() noexcept {
+                return *this = !static_cast<bool>(*this);
+            }
+
+            /**
+             * @brief Swaps the values of two bits, which may belong to different patterns
+             */
+            friend void swap(reference a, reference b) noexcept {
+                const bool value = a;
+                a = static_cast<bool>(b);
+                b = value;
+            }
+        private:
+            friend class bit_pattern;
+            reference(bit_pattern* pattern, size_t index) noexcept : mp_BitPattern(pattern), m_Index(index) {}
+
+            bit_pattern* mp_BitPattern;
+            size_t m_Index;
+        };
+
+        /**
+         * @brief A forward iterator over the indices of the bits set to 1, in ascending order
+         * @details Words of zeros are skipped as a whole and the next set bit of a word is found with a single
+         * TZCNT, so iterating costs time proportional to the amount of set bits rather than to the size. Changing
+         * the size of the pattern invalidates the iterator.
+         */
+        class set_bit_iterator {
+        public:
+            using iterator_concept = std::forward_iterator_tag;
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = size_t;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = size_t;
+
+            set_bit_iterator() = default;
+
+            /**
+             * @details Points at the first set bit in or after the word at \p index of the \p count \p words
+             */
+            explicit set_bit_iterator(const uint64_t* words, size_t count, size_t index) noexcept
+                    : mp_Words(words), m_Count(count), m_WordIndex(index), m_Word(index < count ? words[index] : 0) {
+                skip_zero_words();
+            }
+
+            size_t operator*() const noexcept {
+                return m_WordIndex * 64 + static_cast<size_t>(std::countr_zero(m_Word));
+            }
+
+            set_bit_iterator& operator++() noexcept {
+                // CLEARS THE LOWEST SET BIT
+                m_Word &= m_Word - 1;
+                skip_zero_words();
+                return *this;
+            }
+
+            set_bit_iterator operator++(int) noexcept {
+                auto rv = *this;
+                ++*this;
+                return rv;
+            }
+
+            bool operator==(const set_bit_iterator& other) const noexcept = default;
+        private:
+            void skip_zero_words() noexcept {
+                while (m_Word == 0 && m_WordIndex < m_Count) {
+                    if (++m_WordIndex == m_Count)
+                        return;
+                    m_Word = mp_Words[m_WordIndex];
+                }
+            }
+
+            const uint64_t* mp_Words = nullptr;
+            size_t m_Count = 0;
+            size_t m_WordIndex = 0;
+            /**
+             * @brief The bits of the current word that haven't been visited yet
+             */
+            uint64_t m_Word = 0;
+        };
+
+        /**
+         * @brief The range of the indices of the bits set to 1, returned by set_bits()
+         */
+        class set_bit_range {
+        public:
+            explicit set_bit_range(const uint64_t* words, size_t count) noexcept : mp_Words(words), m_Count(count) {}
+
+            [[nodiscard]] set_bit_iterator begin() const noexcept {
+                return set_bit_iterator{mp_Words, m_Count, 0};
+            }
+
+            [[nodiscard]] set_bit_iterator end() const noexcept {
+                return set_bit_iterator{mp_Words, m_Count, m_Count};
+            }
+        private:
+            const uint64_t* mp_Words;
+            size_t m_Count;
+        };
+
         /**
          * @returns An iterator on the first element. This is the least significant bit. If constructed from a string
          * this corresponds to the right most character.
@@ -87,45 +454,106 @@ namespace pinepp {
          */
         [[nodiscard]] iterator end() const;
 
+        /**
+         * @returns The indices of the bits set to 1 in ascending order, e.g. for (size_t i : bp.set_bits())
+         */
+        [[nodiscard]] set_bit_range set_bits() const noexcept;
+
         /**
          * @details Allows read-only access to bits at a certain position.
          * @returns An integer that is either 0 or 1. This integer is a representation of the bit in the array
          * and does not have the same address.
          */
-        int operator[](unsigned int) const;
+        int operator[](size_t index) const;
+
+        /**
+         * @details Allows writing to bits at a certain position, e.g. bp[3] = true. Like the read-only version, it
+         * does not check bounds.
+         * @returns A proxy for the bit at \p index
+         */
+        reference operator[](size_t index);
+
+        /**
+         * @details ANDs \p other into the pattern in place. Like a = a & other, the pattern is cut to the length of
+         * the shorter pattern.
+         */
+        bit_pattern& operator&=(const bit_pattern& other);
+
+        /**
+         * @details ORs \p other into the pattern in place, cutting it to the length of the shorter pattern.
+         */
+        bit_pattern& operator|=(const bit_pattern& other);
 
         /**
-         * @returns The result of an AND operation on both patterns with the length of the shorter pattern
+         * @details XORs \p other into the pattern in place, cutting it to the length of the shorter pattern.
          */
-        bit_pattern operator&(const bit_pattern& other) const;
+        bit_pattern& operator^=(const bit_pattern& other);
 
         /**
-         * @returns The result of an OR operation on both patterns with the length of the shorter pattern
+         * @details Combines the pattern with \p expression in a single pass, without evaluating \p expression first.
          */
-        bit_pattern operator|(const bit_pattern& other) const;
+        template <bit_expression E>
+        bit_pattern& operator&=(const E& expression) {
+            return *this = *this & expression;
+        }
 
         /**
-         * @returns The result of an XOR operation on both patterns with the length of the shorter pattern
+         * @copydoc operator&=(const E&)
          */
-        bit_pattern operator^(const bit_pattern& other) const;
+        template <bit_expression E>
+        bit_pattern& operator|=(const E& expression) {
+            return *this = *this | expression;
+        }
 
         /**
-         * @returns The result of a NOT operation on the pattern
+         * @copydoc operator&=(const E&)
          */
-        bit_pattern operator~() const;
+        template <bit_expression E>
+        bit_pattern& operator^=(const E& expression) {
+            return *this = *this ^ expression;
+        }
 
         /**
-         * @returns Shifts the pattern left \p n bits. Copies the overflowing bits to the other side.
+         * @details Inverts every bit of the pattern in place.
+         */
+        bit_pattern& flip();
+
+        /**
+         * @returns The pattern shifted left \p n bits, towards the most significant bit. Bits shifted out are lost,
+         * zeros are shifted in on the right. Use rotl to keep the overflowing bits instead.
          */
         bit_pattern operator<<(uint64_t n) const;
 
         /**
-         * @returns Shifts the pattern right \p n bits. Copies the overflowing bits to the other side.
+         * @returns The pattern shifted right \p n bits, towards the least significant bit. Bits shifted out are
+         * lost, zeros are shifted in on the left. Use rotr to keep the overflowing bits instead.
          */
         bit_pattern operator>>(uint64_t n) const;
 
         /**
-         * @returns Concatenates two patterns
+         * @details Shifts the pattern left \p n bits in place, like operator<<.
+         */
+        bit_pattern& operator<<=(uint64_t n);
+
+        /**
+         * @details Shifts the pattern right \p n bits in place, like operator>>.
+         */
+        bit_pattern& operator>>=(uint64_t n);
+
+        /**
+         * @details Rotates the pattern left \p n bits in place. The bits shifted out on the left are shifted back
+         * in on the right.
+         */
+        bit_pattern& rotate_left(uint64_t n);
+
+        /**
+         * @details Rotates the pattern right \p n bits in place. The bits shifted out on the right are shifted back
+         * in on the left.
+         */
+        bit_pattern& rotate_right(uint64_t n);
+
+        /**
+         * @returns Concatenates two patterns, \p other becoming the least significant part like in str() + other.str()
          */
         bit_pattern operator+(const bit_pattern& other) const;
 
@@ -147,16 +575,26 @@ namespace pinepp {
          */
         bit_pattern& operator=(bit_pattern&& other) noexcept;
 
+        /**
+         * @details Evaluates \p expression into the pattern, reusing its words. The pattern may be an operand of
+         * \p expression.
+         */
+        template <bit_expression E>
+        bit_pattern& operator=(const E& expression) {
+            assign(expression);
+            return *this;
+        }
+
         /**
          * @details Resizes the bit pattern. if \p n doesn't equal the current size, bits get either cut off or
-         * padding bits with value 0 get inserted.
+         * padding bits with value 0 get inserted. Works on the words in place.
          * @param n The new size of the bit pattern.
          */
         bit_pattern& resize(size_t n);
 
         /**
          * @details Checks if two bit_patterns contain the same pattern. Does not check if they are actually
-         * the same object.
+         * the same object. Compares whole words.
          */
         bool operator==(const bit_pattern& other) const noexcept;
 
@@ -165,33 +603,302 @@ namespace pinepp {
          */
         bool operator!=(const bit_pattern &other) const noexcept;
 
+        /**
+         * @details Orders patterns by their size first. Patterns of the same size are ordered like their str(), that
+         * is as unsigned numbers, compared a word at a time from the most significant word down.
+         */
+        std::strong_ordering operator<=>(const bit_pattern& other) const noexcept;
+
+        /**
+         * @returns A hash of the size and the words of the pattern, mixed wyhash-style with one 128 bit
+         * multiplication per two words. Used by std::hash<pinepp::bit_pattern>.
+         */
+        [[nodiscard]] size_t hash() const noexcept;
+
         /**
          * @returns A string representing the bit pattern
          */
         [[nodiscard]] std::string str() const;
+
+        /**
+         * @returns The pattern as a hexadecimal number with a 0x prefix and lower case digits, or an empty string
+         * for an empty pattern. The most significant digit is padded with 0 bits if the size isn't a multiple of 4,
+         * so only those patterns survive a round trip through the string constructor unchanged.
+         */
+        [[nodiscard]] std::string hex_str() const;
     private:
         /**
-         * @brief The bytes that contain the bit pattern
+         * @brief The 64 bit words that contain the bit pattern, least significant bit first. Bits past m_Len are
+         * always 0, so whole words can be compared, counted and combined without masking.
          */
-        std::vector<uint8_t> m_RawBytes{};
+        word_buffer m_Words{};
         /**
-         * @brief The amount of bits in the pattern. This is relevant to know because the pattern is saved in bytes.
+         * @brief The amount of bits in the pattern. This is relevant to know because the last word may only be
+         * partly used.
          */
         std::size_t m_Len{0};
+        /**
+         * @brief The lazily built rank/select directory. Immutable once built, so copies of a pattern can share it.
+         * Const member functions only access it with std::atomic_load and std::atomic_compare_exchange_strong, since
+         * they may run concurrently. Reset by everything that modifies the pattern.
+         */
+        struct rank_index;
+        mutable std::shared_ptr<const rank_index> mp_RankIndex{};
+        /**
+         * @returns The directory of the current pattern, building it if necessary
+         */
+        const rank_index& rank_directory() const;
         /**
          * @brief Writes the pattern to an ostream. The string will be in the same order as the string that you
-         * constructed it from, meaning the least significant bit will be on the right.
+         * constructed it from, meaning the least significant bit will be on the right. With std::hex the pattern is
+         * written like hex_str, with the 0x prefix only if std::showbase is set.
          * @param os The ostream to write to
          * @param pattern The pattern to write
          * @return \p os
          */
         friend std::ostream& operator<<(std::ostream& os, const bit_pattern& pattern);
+        friend bit_pattern rotl(const bit_pattern& pattern, uint64_t n);
+        friend bit_pattern rotr(const bit_pattern& pattern, uint64_t n);
+        friend class compressed_bit_pattern;
+        friend class atomic_bit_pattern;
+        template <typename Pattern>
+        friend class bit_operand;
+        template <size_t N>
+        friend class fixed_bit_pattern;
+        template <typename Word>
+        friend class basic_bit_span;
         /**
          * @brief Internal helper function used by constructors and assignment operators to create a bit_pattern
          * from a string.
          */
         void from_string(const std::string& str);
+        /**
+         * @brief Clears the bits of the last word that lie past m_Len
+         */
+        void clear_unused_bits();
+        /**
+         * @brief Appends the \p n bits of \p words, whose bits past \p n must be 0, on the most significant side
+         */
+        void append_words(const uint64_t* words, size_t n);
+        /**
+         * @brief Evaluates \p expression block by block straight into m_Words
+         */
+        template <bit_expression E>
+        void assign(const E& expression);
     };
+
+    /**
+     * @returns \p pattern rotated left \p n bits. The bits shifted out on the left are shifted back in on the right.
+     */
+    bit_pattern rotl(const bit_pattern& pattern, uint64_t n);
+
+    /**
+     * @returns \p pattern rotated right \p n bits. The bits shifted out on the right are shifted back in on the
+     * left.
+     */
+    bit_pattern rotr(const bit_pattern& pattern, uint64_t n);
+
+    /**
+     * @brief The common interface of the nodes of a bitwise expression
+     * @details An expression is only evaluated when it is converted or assigned to a bit_pattern. Every node provides
+     * size() and block(first, n, buffer), which returns n words of its value starting at word first, either straight
+     * from the words of a pattern or computed into \p buffer. Nodes refer to the patterns they were built from, so
+     * don't keep an expression around longer than its operands.
+     */
+    template <typename Derived>
+    class bit_expression_base {
+    public:
+        /**
+         * @returns The value of the expression
+         */
+        [[nodiscard]] bit_pattern eval() const {
+            return bit_pattern{derived()};
+        }
+
+        /**
+         * @returns The bit at position \p index, computed from the word containing it
+         */
+        int operator[](size_t index) const {
+            uint64_t word;
+            return static_cast<int>(*derived().block(index / 64, 1, &word) >> (index % 64) & 1);
+        }
+
+        /**
+         * @returns A string representing the value of the expression
+         */
+        [[nodiscard]] std::string str() const {
+            return eval().str();
+        }
+
+        friend std::ostream& operator<<(std::ostream& os, const bit_expression_base& expression) {
+            return os << expression.eval();
+        }
+    private:
+        const Derived& derived() const {
+            return static_cast<const Derived&>(*this);
+        }
+    };
+
+    /**
+     * @brief A leaf of a bitwise expression. Refers to a pattern (Pattern = const bit_pattern&) or owns a pattern
+     * that was moved in (Pattern = bit_pattern), so temporaries used in an expression don't dangle.
+     */
+    template <typename Pattern>
+    class bit_operand : public bit_expression_base<bit_operand<Pattern>> {
+    public:
+        explicit bit_operand(Pattern pattern) : m_Pattern(std::forward<Pattern>(pattern)) {}
+
+        [[nodiscard]] size_t size() const noexcept {
+            return m_Pattern.m_Len;
+        }
+
+        [[nodiscard]] bool references(const bit_pattern& pattern) const noexcept {
+            return &m_Pattern == &pattern;
+        }
+
+        const uint64_t* block(size_t first, size_t, uint64_t*) const noexcept {
+            return m_Pattern.m_Words.data() + first;
+        }
+    private:
+        Pattern m_Pattern;
+    };
+
+    /**
+     * @brief A binary operation of a bitwise expression, with Op being bit_and_words, bit_or_words or bit_xor_words.
+     * The result has the length of the shorter operand.
+     */
+    template <typename Op, typename L, typename R>
+    class bit_binary_expression : public bit_expression_base<bit_binary_expression<Op, L, R>> {
+    public:
+        bit_binary_expression(L left, R right) : m_Left(std::move(left)), m_Right(std::move(right)) {}
+
+        [[nodiscard]] size_t size() const noexcept {
+            return std::min(m_Left.size(), m_Right.size());
+        }
+
+        [[nodiscard]] bool references(const bit_pattern& pattern) const noexcept {
+            return m_Left.references(pattern) || m_Right.references(pattern);
+        }
+
+        const uint64_t* block(size_t first, size_t n, uint64_t* buffer) const {
+            // THE LEFT OPERAND MAY USE THE BUFFER OF THIS NODE, AS THE KERNELS ALLOW THEIR OUTPUT TO ALIAS AN INPUT
+            alignas(64) uint64_t right[BIT_EXPRESSION_BLOCK];
+            const auto* a = m_Left.block(first, n, buffer);
+            const auto* b = m_Right.block(first, n, right);
+            Op::apply(buffer, a, b, n);
+            return buffer;
+        }
+    private:
+        L m_Left;
+        R m_Right;
+    };
+
+    /**
+     * @brief The NOT operation of a bitwise expression
+     */
+    template <typename T>
+    class bit_not_expression : public bit_expression_base<bit_not_expression<T>> {
+    public:
+        explicit bit_not_expression(T operand) : m_Operand(std::move(operand)) {}
+
+        [[nodiscard]] size_t size() const noexcept {
+            return m_Operand.size();
+        }
+
+        [[nodiscard]] bool references(const bit_pattern& pattern) const noexcept {
+            return m_Operand.references(pattern);
+        }
+
+        const uint64_t* block(size_t first, size_t n, uint64_t* buffer) const {
+            bit_not_words::apply(buffer, m_Operand.block(first, n, buffer), n);
+            return buffer;
+        }
+    private:
+        T m_Operand;
+    };
+
+    /**
+     * @brief Satisfied by everything the bitwise operators accept: patterns and expressions
+     */
+    template <typename T>
+    concept bit_expression_operand = std::same_as<std::remove_cvref_t<T>, bit_pattern> || bit_expression<T>;
+
+    /**
+     * @brief The node type an operand is stored as. Patterns become leaves, which own rvalue patterns.
+     */
+    template <typename T>
+    using bit_operand_t = std::conditional_t<
+            std::same_as<std::remove_cvref_t<T>, bit_pattern>,
+            std::conditional_t<std::is_lvalue_reference_v<T>, bit_operand<const bit_pattern&>, bit_operand<bit_pattern>>,
+            std::remove_cvref_t<T>>;
+
+    /**
+     * @returns A lazy expression for the AND of both operands with the length of the shorter one
+     */
+    template <bit_expression_operand L, bit_expression_operand R>
+    auto operator&(L&& left, R&& right) {
+        return bit_binary_expression<bit_and_words, bit_operand_t<L>, bit_operand_t<R>>{
+                bit_operand_t<L>{std::forward<L>(left)}, bit_operand_t<R>{std::forward<R>(right)}};
+    }
+
+    /**
+     * @returns A lazy expression for the OR of both operands with the length of the shorter one
+     */
+    template <bit_expression_operand L, bit_expression_operand R>
+    auto operator|(L&& left, R&& right) {
+        return bit_binary_expression<bit_or_words, bit_operand_t<L>, bit_operand_t<R>>{
+                bit_operand_t<L>{std::forward<L>(left)}, bit_operand_t<R>{std::forward<R>(right)}};
+    }
+
+    /**
+     * @returns A lazy expression for the XOR of both operands with the length of the shorter one
+     */
+    template <bit_expression_operand L, bit_expression_operand R>
+    auto operator^(L&& left, R&& right) {
+        return bit_binary_expression<bit_xor_words, bit_operand_t<L>, bit_operand_t<R>>{
+                bit_operand_t<L>{std::forward<L>(left)}, bit_operand_t<R>{std::forward<R>(right)}};
+    }
+
+    /**
+     * @returns A lazy expression for the NOT of the operand
+     */
+    template <bit_expression_operand T>
+    auto operator~(T&& operand) {
+        return bit_not_expression<bit_operand_t<T>>{bit_operand_t<T>{std::forward<T>(operand)}};
+    }
+
+    template <bit_expression E>
+    void bit_pattern::assign(const E& expression) {
+        const auto len = expression.size();
+        const auto count = (len + 63) / 64;
+        // A PATTERN THAT IS AN OPERAND IS AT LEAST AS LONG AS THE RESULT, SO ITS WORDS AREN'T REALLOCATED. EVERY
+        // BLOCK ONLY READS THE SAME BLOCK OF THE OPERANDS, BUT NESTED NODES WOULD OVERWRITE IT BEFORE THEIR SIBLINGS
+        // READ IT, SO AN ALIASED RESULT IS COMPUTED IN A SEPARATE BUFFER.
+        const bool aliased = expression.references(*this);
+        mp_RankIndex.reset();
+        m_Words.resize_for_overwrite(count);
+        m_Len = len;
+        alignas(64) uint64_t buffer[BIT_EXPRESSION_BLOCK];
+        for (size_t first = 0; first < count; first += BIT_EXPRESSION_BLOCK) {
+            const auto n = std::min(BIT_EXPRESSION_BLOCK, count - first);
+            auto* dst = m_Words.data() + first;
+            const auto* src = expression.block(first, n, aliased ? buffer : dst);
+            if (src != dst)
+                std::copy_n(src, n, dst);
+        }
+        // THE LAST WORD OF A LONGER OPERAND MAY HAVE BITS PAST THE LENGTH OF THE RESULT
+        clear_unused_bits();
+    }
 }
 
+/**
+ * @brief Allows bit_patterns as keys of unordered containers
+ */
+template <>
+struct std::hash<pinepp::bit_pattern> {
+    size_t operator()(const pinepp::bit_pattern& pattern) const noexcept {
+        return pattern.hash();
+    }
+};
+
 #endif //PINEPP_BIT_PATTERN_HPP
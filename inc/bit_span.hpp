@@ -0,0 +1,187 @@
+//
+// Created by konstantin on 17.10.26.
+//
+
+#ifndef PINEPP_BIT_SPAN_HPP
+#define PINEPP_BIT_SPAN_HPP
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "bit_pattern.hpp"
+
+namespace pinepp {
+
+    /**
+     * @brief A non-owning view of a range of bits, given by a bit offset and a length, in a bit_pattern or in raw
+     * words
+     * @details Bits are numbered like in bit_pattern: bit i of the view is bit offset + i of the words, bit 0 being
+     * the least significant bit of the first word. Every operation works on whole words in the middle of its range
+     * and masks the partial words at the edges, so neither the offset nor the length has to be a multiple of 64.
+     * Like std::span, a view is shallow: a const view still writes to its bits. The words must outlive the view,
+     * and resizing a viewed bit_pattern invalidates it.
+     * @tparam Word uint64_t for a writable view, const uint64_t for a read-only one
+     */
+    template <typename Word>
+    class basic_bit_span {
+        static_assert(std::is_same_v<std::remove_const_t<Word>, uint64_t>, "A bit span views 64 bit words");
+        using pattern_type = std::conditional_t<std::is_const_v<Word>, const bit_pattern, bit_pattern>;
+    public:
+        /**
+         * @details Default constructs an empty view
+         */
+        basic_bit_span() = default;
+
+        /**
+         * @details Views the \p len bits of \p words starting at bit \p offset. The words are not checked.
+         */
+        basic_bit_span(Word* words, size_t offset, size_t len) noexcept;
+
+        /**
+         * @details Views all bits of \p pattern
+         */
+        basic_bit_span(pattern_type& pattern) noexcept;
+
+        /**
+         * @details Views the \p len bits of \p pattern starting at bit \p offset
+         * @throws std::out_of_range if the bits don't lie within \p pattern
+         */
+        basic_bit_span(pattern_type& pattern, size_t offset, size_t len);
+
+        /**
+         * @details Turns a writable view into a read-only one
+         */
+        template <typename Other>
+        requires std::is_const_v<Word> && (!std::is_const_v<Other>)
+        basic_bit_span(const basic_bit_span<Other>& other) noexcept
+                : mp_Words(other.mp_Words), m_Offset(other.m_Offset), m_Len(other.m_Len) {}
+
+        /**
+         * @returns The amount of bits in the view
+         */
+        [[nodiscard]] size_t size() const noexcept { return m_Len; }
+
+        /**
+         * @returns True if the view has no bits
+         */
+        [[nodiscard]] bool empty() const noexcept { return m_Len == 0; }
+
+        /**
+         * @details Allows read-only access to bits at a certain position. Does not check bounds.
+         * @returns An integer that is either 0 or 1
+         */
+        int operator[](size_t index) const noexcept {
+            const auto bit = m_Offset + index;
+            return static_cast<int>(mp_Words[bit / 64] >> (bit % 64) & 1);
+        }
+
+        /**
+         * @returns A view of the \p n bits starting at \p first
+         * @throws std::out_of_range if the bits don't lie within the view
+         */
+        [[nodiscard]] basic_bit_span subspan(size_t first, size_t n) const;
+
+        /**
+         * @returns The amount of bits set to 1
+         */
+        [[nodiscard]] size_t count() const noexcept;
+
+        /**
+         * @returns The amount of bits set to 1 among the \p n bits starting at \p first
+         * @throws std::out_of_range if the bits don't lie within the view
+         */
+        [[nodiscard]] size_t count_range(size_t first, size_t n) const;
+
+        /**
+         * @returns A bit_pattern with a copy of the bits of the view
+         */
+        [[nodiscard]] bit_pattern to_bit_pattern() const;
+
+        /**
+         * @details Sets the bit at position \p index to 1 if \p value is true or 0 otherwise.
+         * @throws std::out_of_range if \p index is not less than size()
+         */
+        void set_bit(size_t index, bool value) const requires (!std::is_const_v<Word>);
+
+        /**
+         * @details Sets the \p n bits starting at \p first to 1.
+         * @throws std::out_of_range if the bits don't lie within the view
+         */
+        void set_range(size_t first, size_t n) const requires (!std::is_const_v<Word>);
+
+        /**
+         * @details Sets the \p n bits starting at \p first to 0.
+         * @throws std::out_of_range if the bits don't lie within the view
+         */
+        void reset_range(size_t first, size_t n) const requires (!std::is_const_v<Word>);
+
+        /**
+         * @details Negates the \p n bits starting at \p first.
+         * @throws std::out_of_range if the bits don't lie within the view
+         */
+        void flip_range(size_t first, size_t n) const requires (!std::is_const_v<Word>);
+
+        /**
+         * @details Copies the bits of \p other into the view. The views must not overlap unless they are the same.
+         * @throws std::invalid_argument if the views differ in size
+         */
+        void assign(basic_bit_span<const uint64_t> other) const requires (!std::is_const_v<Word>);
+
+        /**
+         * @details ANDs the bits of \p other into the view. The offsets of the views don't have to match, but the
+         * views must not overlap unless they are the same.
+         * @throws std::invalid_argument if the views differ in size
+         */
+        const basic_bit_span& operator&=(basic_bit_span<const uint64_t> other) const
+                requires (!std::is_const_v<Word>);
+
+        /**
+         * @details ORs the bits of \p other into the view, like operator&=.
+         * @throws std::invalid_argument if the views differ in size
+         */
+        const basic_bit_span& operator|=(basic_bit_span<const uint64_t> other) const
+                requires (!std::is_const_v<Word>);
+
+        /**
+         * @details XORs the bits of \p other into the view, like operator&=.
+         * @throws std::invalid_argument if the views differ in size
+         */
+        const basic_bit_span& operator^=(basic_bit_span<const uint64_t> other) const
+                requires (!std::is_const_v<Word>);
+
+    private:
+        template <typename Other>
+        friend class basic_bit_span;
+
+        /**
+         * @brief Drops the rank directory of the viewed pattern before its bits change
+         */
+        void invalidate() const noexcept;
+        /**
+         * @throws std::out_of_range if the \p n bits starting at \p first don't lie within the view
+         */
+        void check_range(size_t first, size_t n) const;
+
+        Word* mp_Words = nullptr;
+        /**
+         * @brief The viewed pattern, if any, whose rank directory writes have to invalidate
+         */
+        pattern_type* mp_Pattern = nullptr;
+        size_t m_Offset = 0;
+        size_t m_Len = 0;
+    };
+
+    extern template class basic_bit_span<uint64_t>;
+    extern template class basic_bit_span<const uint64_t>;
+
+    /**
+     * @brief A writable view of a range of bits
+     */
+    using bit_span = basic_bit_span<uint64_t>;
+
+    /**
+     * @brief A read-only view of a range of bits
+     */
+    using const_bit_span = basic_bit_span<const uint64_t>;
+}
+
+#endif //PINEPP_BIT_SPAN_HPP
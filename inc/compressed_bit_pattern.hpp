@@ -0,0 +1,283 @@
+//
+// Created by konstantin on 17.10.26.
+//
+
+#ifndef PINEPP_COMPRESSED_BIT_PATTERN_HPP
+#define PINEPP_COMPRESSED_BIT_PATTERN_HPP
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <ostream>
+#include <vector>
+#include "bit_pattern.hpp"
+
+namespace pinepp {
+    struct compressed_bit_pattern_ops;
+
+    /**
+     * @brief A compressed_bit_pattern is a bit_pattern for sparse or clustered bits, compressed like a Roaring bitmap
+     * @details The pattern is split into chunks of 65536 bits. Chunks without set bits take no memory, the others
+     * are stored in whichever container is smallest for their bits: a sorted array of up to 4096 positions, a plain
+     * bitmap of 1024 words, or a list of runs of consecutive set bits. Bitwise operators pick the container of every
+     * resulting chunk anew.
+     */
+    class compressed_bit_pattern {
+    public:
+        /**
+         * @brief Returned by the find functions if there is no matching bit
+         */
+        static constexpr size_t npos = bit_pattern::npos;
+
+        /**
+         * @details Default constructs a compressed_bit_pattern with a size of 0
+         */
+        compressed_bit_pattern() = default;
+
+        /**
+         * @details Constructs a pattern of \p n bits that are all 0. This takes no memory besides the object itself.
+         * @param n The amount of bits in the pattern
+         */
+        explicit compressed_bit_pattern(size_t n);
+
+        /**
+         * @details Compresses \p pattern, chunk by chunk straight from its words.
+         * @param pattern The pattern to compress
+         */
+        explicit compressed_bit_pattern(const bit_pattern& pattern);
+
+        /**
+         * @returns The uncompressed bit_pattern with the same bits
+         */
+        [[nodiscard]] bit_pattern to_bit_pattern() const;
+
+        /**
+         * @returns The amount of bits in the pattern. This does not correspond to amount of memory used.
+         */
+        [[nodiscard]] size_t size() const noexcept;
+
+        /**
+         * @returns The amount of bytes used by the containers of the pattern
+         */
+        [[nodiscard]] size_t memory_usage() const noexcept;
+
+        /**
+         * @returns The amount of bits set to 1
+         */
+        [[nodiscard]] size_t count() const noexcept;
+
+        /**
+         * @returns True if at least one bit is set to 1
+         */
+        [[nodiscard]] bool any() const noexcept;
+
+        /**
+         * @returns True if no bit is set to 1
+         */
+        [[nodiscard]] bool none() const noexcept;
+
+        /**
+         * @returns The index of the least significant bit set to 1 or npos if there is none
+         */
+        [[nodiscard]] size_t find_first() const noexcept;
+
+        /**
+         * @returns The index of the first bit set to 1 that is more significant than \p index or npos if there is
+         * none
+         */
+        [[nodiscard]] size_t find_next(size_t index) const noexcept;
+
+        /**
+         * @details Sets the bit at position \p index to 1 if \p value is true or 0 otherwise.
+         * @throws std::out_of_range if \p index is not less than size()
+         */
+        void set_bit(size_t index, bool value);
+
+        /**
+         * @details Allows read-only access to bits at a certain position.
+         * @returns An integer that is either 0 or 1
+         */
+        int operator[](size_t index) const;
+
+    private:
+        /**
+         * @details Like bit_pattern::iterator, a read-only iterator that returns the bit at every position as an
+         * integer.
+         */
+        class iterator {
+        public:
+            explicit iterator(size_t index, const compressed_bit_pattern* ptr);
+            iterator& operator++();
+            bool operator==(iterator other) const;
+            bool operator!=(iterator other) const;
+            int operator*() const;
+        private:
+            const compressed_bit_pattern* mp_Pattern;
+            size_t m_Index = 0;
+        };
+    public:
+        /**
+         * @brief A forward iterator over the indices of the bits set to 1, in ascending order
+         * @details Walks the containers directly: chunks without set bits are never visited, arrays and runs are
+         * read in order and bitmaps word by word with a single TZCNT per set bit, so iterating costs time
+         * proportional to the amount of set bits. Changing the pattern invalidates the iterator.
+         */
+        class set_bit_iterator {
+        public:
+            using iterator_concept = std::forward_iterator_tag;
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = size_t;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = size_t;
+
+            set_bit_iterator() = default;
+
+            /**
+             * @details Points at the first set bit of the chunk at position \p chunk of m_Keys or at the end if
+             * \p chunk is the amount of chunks
+             */
+            explicit set_bit_iterator(const compressed_bit_pattern* ptr, size_t chunk) noexcept;
+
+            size_t operator*() const noexcept;
+            set_bit_iterator& operator++() noexcept;
+            set_bit_iterator operator++(int) noexcept;
+            bool operator==(const set_bit_iterator& other) const noexcept;
+        private:
+            /**
+             * @brief Moves to the first set bit of the chunk at m_Chunk, if there is one
+             */
+            void enter_chunk() noexcept;
+
+            const compressed_bit_pattern* mp_Pattern = nullptr;
+            /**
+             * @brief The position of the current chunk in m_Keys
+             */
+            size_t m_Chunk = 0;
+            /**
+             * @brief ARRAY: The position in the values. BITMAP: The current word. RUN: The position of the start of
+             * the current run in the values.
+             */
+            size_t m_Slot = 0;
+            /**
+             * @brief The position of the current bit within its chunk
+             */
+            size_t m_Position = 0;
+            /**
+             * @brief BITMAP: The bits of the current word that haven't been visited yet
+             */
+            uint64_t m_Word = 0;
+        };
+
+        /**
+         * @brief The range of the indices of the bits set to 1, returned by set_bits()
+         */
+        class set_bit_range {
+        public:
+            explicit set_bit_range(const compressed_bit_pattern* ptr) noexcept : mp_Pattern(ptr) {}
+
+            [[nodiscard]] set_bit_iterator begin() const noexcept {
+                return set_bit_iterator{mp_Pattern, 0};
+            }
+
+            [[nodiscard]] set_bit_iterator end() const noexcept {
+                return set_bit_iterator{mp_Pattern, mp_Pattern->m_Keys.size()};
+            }
+        private:
+            const compressed_bit_pattern* mp_Pattern;
+        };
+
+        /**
+         * @details Every step looks the bit up with a binary search over the chunks and a search in its container,
+         * so iterating over a sparse pattern this way costs time proportional to its size. Prefer set_bits() to
+         * visit the set bits only.
+         * @returns An iterator on the least significant bit
+         */
+        [[nodiscard]] iterator begin() const;
+
+        /**
+         * @returns An iterator one past the end. Do not dereference this iterator.
+         */
+        [[nodiscard]] iterator end() const;
+
+        /**
+         * @returns The indices of the bits set to 1 in ascending order, e.g. for (size_t i : cbp.set_bits())
+         */
+        [[nodiscard]] set_bit_range set_bits() const noexcept;
+
+        /**
+         * @returns The result of an AND operation on both patterns with the length of the shorter pattern
+         */
+        compressed_bit_pattern operator&(const compressed_bit_pattern& other) const;
+
+        /**
+         * @returns The result of an OR operation on both patterns with the length of the shorter pattern
+         */
+        compressed_bit_pattern operator|(const compressed_bit_pattern& other) const;
+
+        /**
+         * @returns The result of a XOR operation on both patterns with the length of the shorter pattern
+         */
+        compressed_bit_pattern operator^(const compressed_bit_pattern& other) const;
+
+        /**
+         * @returns The result of a NOT operation on the pattern. Chunks without set bits become runs.
+         */
+        compressed_bit_pattern operator~() const;
+
+        /**
+         * @details Checks if two patterns have the same size and the same bits, regardless of their containers.
+         */
+        bool operator==(const compressed_bit_pattern& other) const;
+
+        /**
+         * @returns The opposite result of the == operator
+         */
+        bool operator!=(const compressed_bit_pattern& other) const;
+
+    private:
+        /**
+         * @brief The bits of one chunk of 65536 bits
+         */
+        struct container {
+            enum class kind : uint8_t { ARRAY, BITMAP, RUN };
+            kind type = kind::ARRAY;
+            /**
+             * @brief The amount of bits set to 1, up to 65536
+             */
+            uint32_t cardinality = 0;
+            /**
+             * @brief ARRAY: The sorted positions of the set bits. RUN: Pairs of the start and the length - 1 of every
+             * run of set bits.
+             */
+            std::vector<uint16_t> values{};
+            /**
+             * @brief BITMAP: The 1024 words of the chunk
+             */
+            std::vector<uint64_t> words{};
+        };
+
+        /**
+         * @brief The index of every chunk with at least one set bit, in ascending order
+         */
+        std::vector<size_t> m_Keys{};
+        /**
+         * @brief The container of every chunk in m_Keys
+         */
+        std::vector<container> m_Containers{};
+        /**
+         * @brief The amount of bits in the pattern
+         */
+        size_t m_Len = 0;
+
+        /**
+         * @brief Writes the pattern to an ostream like a bit_pattern, with the least significant bit on the right
+         */
+        friend std::ostream& operator<<(std::ostream& os, const compressed_bit_pattern& pattern);
+        /**
+         * @brief Implements the chunk-wise algorithms in the source file
+         */
+        friend struct compressed_bit_pattern_ops;
+    };
+}
+
+#endif //PINEPP_COMPRESSED_BIT_PATTERN_HPP
@@ -0,0 +1,444 @@
+//
+// Created by konstantin on 17.10.26.
+//
+
+#ifndef PINEPP_FIXED_BIT_PATTERN_HPP
+#define PINEPP_FIXED_BIT_PATTERN_HPP
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include "bit_pattern.hpp"
+
+namespace pinepp {
+    /**
+     * @brief A fixed_bit_pattern is a bit_pattern whose size is known at compile-time
+     * @details The words are stored inline, so a fixed_bit_pattern never allocates and every operation can be used
+     * in constant expressions. Operations are loops over a constant amount of words, which the compiler unrolls and
+     * vectorizes for the target it compiles for instead of dispatching at runtime. Like in bit_pattern, the bits
+     * past N are always 0.
+     * @tparam N The amount of bits in the pattern
+     */
+    template <size_t N>
+    class fixed_bit_pattern {
+        static constexpr size_t WORDS = (N + 63) / 64;
+        template <size_t M>
+        friend class fixed_bit_pattern;
+    public:
+        /**
+         * @brief Returned by the find functions if there is no matching bit
+         */
+        static constexpr size_t npos = bit_pattern::npos;
+
+        /**
+         * @details Constructs a pattern with all bits set to 0
+         */
+        constexpr fixed_bit_pattern() noexcept = default;
+
+        /**
+         * @details Constructs a pattern from the bits of \p value, cut to N bits. Handy for masks of flags.
+         */
+        constexpr explicit fixed_bit_pattern(uint64_t value) noexcept {
+            if constexpr (WORDS > 0) {
+                m_Words[0] = value;
+                clear_unused_bits();
+            }
+        }
+
+        /**
+         * @details Constructs a pattern from a string of bits or a hexadecimal number starting with 0x, like
+         * bit_pattern. The right most character is the least significant bit, missing bits on the left are 0.
+         * @throws std::invalid_argument if \p str is neither or has set bits that don't fit N bits. In a constant
+         * expression, this is a compile error.
+         */
+        constexpr explicit fixed_bit_pattern(std::string_view str) {
+            const bool hex = str.size() > 2 && str[0] == '0' && (str[1] == 'x' || str[1] == 'X');
+            if (str.empty())
+                throw std::invalid_argument{"Given string is not a valid bit pattern"};
+            size_t index = 0;
+            for (size_t i = str.size(); i-- > (hex ? 2 : 0);) {
+                const auto digit = hex ? hex_digit(str[i]) : binary_digit(str[i]);
+                for (size_t bit = 0; bit < (hex ? 4 : 1); ++bit, ++index) {
+                    if ((digit >> bit & 1) == 0)
+                        continue;
+                    if (index >= N)
+                        throw std::invalid_argument{"Given string doesn't fit the size of the fixed_bit_pattern"};
+                    m_Words[index / 64] |= uint64_t{1} << (index % 64);
+                }
+            }
+        }
+
+        /**
+         * @details Copies the words of \p pattern, cutting it to N bits or padding it with bits set to 0.
+         */
+        explicit fixed_bit_pattern(const bit_pattern& pattern) {
+            std::copy_n(pattern.m_Words.data(), std::min(WORDS, pattern.m_Words.size()), m_Words.data());
+            clear_unused_bits();
+        }
+
+        /**
+         * @returns A bit_pattern of N bits with the same bits
+         */
+        [[nodiscard]] bit_pattern to_bit_pattern() const {
+            bit_pattern rv{N};
+            std::copy_n(m_Words.data(), WORDS, rv.m_Words.data());
+            return rv;
+        }
+
+        /**
+         * @returns The amount of bits in the pattern
+         */
+        [[nodiscard]] static constexpr size_t size() noexcept {
+            return N;
+        }
+
+        /**
+         * @returns The amount of bits set to 1
+         */
+        [[nodiscard]] constexpr size_t count() const noexcept {
+            size_t rv = 0;
+            for (auto word : m_Words)
+                rv += static_cast<size_t>(std::popcount(word));
+            return rv;
+        }
+
+        /**
+         * @returns True if at least one bit is set to 1
+         */
+        [[nodiscard]] constexpr bool any() const noexcept {
+            return std::any_of(m_Words.begin(), m_Words.end(), [](uint64_t word) { return word != 0; });
+        }
+
+        /**
+         * @returns True if no bit is set to 1
+         */
+        [[nodiscard]] constexpr bool none() const noexcept {
+            return !any();
+        }
+
+        /**
+         * @returns True if every bit is set to 1
+         */
+        [[nodiscard]] constexpr bool all() const noexcept {
+            return *this == ~fixed_bit_pattern{};
+        }
+
+        /**
+         * @returns The index of the least significant bit set to 1 or npos if there is none
+         */
+        [[nodiscard]] constexpr size_t find_first() const noexcept {
+            return find_from(0);
+        }
+
+        /**
+         * @returns The index of the first bit set to 1 that is more significant than \p index or npos if there is
+         * none
+         */
+        [[nodiscard]] constexpr size_t find_next(size_t index) const noexcept {
+            return index >= N - 1 ? npos : find_from(index + 1);
+        }
+
+        /**
+         * @returns The index of the most significant bit set to 1 or npos if there is none
+         */
+        [[nodiscard]] constexpr size_t find_last() const noexcept {
+            for (size_t i = WORDS; i-- > 0;) {
+                if (m_Words[i] != 0)
+                    return i * 64 + 63 - static_cast<size_t>(std::countl_zero(m_Words[i]));
+            }
+            return npos;
+        }
+
+        /**
+         * @returns The amount of consecutive 0 bits, starting at the most significant bit
+         */
+        [[nodiscard]] constexpr size_t countl_zero() const noexcept {
+            const auto last = find_last();
+            return last == npos ? N : N - 1 - last;
+        }
+
+        /**
+         * @returns The amount of consecutive 0 bits, starting at the least significant bit
+         */
+        [[nodiscard]] constexpr size_t countr_zero() const noexcept {
+            const auto first = find_first();
+            return first == npos ? N : first;
+        }
+
+        /**
+         * @details Sets the bit at position \p index to 1 if \p value is true or 0 otherwise.
+         * @throws std::out_of_range if \p index is not less than N
+         */
+        constexpr fixed_bit_pattern& set_bit(size_t index, bool value) {
+            if (index >= N)
+                throw std::out_of_range{"Index is out of range of the fixed_bit_pattern"};
+            if (value)
+                m_Words[index / 64] |= uint64_t{1} << (index % 64);
+            else
+                m_Words[index / 64] &= ~(uint64_t{1} << (index % 64));
+            return *this;
+        }
+
+        /**
+         * @details Inverts every bit of the pattern in place.
+         */
+        constexpr fixed_bit_pattern& flip() noexcept {
+            for (auto& word : m_Words)
+                word = ~word;
+            clear_unused_bits();
+            return *this;
+        }
+
+        /**
+         * @details Reverses the pattern in place.
+         */
+        constexpr fixed_bit_pattern& reverse() noexcept {
+            // REVERSING ALL WORDS MOVES THE PATTERN TO THE TOP OF THE LAST WORD, FROM WHERE IT'S SHIFTED BACK DOWN
+            std::reverse(m_Words.begin(), m_Words.end());
+            for (auto& word : m_Words)
+                word = reverse_word(word);
+            shift_words_right(WORDS * 64 - N);
+            return *this;
+        }
+
+        /**
+         * @details Allows read-only access to bits at a certain position.
+         * @returns An integer that is either 0 or 1
+         */
+        constexpr int operator[](size_t index) const noexcept {
+            return static_cast<int>(m_Words[index / 64] >> (index % 64) & 1);
+        }
+
+        constexpr fixed_bit_pattern& operator&=(const fixed_bit_pattern& other) noexcept {
+            for (size_t i = 0; i < WORDS; ++i)
+                m_Words[i] &= other.m_Words[i];
+            return *this;
+        }
+
+        constexpr fixed_bit_pattern& operator|=(const fixed_bit_pattern& other) noexcept {
+            for (size_t i = 0; i < WORDS; ++i)
+                m_Words[i] |= other.m_Words[i];
+            return *this;
+        }
+
+        constexpr fixed_bit_pattern& operator^=(const fixed_bit_pattern& other) noexcept {
+            for (size_t i = 0; i < WORDS; ++i)
+                m_Words[i] ^= other.m_Words[i];
+            return *this;
+        }
+
+        /**
+         * @returns The result of an AND operation on both patterns
+         */
+        constexpr fixed_bit_pattern operator&(const fixed_bit_pattern& other) const noexcept {
+            return fixed_bit_pattern{*this} &= other;
+        }
+
+        /**
+         * @returns The result of an OR operation on both patterns
+         */
+        constexpr fixed_bit_pattern operator|(const fixed_bit_pattern& other) const noexcept {
+            return fixed_bit_pattern{*this} |= other;
+        }
+
+        /**
+         * @returns The result of a XOR operation on both patterns
+         */
+        constexpr fixed_bit_pattern operator^(const fixed_bit_pattern& other) const noexcept {
+            return fixed_bit_pattern{*this} ^= other;
+        }
+
+        /**
+         * @returns The result of a NOT operation on the pattern
+         */
+        constexpr fixed_bit_pattern operator~() const noexcept {
+            return fixed_bit_pattern{*this}.flip();
+        }
+
+        /**
+         * @details Shifts the pattern left \p n bits in place, towards the most significant bit.
+         */
+        constexpr fixed_bit_pattern& operator<<=(size_t n) noexcept {
+            if (n >= N) {
+                m_Words.fill(0);
+                return *this;
+            }
+            const auto word_shift = n / 64;
+            const auto bit_shift = n % 64;
+            for (size_t i = WORDS; i-- > word_shift;) {
+                const auto lo = i > word_shift ? m_Words[i - word_shift - 1] : 0;
+                m_Words[i] = bit_shift == 0 ? m_Words[i - word_shift]
+                                            : m_Words[i - word_shift] << bit_shift | lo >> (64 - bit_shift);
+            }
+            std::fill_n(m_Words.begin(), word_shift, 0);
+            clear_unused_bits();
+            return *this;
+        }
+
+        /**
+         * @details Shifts the pattern right \p n bits in place, towards the least significant bit.
+         */
+        constexpr fixed_bit_pattern& operator>>=(size_t n) noexcept {
+            if (n >= N) {
+                m_Words.fill(0);
+                return *this;
+            }
+            shift_words_right(n);
+            return *this;
+        }
+
+        /**
+         * @returns The pattern shifted left \p n bits. Bits shifted out are lost, zeros are shifted in on the right.
+         */
+        constexpr fixed_bit_pattern operator<<(size_t n) const noexcept {
+            return fixed_bit_pattern{*this} <<= n;
+        }
+
+        /**
+         * @returns The pattern shifted right \p n bits. Bits shifted out are lost, zeros are shifted in on the left.
+         */
+        constexpr fixed_bit_pattern operator>>(size_t n) const noexcept {
+            return fixed_bit_pattern{*this} >>= n;
+        }
+
+        /**
+         * @details Rotates the pattern left \p n bits in place.
+         */
+        constexpr fixed_bit_pattern& rotate_left(size_t n) noexcept {
+            if (N > 1 && n % N != 0)
+                *this = *this << n % N | *this >> (N - n % N);
+            return *this;
+        }
+
+        /**
+         * @details Rotates the pattern right \p n bits in place.
+         */
+        constexpr fixed_bit_pattern& rotate_right(size_t n) noexcept {
+            return N > 1 ? rotate_left(N - n % N) : *this;
+        }
+
+        /**
+         * @returns Concatenates two patterns, with \p other becoming the least significant bits like in
+         * bit_pattern::operator+
+         */
+        template <size_t M>
+        constexpr fixed_bit_pattern<N + M> operator+(const fixed_bit_pattern<M>& other) const noexcept {
+            return fixed_bit_pattern<N + M>{*this} << M | fixed_bit_pattern<N + M>{other};
+        }
+
+        /**
+         * @details Checks if two patterns contain the same bits.
+         */
+        constexpr bool operator==(const fixed_bit_pattern& other) const noexcept = default;
+
+        /**
+         * @returns A string representing the pattern
+         */
+        [[nodiscard]] std::string str() const {
+            std::string rv(N, '0');
+            for (size_t i = 0; i < N; ++i)
+                rv[N - 1 - i] = static_cast<char>('0' + (*this)[i]);
+            return rv;
+        }
+
+        /**
+         * @brief Writes the pattern to an ostream like a bit_pattern, with the least significant bit on the right
+         */
+        friend std::ostream& operator<<(std::ostream& os, const fixed_bit_pattern& pattern) {
+            return os << pattern.str();
+        }
+    private:
+        /**
+         * @details Widens or cuts another fixed_bit_pattern, used by operator+.
+         */
+        template <size_t M>
+        constexpr explicit fixed_bit_pattern(const fixed_bit_pattern<M>& other) noexcept {
+            std::copy_n(other.m_Words.begin(), std::min(WORDS, fixed_bit_pattern<M>::WORDS), m_Words.begin());
+            clear_unused_bits();
+        }
+
+        static constexpr uint64_t binary_digit(char c) {
+            if (c != '0' && c != '1')
+                throw std::invalid_argument{"Given string is not a valid bit pattern"};
+            return static_cast<uint64_t>(c - '0');
+        }
+
+        static constexpr uint64_t hex_digit(char c) {
+            if (c >= '0' && c <= '9')
+                return static_cast<uint64_t>(c - '0');
+            if (c >= 'a' && c <= 'f')
+                return static_cast<uint64_t>(c - 'a' + 10);
+            if (c >= 'A' && c <= 'F')
+                return static_cast<uint64_t>(c - 'A' + 10);
+            throw std::invalid_argument{"Given string is not a valid bit pattern"};
+        }
+
+        static constexpr uint64_t reverse_word(uint64_t word) noexcept {
+            word = (word >> 1 & 0x5555555555555555) | (word & 0x5555555555555555) << 1;
+            word = (word >> 2 & 0x3333333333333333) | (word & 0x3333333333333333) << 2;
+            word = (word >> 4 & 0x0f0f0f0f0f0f0f0f) | (word & 0x0f0f0f0f0f0f0f0f) << 4;
+            word = (word >> 8 & 0x00ff00ff00ff00ff) | (word & 0x00ff00ff00ff00ff) << 8;
+            word = (word >> 16 & 0x0000ffff0000ffff) | (word & 0x0000ffff0000ffff) << 16;
+            return word >> 32 | word << 32;
+        }
+
+        /**
+         * @returns The index of the first bit set to 1 at or after \p index or npos if there is none
+         */
+        constexpr size_t find_from(size_t index) const noexcept {
+            for (size_t i = index / 64; i < WORDS; ++i) {
+                const auto word = i == index / 64 ? m_Words[i] & (~uint64_t{0} << (index % 64)) : m_Words[i];
+                if (word != 0)
+                    return i * 64 + static_cast<size_t>(std::countr_zero(word));
+            }
+            return npos;
+        }
+
+        /**
+         * @details Shifts the words right \p n < 64 * WORDS bits, regardless of N.
+         */
+        constexpr void shift_words_right(size_t n) noexcept {
+            const auto word_shift = n / 64;
+            const auto bit_shift = n % 64;
+            for (size_t i = 0; i + word_shift < WORDS; ++i) {
+                const auto hi = i + word_shift + 1 < WORDS ? m_Words[i + word_shift + 1] : 0;
+                m_Words[i] = bit_shift == 0 ? m_Words[i + word_shift]
+                                            : m_Words[i + word_shift] >> bit_shift | hi << (64 - bit_shift);
+            }
+            std::fill(m_Words.end() - static_cast<ptrdiff_t>(word_shift), m_Words.end(), 0);
+        }
+
+        constexpr void clear_unused_bits() noexcept {
+            if constexpr (N % 64 != 0)
+                m_Words[WORDS - 1] &= (uint64_t{1} << (N % 64)) - 1;
+        }
+
+        /**
+         * @brief The words that contain the pattern, least significant bit first
+         */
+        std::array<uint64_t, WORDS> m_Words{};
+    };
+
+    /**
+     * @returns \p pattern rotated left \p n bits
+     */
+    template <size_t N>
+    constexpr fixed_bit_pattern<N> rotl(fixed_bit_pattern<N> pattern, size_t n) noexcept {
+        return pattern.rotate_left(n);
+    }
+
+    /**
+     * @returns \p pattern rotated right \p n bits
+     */
+    template <size_t N>
+    constexpr fixed_bit_pattern<N> rotr(fixed_bit_pattern<N> pattern, size_t n) noexcept {
+        return pattern.rotate_right(n);
+    }
+}
+
+#endif //PINEPP_FIXED_BIT_PATTERN_HPP
@@ -0,0 +1,97 @@
+//
+// Created by konstantin on 17.10.26.
+//
+
+#include <stdexcept>
+#include <utility>
+#include "atomic_bit_pattern.hpp"
+
+namespace {
+    [[noreturn]] void throw_index_out_of_range() {
+        throw std::out_of_range{"Index is out of range of the atomic_bit_pattern"};
+    }
+}
+
+pinepp::atomic_bit_pattern::atomic_bit_pattern(size_t n)
+        : mp_Words(std::make_unique<std::atomic<uint64_t>[]>((n + 63) / 64)), m_Len(n) {}
+
+pinepp::atomic_bit_pattern::atomic_bit_pattern(const bit_pattern& pattern) : atomic_bit_pattern(pattern.m_Len) {
+    for (size_t i = 0; i < word_count(); ++i)
+        mp_Words[i].store(pattern.m_Words[i], std::memory_order_relaxed);
+}
+
+pinepp::atomic_bit_pattern::atomic_bit_pattern(atomic_bit_pattern&& other) noexcept
+        : mp_Words(std::move(other.mp_Words)), m_Len(std::exchange(other.m_Len, 0)) {}
+
+pinepp::atomic_bit_pattern& pinepp::atomic_bit_pattern::operator=(atomic_bit_pattern&& other) noexcept {
+    if (&other == this)
+        return *this;
+    mp_Words = std::move(other.mp_Words);
+    m_Len = std::exchange(other.m_Len, 0);
+    return *this;
+}
+
+void pinepp::atomic_bit_pattern::check_word(size_t word) const {
+    if (word >= word_count())
+        throw_index_out_of_range();
+}
+
+uint64_t pinepp::atomic_bit_pattern::valid_bits(size_t word) const {
+    check_word(word);
+    // ONLY THE LAST WORD CAN HAVE BITS PAST m_Len
+    return word + 1 < word_count() || m_Len % 64 == 0 ? ~uint64_t{0} : (uint64_t{1} << (m_Len % 64)) - 1;
+}
+
+bool pinepp::atomic_bit_pattern::test(size_t index, std::memory_order order) const {
+    if (index >= m_Len)
+        throw_index_out_of_range();
+    return mp_Words[index / 64].load(order) >> (index % 64) & 1;
+}
+
+bool pinepp::atomic_bit_pattern::test_and_set(size_t index, std::memory_order order) {
+    if (index >= m_Len)
+        throw_index_out_of_range();
+    const auto mask = uint64_t{1} << (index % 64);
+    return (mp_Words[index / 64].fetch_or(mask, order) & mask) != 0;
+}
+
+bool pinepp::atomic_bit_pattern::test_and_reset(size_t index, std::memory_order order) {
+    if (index >= m_Len)
+        throw_index_out_of_range();
+    const auto mask = uint64_t{1} << (index % 64);
+    return (mp_Words[index / 64].fetch_and(~mask, order) & mask) != 0;
+}
+
+void pinepp::atomic_bit_pattern::set_bit(size_t index, bool value, std::memory_order order) {
+    if (value)
+        test_and_set(index, order);
+    else
+        test_and_reset(index, order);
+}
+
+uint64_t pinepp::atomic_bit_pattern::load_word(size_t word, std::memory_order order) const {
+    check_word(word);
+    return mp_Words[word].load(order);
+}
+
+uint64_t pinepp::atomic_bit_pattern::fetch_or_word(size_t word, uint64_t mask, std::memory_order order) {
+    const auto valid = valid_bits(word);
+    return mp_Words[word].fetch_or(mask & valid, order);
+}
+
+uint64_t pinepp::atomic_bit_pattern::fetch_and_word(size_t word, uint64_t mask, std::memory_order order) {
+    check_word(word);
+    return mp_Words[word].fetch_and(mask, order);
+}
+
+uint64_t pinepp::atomic_bit_pattern::fetch_xor_word(size_t word, uint64_t mask, std::memory_order order) {
+    const auto valid = valid_bits(word);
+    return mp_Words[word].fetch_xor(mask & valid, order);
+}
+
+pinepp::bit_pattern pinepp::atomic_bit_pattern::snapshot(std::memory_order order) const {
+    bit_pattern rv{m_Len};
+    for (size_t i = 0; i < word_count(); ++i)
+        rv.m_Words[i] = mp_Words[i].load(order);
+    return rv;
+}
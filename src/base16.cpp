@@ -0,0 +1,211 @@
+//
+// Created by konstantin on 17.10.26.
+//
+
+#include <stdexcept>
+#include <immintrin.h>
+#include "base16.hpp"
+#include "base16_digits.hpp"
+
+namespace {
+    using pinepp::base16_case;
+    using pinepp::base64_kernel;
+    using pinepp::detail::BASE16_VALUES;
+#if defined(__x86_64__) || defined(__i386__)
+    using pinepp::detail::decode_digits_avx2;
+    using pinepp::detail::decode_digits_sse41;
+#endif
+
+    template <base16_case C>
+    alignas(16) constexpr char DIGITS[16] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9',
+                                             C == base16_case::LOWER ? 'a' : 'A', C == base16_case::LOWER ? 'b' : 'B',
+                                             C == base16_case::LOWER ? 'c' : 'C', C == base16_case::LOWER ? 'd' : 'D',
+                                             C == base16_case::LOWER ? 'e' : 'E', C == base16_case::LOWER ? 'f' : 'F'};
+
+    /**
+     * @details Like the base64 kernels, a kernel encodes or decodes as much of its input as it can handle and returns
+     * the amount of bytes or characters it consumed. Decoding stops in front of the first invalid pair of digits.
+     */
+    using encode_kernel = size_t (*)(const uint8_t* src, size_t len, char* dst);
+    using decode_kernel = size_t (*)(const char* src, size_t len, uint8_t* dst);
+
+    template <base16_case C>
+    size_t encode_scalar(const uint8_t* src, size_t len, char* dst) {
+        for (size_t i = 0; i < len; ++i) {
+            *dst++ = DIGITS<C>[src[i] >> 4];
+            *dst++ = DIGITS<C>[src[i] & 15];
+        }
+        return len;
+    }
+
+    size_t decode_scalar(const char* src, size_t len, uint8_t* dst) {
+        const auto chars_in_whole_bytes = len / 2 * 2;
+        for (size_t i = 0; i < chars_in_whole_bytes; i += 2) {
+            const auto hi = BASE16_VALUES[static_cast<uint8_t>(src[i])];
+            const auto lo = BASE16_VALUES[static_cast<uint8_t>(src[i + 1])];
+            if ((hi | lo) & 0x80)
+                return i;
+            *dst++ = static_cast<uint8_t>(hi << 4 | lo);
+        }
+        return chars_in_whole_bytes;
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    template <base16_case C>
+    __attribute__((target("sse4.1")))
+    size_t encode_sse41(const uint8_t* src, size_t len, char* dst) {
+        const __m128i digits = _mm_load_si128(reinterpret_cast<const __m128i*>(DIGITS<C>));
+        const __m128i mask_0f = _mm_set1_epi8(0x0f);
+        size_t i = 0;
+        for (; i + 16 <= len; i += 16, dst += 32) {
+            const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            const __m128i hi = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(in, 4), mask_0f));
+            const __m128i lo = _mm_shuffle_epi8(digits, _mm_and_si128(in, mask_0f));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi8(hi, lo));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), _mm_unpackhi_epi8(hi, lo));
+        }
+        return i;
+    }
+
+    __attribute__((target("sse4.1")))
+    size_t decode_sse41(const char* src, size_t len, uint8_t* dst) {
+        // EVERY PAIR OF DIGITS IS MERGED INTO hi * 16 + lo
+        const __m128i weights = _mm_set1_epi16(0x0110);
+        size_t i = 0;
+        for (; i + 32 <= len; i += 32, dst += 16) {
+            __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 16));
+            if (!decode_digits_sse41(first) || !decode_digits_sse41(second))
+                break;
+            const __m128i bytes = _mm_packus_epi16(_mm_maddubs_epi16(first, weights),
+                                                   _mm_maddubs_epi16(second, weights));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), bytes);
+        }
+        return i;
+    }
+
+    template <base16_case C>
+    __attribute__((target("avx2")))
+    size_t encode_avx2(const uint8_t* src, size_t len, char* dst) {
+        const __m256i digits = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(DIGITS<C>)));
+        const __m256i mask_0f = _mm256_set1_epi8(0x0f);
+        size_t i = 0;
+        for (; i + 32 <= len; i += 32, dst += 64) {
+            const __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            const __m256i hi = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(in, 4), mask_0f));
+            const __m256i lo = _mm256_shuffle_epi8(digits, _mm256_and_si256(in, mask_0f));
+            // THE UNPACKS WORK PER 128 BIT LANE, SO THE HALVES HAVE TO BE SWAPPED BACK INTO ORDER
+            const __m256i first = _mm256_unpacklo_epi8(hi, lo);
+            const __m256i second = _mm256_unpackhi_epi8(hi, lo);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), _mm256_permute2x128_si256(first, second, 0x20));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 32), _mm256_permute2x128_si256(first, second, 0x31));
+        }
+        return i;
+    }
+
+    __attribute__((target("avx2")))
+    size_t decode_avx2(const char* src, size_t len, uint8_t* dst) {
+        const __m256i weights = _mm256_set1_epi16(0x0110);
+        size_t i = 0;
+        for (; i + 64 <= len; i += 64, dst += 32) {
+            __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            __m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 32));
+            if (!decode_digits_avx2(first) || !decode_digits_avx2(second))
+                break;
+            const __m256i bytes = _mm256_packus_epi16(_mm256_maddubs_epi16(first, weights),
+                                                      _mm256_maddubs_epi16(second, weights));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), _mm256_permute4x64_epi64(bytes, 0xd8));
+        }
+        return i;
+    }
+#endif
+
+    struct kernels {
+        encode_kernel encode_lower;
+        encode_kernel encode_upper;
+        decode_kernel decode;
+    };
+
+    /**
+     * @details Indexed by base64_kernel. There is no AVX-512 kernel, the AVX2 kernel already runs at memory speed.
+     */
+    constexpr kernels KERNELS[4] = {
+            {encode_scalar<base16_case::LOWER>, encode_scalar<base16_case::UPPER>, decode_scalar},
+#if defined(__x86_64__) || defined(__i386__)
+            {encode_sse41<base16_case::LOWER>, encode_sse41<base16_case::UPPER>, decode_sse41},
+            {encode_avx2<base16_case::LOWER>, encode_avx2<base16_case::UPPER>, decode_avx2},
+            {encode_avx2<base16_case::LOWER>, encode_avx2<base16_case::UPPER>, decode_avx2}
+#else
+            {encode_scalar<base16_case::LOWER>, encode_scalar<base16_case::UPPER>, decode_scalar},
+            {encode_scalar<base16_case::LOWER>, encode_scalar<base16_case::UPPER>, decode_scalar},
+            {encode_scalar<base16_case::LOWER>, encode_scalar<base16_case::UPPER>, decode_scalar}
+#endif
+    };
+
+    const kernels& active_kernels() {
+        return KERNELS[static_cast<size_t>(pinepp::base64_active_kernel())];
+    }
+
+    [[noreturn]] void throw_invalid_encoding() {
+        throw std::invalid_argument{"Given string is not a valid base16 encoding"};
+    }
+}
+
+size_t pinepp::base16_decoded_size(std::string_view base16) {
+    if (base16.size() % 2 != 0)
+        throw_invalid_encoding();
+    return base16.size() / 2;
+}
+
+size_t pinepp::base16_encode(std::span<const std::byte> bytes, std::span<char> dst, base16_case letter_case) {
+    if (dst.size() < base16_encoded_size(bytes.size()))
+        throw std::invalid_argument{"Destination buffer is too small for the base16 encoding"};
+
+    const auto* src = reinterpret_cast<const uint8_t*>(bytes.data());
+    const auto len = bytes.size();
+    if (letter_case == base16_case::LOWER) {
+        const auto consumed = active_kernels().encode_lower(src, len, dst.data());
+        encode_scalar<base16_case::LOWER>(src + consumed, len - consumed, dst.data() + 2 * consumed);
+    } else {
+        const auto consumed = active_kernels().encode_upper(src, len, dst.data());
+        encode_scalar<base16_case::UPPER>(src + consumed, len - consumed, dst.data() + 2 * consumed);
+    }
+    return base16_encoded_size(len);
+}
+
+size_t pinepp::base16_encode(std::string_view str, std::span<char> dst, base16_case letter_case) {
+    return base16_encode(std::as_bytes(std::span{str}), dst, letter_case);
+}
+
+std::string pinepp::base16_encode(std::span<const std::byte> bytes, base16_case letter_case) {
+    std::string rv(base16_encoded_size(bytes.size()), '\0');
+    base16_encode(bytes, std::span{rv}, letter_case);
+    return rv;
+}
+
+std::string pinepp::base16_encode(std::string_view str, base16_case letter_case) {
+    return base16_encode(std::as_bytes(std::span{str}), letter_case);
+}
+
+size_t pinepp::base16_decode(std::string_view input, std::span<std::byte> dst) {
+    const auto byte_count = base16_decoded_size(input);
+    if (dst.size() < byte_count)
+        throw std::invalid_argument{"Destination buffer is too small for the decoded base16"};
+
+    auto* out = reinterpret_cast<uint8_t*>(dst.data());
+    auto consumed = active_kernels().decode(input.data(), input.size(), out);
+    consumed += decode_scalar(input.data() + consumed, input.size() - consumed, out + consumed / 2);
+    if (consumed != input.size())
+        throw_invalid_encoding();
+    return byte_count;
+}
+
+size_t pinepp::base16_decode(std::string_view input, std::span<char> dst) {
+    return base16_decode(input, std::as_writable_bytes(dst));
+}
+
+std::string pinepp::base16_decode(std::string_view input) {
+    std::string rv(base16_decoded_size(input), '\0');
+    base16_decode(input, std::span{rv});
+    return rv;
+}
@@ -0,0 +1,103 @@
+//
+// Created by konstantin on 17.10.26.
+//
+
+#ifndef PINEPP_BASE16_DIGITS_HPP
+#define PINEPP_BASE16_DIGITS_HPP
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+
+/**
+ * @brief Decoding of hexadecimal digits shared by base16 and the hexadecimal parsing of bit_pattern. Not installed.
+ */
+namespace pinepp::detail {
+
+    /**
+     * @details Maps every character to its value as a hexadecimal digit or to 0x80 if it isn't one.
+     */
+    inline constexpr std::array<uint8_t, 256> BASE16_VALUES = [] {
+        std::array<uint8_t, 256> table{};
+        table.fill(0x80);
+        for (uint8_t i = 0; i < 10; ++i)
+            table['0' + i] = i;
+        for (uint8_t i = 0; i < 6; ++i) {
+            table['a' + i] = static_cast<uint8_t>(10 + i);
+            table['A' + i] = static_cast<uint8_t>(10 + i);
+        }
+        return table;
+    }();
+
+    /**
+     * @details Packs the 16 hexadecimal digits at \p digits into \p word, the first digit most significant.
+     * @returns False if any of the characters isn't a hexadecimal digit, \p word is left unchanged then
+     */
+    inline bool pack_base16_word(const char* digits, uint64_t& word) {
+        uint64_t rv = 0;
+        uint8_t invalid = 0;
+        for (size_t i = 0; i < 16; ++i) {
+            const auto value = BASE16_VALUES[static_cast<uint8_t>(digits[i])];
+            invalid |= value;
+            rv = rv << 4 | (value & 0xf);
+        }
+        if (invalid & 0x80)
+            return false;
+        word = rv;
+        return true;
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    /**
+     * @details Turns 16 characters into the values of the hexadecimal digits they represent.
+     * @returns False if any of the characters isn't a hexadecimal digit
+     */
+    __attribute__((target("sse4.1")))
+    inline bool decode_digits_sse41(__m128i& str) {
+        const __m128i digit = _mm_sub_epi8(str, _mm_set1_epi8('0'));
+        const __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+        const __m128i letter = _mm_sub_epi8(_mm_or_si128(str, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+        const __m128i is_letter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+        if (_mm_movemask_epi8(_mm_or_si128(is_digit, is_letter)) != 0xffff)
+            return false;
+        str = _mm_blendv_epi8(_mm_add_epi8(letter, _mm_set1_epi8(10)), digit, is_digit);
+        return true;
+    }
+
+    /**
+     * @details Like decode_digits_sse41 for 32 characters.
+     */
+    __attribute__((target("avx2")))
+    inline bool decode_digits_avx2(__m256i& str) {
+        const __m256i digit = _mm256_sub_epi8(str, _mm256_set1_epi8('0'));
+        const __m256i is_digit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+        const __m256i letter = _mm256_sub_epi8(_mm256_or_si256(str, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+        const __m256i is_letter = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter);
+        if (_mm256_movemask_epi8(_mm256_or_si256(is_digit, is_letter)) != -1)
+            return false;
+        str = _mm256_blendv_epi8(_mm256_add_epi8(letter, _mm256_set1_epi8(10)), digit, is_digit);
+        return true;
+    }
+
+    /**
+     * @details Packs the 32 hexadecimal digits at \p digits into two words like pack_base16_word, \p first getting
+     * the first 16 digits and \p second the last 16.
+     * @returns False if any of the characters isn't a hexadecimal digit, the words are left unchanged then
+     */
+    __attribute__((target("avx2")))
+    inline bool pack_base16_words_avx2(const char* digits, uint64_t& first, uint64_t& second) {
+        __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(digits));
+        if (!decode_digits_avx2(values))
+            return false;
+        // TWO DIGITS TO A BYTE, FIRST DIGIT IN THE HIGH NIBBLE, THEN 8 BYTES PACKED INTO THE LOW HALF OF EACH LANE.
+        // THE BYTES ARE IN STRING ORDER, MOST SIGNIFICANT FIRST
+        const __m256i bytes = _mm256_maddubs_epi16(values, _mm256_set1_epi16(0x0110));
+        const __m256i packed = _mm256_packus_epi16(bytes, bytes);
+        first = __builtin_bswap64(static_cast<uint64_t>(_mm256_extract_epi64(packed, 0)));
+        second = __builtin_bswap64(static_cast<uint64_t>(_mm256_extract_epi64(packed, 2)));
+        return true;
+    }
+#endif
+}
+
+#endif //PINEPP_BASE16_DIGITS_HPP
@@ -0,0 +1,241 @@
+//
+// Created by konstantin on 17.10.26.
+//
+
+#include <array>
+#include <stdexcept>
+#include <immintrin.h>
+#include "base32.hpp"
+
+namespace {
+    using pinepp::base32_alphabet;
+    using pinepp::base64_kernel;
+
+    constexpr std::array<char, 64> make_encode_table(base32_alphabet alphabet) {
+        constexpr char STANDARD[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
+        constexpr char HEX[] = "0123456789ABCDEFGHIJKLMNOPQRSTUV";
+        // ONLY THE FIRST 32 ENTRIES ARE USED, THE REST PADS THE TABLE TO THE SIZE OF AN AVX-512 REGISTER
+        std::array<char, 64> table{};
+        for (size_t i = 0; i < 32; ++i)
+            table[i] = alphabet == base32_alphabet::STANDARD ? STANDARD[i] : HEX[i];
+        return table;
+    }
+
+    template <base32_alphabet A>
+    alignas(64) constexpr std::array<char, 64> ENCODE_TABLE = make_encode_table(A);
+
+    /**
+     * @details Maps every character to its value in the base32 alphabet or to 0x80 if it isn't part of it. Lower
+     * case letters are accepted as well.
+     */
+    constexpr std::array<uint8_t, 256> make_decode_table(base32_alphabet alphabet) {
+        const auto encode_table = make_encode_table(alphabet);
+        std::array<uint8_t, 256> table{};
+        table.fill(0x80);
+        for (uint8_t i = 0; i < 32; ++i) {
+            const auto c = static_cast<uint8_t>(encode_table[i]);
+            table[c] = i;
+            if (c >= 'A' && c <= 'Z')
+                table[c - 'A' + 'a'] = i;
+        }
+        return table;
+    }
+
+    template <base32_alphabet A>
+    alignas(64) constexpr std::array<uint8_t, 256> DECODE_TABLE = make_decode_table(A);
+
+    /**
+     * @details Like the base64 kernels, a kernel encodes or decodes as many whole blocks as it can handle and returns
+     * the amount of bytes or characters it consumed. Decoding stops in front of the first block containing an
+     * invalid character.
+     */
+    using encode_kernel = size_t (*)(const uint8_t* src, size_t len, char* dst);
+    using decode_kernel = size_t (*)(const char* src, size_t len, uint8_t* dst);
+
+    /**
+     * @returns The 40 bits of the 5 byte block \p src with the first byte being the most significant
+     */
+    inline uint64_t load_block(const uint8_t* src) {
+        return uint64_t{src[0]} << 32 | uint64_t{src[1]} << 24 | uint64_t{src[2]} << 16 | uint64_t{src[3]} << 8 |
+               uint64_t{src[4]};
+    }
+
+    template <base32_alphabet A>
+    size_t encode_scalar(const uint8_t* src, size_t len, char* dst) {
+        const auto bytes_in_whole_blocks = len / 5 * 5;
+        for (size_t i = 0; i < bytes_in_whole_blocks; i += 5) {
+            const auto block = load_block(src + i);
+            for (int j = 0; j < 8; ++j)
+                *dst++ = ENCODE_TABLE<A>[block >> (35 - 5 * j) & 31];
+        }
+        return bytes_in_whole_blocks;
+    }
+
+    template <base32_alphabet A>
+    size_t decode_scalar(const char* src, size_t len, uint8_t* dst) {
+        const auto chars_in_whole_blocks = len / 8 * 8;
+        for (size_t i = 0; i < chars_in_whole_blocks; i += 8) {
+            uint64_t block = 0;
+            uint8_t invalid = 0;
+            for (size_t j = 0; j < 8; ++j) {
+                const auto value = DECODE_TABLE<A>[static_cast<uint8_t>(src[i + j])];
+                invalid |= value;
+                block = block << 5 | (value & 31);
+            }
+            if (invalid & 0x80)
+                return i;
+            for (int j = 0; j < 5; ++j)
+                *dst++ = static_cast<uint8_t>(block >> (32 - 8 * j));
+        }
+        return chars_in_whole_blocks;
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    // THE AVX-512 KERNELS REQUIRE VBMI AND WORK LIKE THE BASE64 ONES, WITH ONE 5 BYTE BLOCK PER 64 BIT LANE. EACH
+    // ITERATION TURNS 40 BYTES INTO 64 CHARACTERS AND VICE VERSA.
+
+    constexpr uint64_t AVX512_BLOCK_MASK = 0x000000ffffffffff;
+    constexpr uint64_t AVX512_FULL_MASK = ~uint64_t{0};
+
+    template <base32_alphabet A>
+    __attribute__((target("avx512f,avx512bw,avx512vbmi")))
+    size_t encode_avx512(const uint8_t* src, size_t len, char* dst) {
+        // PUTS THE BYTES OF EACH BLOCK INTO THE LOW 40 BITS OF ITS LANE, MOST SIGNIFICANT BYTE FIRST
+        const __m512i shuffle_input = _mm512_set_epi64(
+                0x0000002324252627, 0x0000001e1f202122, 0x000000191a1b1c1d, 0x0000001415161718,
+                0x0000000f10111213, 0x0000000a0b0c0d0e, 0x0000000506070809, 0x0000000001020304);
+        const __m512i shifts = _mm512_set1_epi64(0x00050a0f14191e23);
+        const __m512i lookup = _mm512_load_si512(ENCODE_TABLE<A>.data());
+        const __m512i mask_1f = _mm512_set1_epi8(0x1f);
+
+        size_t i = 0;
+        for (; i + 40 <= len; i += 40, dst += 64) {
+            const __m512i v = _mm512_maskz_loadu_epi8(AVX512_BLOCK_MASK, src + i);
+            const __m512i in = _mm512_maskz_permutexvar_epi8(AVX512_FULL_MASK, shuffle_input, v);
+            const __m512i indices = _mm512_and_si512(
+                    _mm512_maskz_multishift_epi64_epi8(AVX512_FULL_MASK, shifts, in), mask_1f);
+            _mm512_storeu_si512(dst, _mm512_maskz_permutexvar_epi8(AVX512_FULL_MASK, indices, lookup));
+        }
+        return i;
+    }
+
+    template <base32_alphabet A>
+    __attribute__((target("avx512f,avx512bw,avx512vbmi")))
+    size_t decode_avx512(const char* src, size_t len, uint8_t* dst) {
+        const __m512i lookup_0 = _mm512_load_si512(DECODE_TABLE<A>.data());
+        const __m512i lookup_1 = _mm512_load_si512(DECODE_TABLE<A>.data() + 64);
+        // MOVES THE 5 BYTES OF EACH LANE TO THE OUTPUT, MOST SIGNIFICANT BYTE FIRST
+        const __m512i pack = _mm512_set_epi64(
+                0, 0, 0, 0x38393a3b3c303132, 0x333428292a2b2c20, 0x2122232418191a1b, 0x1c10111213140809,
+                0x0a0b0c0001020304);
+        const __m512i low_40_bits = _mm512_set1_epi64(0x000000ffffffffff);
+
+        size_t i = 0;
+        for (; i + 64 <= len; i += 64, dst += 40) {
+            const __m512i in = _mm512_loadu_si512(src + i);
+            const __m512i values = _mm512_permutex2var_epi8(lookup_0, in, lookup_1);
+            if (_mm512_movepi8_mask(_mm512_or_si512(values, in)) != 0)
+                break;
+            // 5 -> 10 -> 20 -> 40 BITS
+            const __m512i pairs = _mm512_maddubs_epi16(values, _mm512_set1_epi16(0x0120));
+            const __m512i quads = _mm512_madd_epi16(pairs, _mm512_set1_epi32(0x00010400));
+            const __m512i blocks = _mm512_or_si512(
+                    _mm512_and_si512(_mm512_maskz_slli_epi64(0xff, quads, 20), low_40_bits),
+                    _mm512_maskz_srli_epi64(0xff, quads, 32));
+            _mm512_mask_storeu_epi8(dst, AVX512_BLOCK_MASK,
+                                    _mm512_maskz_permutexvar_epi8(AVX512_BLOCK_MASK, pack, blocks));
+        }
+        return i;
+    }
+#endif
+
+    struct kernels {
+        encode_kernel encode;
+        decode_kernel decode;
+    };
+
+    /**
+     * @details Indexed by base64_kernel. Narrower instruction sets than AVX-512 VBMI lack the byte permutes the
+     * 5 bit fields need and use the scalar kernel.
+     */
+    template <base32_alphabet A>
+    constexpr kernels KERNELS[4] = {
+            {encode_scalar<A>, decode_scalar<A>},
+            {encode_scalar<A>, decode_scalar<A>},
+            {encode_scalar<A>, decode_scalar<A>},
+#if defined(__x86_64__) || defined(__i386__)
+            {encode_avx512<A>, decode_avx512<A>}
+#else
+            {encode_scalar<A>, decode_scalar<A>}
+#endif
+    };
+
+    template <base32_alphabet A>
+    const kernels& active_kernels() {
+        return KERNELS<A>[static_cast<size_t>(pinepp::base64_active_kernel())];
+    }
+
+    [[noreturn]] void throw_invalid_encoding() {
+        throw std::invalid_argument{"Given string is not a valid base32 encoding"};
+    }
+}
+
+template <pinepp::base32_alphabet A>
+size_t pinepp::base32_blocks<A>::encode(const std::byte* src, size_t len, char* dst) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(src);
+    const auto consumed = active_kernels<A>().encode(bytes, len, dst);
+    return consumed + encode_scalar<A>(bytes + consumed, len - consumed, dst + consumed / 5 * 8);
+}
+
+template <pinepp::base32_alphabet A>
+size_t pinepp::base32_blocks<A>::encode_tail(const std::byte* src, size_t len, char* dst, bool pad) {
+    if (len == 0)
+        return 0;
+    uint8_t block[5]{};
+    for (size_t i = 0; i < len; ++i)
+        block[i] = static_cast<uint8_t>(src[i]);
+    char chars[8];
+    encode_scalar<A>(block, 5, chars);
+
+    // EVERY BYTE NEEDS 8 OF THE 5 BIT CHARACTERS, ROUNDED UP
+    const auto used = (len * 8 + 4) / 5;
+    std::copy_n(chars, used, dst);
+    if (!pad)
+        return used;
+    std::fill(dst + used, dst + 8, '=');
+    return 8;
+}
+
+template <pinepp::base32_alphabet A>
+size_t pinepp::base32_blocks<A>::decode(const char* src, size_t len, std::byte* dst) {
+    auto* bytes = reinterpret_cast<uint8_t*>(dst);
+    const auto consumed = active_kernels<A>().decode(src, len, bytes);
+    return consumed + decode_scalar<A>(src + consumed, len - consumed, bytes + consumed / 8 * 5);
+}
+
+template <pinepp::base32_alphabet A>
+size_t pinepp::base32_blocks<A>::decode_tail(const char* src, size_t len, std::byte* dst) {
+    if (len == 0)
+        return 0;
+    // ONLY A WHOLE BLOCK CAN BE PADDED
+    if (len == 8) {
+        while (len > 2 && src[len - 1] == '=')
+            len--;
+    }
+    constexpr size_t tail_bytes[9] = {0, 0, 1, 0, 2, 3, 0, 4, 5};
+    if (len > 8 || tail_bytes[len] == 0)
+        throw_invalid_encoding();
+
+    char chars[8]{'A', 'A', 'A', 'A', 'A', 'A', 'A', 'A'};
+    std::copy_n(src, len, chars);
+    if (A == base32_alphabet::HEX)
+        std::fill(chars + len, chars + 8, '0');
+    uint8_t block[5];
+    if (decode_scalar<A>(chars, 8, block) != 8)
+        throw_invalid_encoding();
+    std::copy_n(block, tail_bytes[len], reinterpret_cast<uint8_t*>(dst));
+    return tail_bytes[len];
+}
+
+template class pinepp::base32_blocks<pinepp::base32_alphabet::STANDARD>;
+template class pinepp::base32_blocks<pinepp::base32_alphabet::HEX>;
@@ -2,103 +2,1183 @@
 // Created by konstantin on 31.05.23.
 //
 
-#include <regex>
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <immintrin.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include "base64.hpp"
 
-std::string pinepp::base64_encode(const std::string& str) {
-    constexpr static char BASE64_TABLE[64] = {
+namespace {
+    using pinepp::base64_alphabet;
+    using pinepp::base64_kernel;
+
+    constexpr char BASE64_TABLE[64] = {
             'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P',
             'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z', 'a', 'b', 'c', 'd', 'e', 'f',
             'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v',
             'w', 'x', 'y', 'z', '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '+', '/'
     };
 
-    std::string rv{};
-    rv.reserve((size_t)((double)str.size() * 1.25));
-    const auto byte_count = str.size();
-    auto bytes_in_whole_blocks = 3 * (int)(byte_count / 3);
-
-    for (decltype(bytes_in_whole_blocks) i = 0; i < bytes_in_whole_blocks; i += 3) {
-        int i1 = (str[i] >> 2) & 63;
-        int i2 = ((str[i] << 4) & 48) | ((str[i + 1] >> 4) & 15);
-        int i3 = ((str[i + 1] << 2) & 60) | ((str[i + 2] >> 6) & 3);
-        int i4 = str[i + 2] & 63;
-        rv.push_back(BASE64_TABLE[i1]);
-        rv.push_back(BASE64_TABLE[i2]);
-        rv.push_back(BASE64_TABLE[i3]);
-        rv.push_back(BASE64_TABLE[i4]);
-    }
-
-    auto remaining_chars = byte_count - bytes_in_whole_blocks;
-    if (remaining_chars == 1) {
-        int i1 = (str[byte_count - 1] >> 2) & 63;
-        int i2 = 0 | ((str[byte_count - 1] << 4) & 48);
-        rv.push_back(BASE64_TABLE[i1]);
-        rv.push_back(BASE64_TABLE[i2]);
-        rv.push_back('=');
-        rv.push_back('=');
-    } else if (remaining_chars == 2) {
-        int i1 = (str[byte_count - 2] >> 2) & 63;
-        int i2 = ((str[byte_count - 2] << 4) & 48) | ((str[byte_count - 1] >> 4) & 15);
-        int i3 = 0 | ((str[byte_count - 1] << 2) & 60);
-        rv.push_back(BASE64_TABLE[i1]);
-        rv.push_back(BASE64_TABLE[i2]);
-        rv.push_back(BASE64_TABLE[i3]);
-        rv.push_back('=');
-    }
-
-    rv.shrink_to_fit();
-    return rv;
-}
-
-std::string pinepp::base64_decode(const std::string& base64) {
-
-    std::regex base64_pattern("^[A-Za-z0-9+/]+={0,2}$");
-    if (base64.size() % 4 != 0 || !std::regex_match(base64, base64_pattern)) {
-        if (base64.empty())
-            return std::string{};
+    /**
+     * @details All alphabets share the first 62 characters of the standard alphabet and only differ in the
+     * characters for the values 62 and 63.
+     */
+    constexpr std::array<char, 64> make_encode_table(base64_alphabet alphabet) {
+        std::array<char, 64> table{};
+        std::copy(std::begin(BASE64_TABLE), std::end(BASE64_TABLE), table.begin());
+        if (alphabet == base64_alphabet::URL) {
+            table[62] = '-';
+            table[63] = '_';
+        }
+        return table;
+    }
+
+    template <base64_alphabet A>
+    alignas(64) constexpr std::array<char, 64> ENCODE_TABLE = make_encode_table(A);
+
+    /**
+     * @details Maps every character to its value in the base64 alphabet or to 0x80 if it isn't part of it. Checking
+     * the high bit of a bitwise OR over a whole block validates all of its characters at once.
+     */
+    constexpr std::array<uint8_t, 256> make_decode_table(base64_alphabet alphabet) {
+        const auto encode_table = make_encode_table(alphabet);
+        std::array<uint8_t, 256> table{};
+        table.fill(0x80);
+        for (uint8_t i = 0; i < 64; ++i)
+            table[static_cast<uint8_t>(encode_table[i])] = i;
+        return table;
+    }
+
+    template <base64_alphabet A>
+    alignas(64) constexpr std::array<uint8_t, 256> DECODE_TABLE = make_decode_table(A);
+
+    template <base64_alphabet A>
+    inline uint8_t decode_char(char c) {
+        return DECODE_TABLE<A>[static_cast<uint8_t>(c)];
+    }
+
+    /**
+     * @details A kernel encodes as many whole 3 byte blocks of \p src as it can handle and returns the amount of
+     * bytes it consumed. Whatever is left over is encoded by the scalar code.
+     */
+    using encode_kernel = size_t (*)(const uint8_t* src, size_t len, char* dst);
+
+    /**
+     * @details A kernel decodes as many whole 4 character blocks of \p src as it can handle and returns the amount
+     * of characters it consumed. Kernels stop in front of the first block containing an invalid character and
+     * never write past the decoded data of the consumed characters.
+     */
+    using decode_kernel = size_t (*)(const char* src, size_t len, uint8_t* dst);
+
+    template <base64_alphabet A>
+    size_t encode_scalar(const uint8_t* src, size_t len, char* dst) {
+        const auto bytes_in_whole_blocks = 3 * (len / 3);
+        for (size_t i = 0; i < bytes_in_whole_blocks; i += 3) {
+            *dst++ = ENCODE_TABLE<A>[(src[i] >> 2) & 63];
+            *dst++ = ENCODE_TABLE<A>[((src[i] << 4) & 48) | ((src[i + 1] >> 4) & 15)];
+            *dst++ = ENCODE_TABLE<A>[((src[i + 1] << 2) & 60) | ((src[i + 2] >> 6) & 3)];
+            *dst++ = ENCODE_TABLE<A>[src[i + 2] & 63];
+        }
+        return bytes_in_whole_blocks;
+    }
+
+    template <base64_alphabet A>
+    size_t decode_scalar(const char* src, size_t len, uint8_t* dst) {
+        const auto chars_in_whole_blocks = 4 * (len / 4);
+        for (size_t i = 0; i < chars_in_whole_blocks; i += 4) {
+            const uint8_t idx[4] = {decode_char<A>(src[i]), decode_char<A>(src[i + 1]),
+                                    decode_char<A>(src[i + 2]), decode_char<A>(src[i + 3])};
+            if ((idx[0] | idx[1] | idx[2] | idx[3]) & 0x80)
+                return i;
+            *dst++ = static_cast<uint8_t>(((idx[0] << 2) & 252) | ((idx[1] >> 4) & 3));
+            *dst++ = static_cast<uint8_t>(((idx[1] << 4) & 0xf0) | ((idx[2] >> 2) & 0x0f));
+            *dst++ = static_cast<uint8_t>(((idx[2] << 6) & 192) | (idx[3] & 63));
+        }
+        return chars_in_whole_blocks;
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    // SSE4.1 AND AVX2 KERNELS FOLLOW W. MULA AND D. LEMIRE, "FASTER BASE64 ENCODING AND DECODING USING AVX2
+    // INSTRUCTIONS". EACH 128 BIT LANE TURNS 12 BYTES INTO 16 CHARACTERS AND VICE VERSA.
+
+    /**
+     * @details Lookup tables of the pshufb based decoder. A character is valid iff the classes of its low and high
+     * nibble don't share a bit. Its value is the character plus the offset of its high nibble, except for one
+     * special character whose offset differs from the rest of its high nibble and is stored 8 entries further.
+     */
+    struct decode_luts {
+        alignas(16) std::array<int8_t, 16> lo{};
+        alignas(16) std::array<int8_t, 16> hi{};
+        alignas(16) std::array<int8_t, 16> roll{};
+        char special{};
+    };
+
+    constexpr decode_luts make_decode_luts(base64_alphabet alphabet) {
+        const auto decode_table = make_decode_table(alphabet);
+        decode_luts luts{};
+        // HIGH NIBBLES 0, 1 AND 8 TO 15 NEVER CONTAIN VALID CHARACTERS
+        for (int h = 0; h < 16; ++h)
+            luts.hi[h] = h >= 2 && h <= 7 ? static_cast<int8_t>(1 << (h - 2)) : 0x40;
+        for (int l = 0; l < 16; ++l) {
+            luts.lo[l] = 0x40;
+            for (int h = 2; h <= 7; ++h) {
+                if (decode_table[h << 4 | l] & 0x80)
+                    luts.lo[l] = static_cast<int8_t>(luts.lo[l] | 1 << (h - 2));
+            }
+        }
+        for (int h = 2; h <= 7; ++h) {
+            int offsets[16]{};
+            int count[16]{};
+            int distinct = 0;
+            for (int l = 0; l < 16; ++l) {
+                const auto value = decode_table[h << 4 | l];
+                if (value & 0x80)
+                    continue;
+                const int offset = value - (h << 4 | l);
+                int k = 0;
+                while (k < distinct && offsets[k] != offset)
+                    ++k;
+                if (k == distinct)
+                    offsets[distinct++] = offset;
+                count[k]++;
+            }
+            if (distinct == 0)
+                continue;
+            luts.roll[h] = static_cast<int8_t>(offsets[0]);
+            if (distinct == 2) {
+                if (luts.special != 0 || (count[0] != 1 && count[1] != 1))
+                    throw std::logic_error{"Alphabet can't be decoded with the pshufb kernels"};
+                const int single = count[0] == 1 ? 0 : 1;
+                luts.roll[h] = static_cast<int8_t>(offsets[1 - single]);
+                luts.roll[h + 8] = static_cast<int8_t>(offsets[single]);
+                for (int l = 0; l < 16; ++l) {
+                    const auto value = decode_table[h << 4 | l];
+                    if (!(value & 0x80) && value - (h << 4 | l) == offsets[single])
+                        luts.special = static_cast<char>(h << 4 | l);
+                }
+            } else if (distinct > 2) {
+                throw std::logic_error{"Alphabet can't be decoded with the pshufb kernels"};
+            }
+        }
+        return luts;
+    }
+
+    template <base64_alphabet A>
+    constexpr decode_luts DECODE_LUTS = make_decode_luts(A);
+
+    /**
+     * @details Maps 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12 and uses the result to look up
+     * the offset from each value to its character.
+     */
+    template <base64_alphabet A>
+    constexpr std::array<int8_t, 16> ENCODE_OFFSETS = {
+            'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            '0' - 52, '0' - 52, '0' - 52, static_cast<int8_t>(ENCODE_TABLE<A>[62] - 62),
+            static_cast<int8_t>(ENCODE_TABLE<A>[63] - 63), 'A', 0, 0
+    };
+
+    template <base64_alphabet A>
+    __attribute__((target("sse4.1")))
+    inline __m128i encode_lane_sse41(__m128i in) {
+        in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+        const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+        const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+        const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+        const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+        const __m128i indices = _mm_or_si128(t1, t3);
+
+        __m128i offset_idx = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+        const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+        offset_idx = _mm_or_si128(offset_idx, _mm_and_si128(less, _mm_set1_epi8(13)));
+        const __m128i offsets = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ENCODE_OFFSETS<A>.data()));
+        return _mm_add_epi8(_mm_shuffle_epi8(offsets, offset_idx), indices);
+    }
+
+    template <base64_alphabet A>
+    __attribute__((target("sse4.1")))
+    size_t encode_sse41(const uint8_t* src, size_t len, char* dst) {
+        size_t i = 0;
+        // EACH ITERATION LOADS 16 BYTES BUT ONLY CONSUMES 12
+        for (; i + 16 <= len; i += 12, dst += 16) {
+            const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), encode_lane_sse41<A>(in));
+        }
+        return i;
+    }
+
+    /**
+     * @details Like encode_sse41, but also encodes the whole blocks of the last 16 bytes by copying them into a lane
+     * of their own. Used for small inputs, where these blocks would be most of the work of the scalar code.
+     */
+    template <base64_alphabet A>
+    __attribute__((target("sse4.1")))
+    size_t encode_sse41_small(const uint8_t* src, size_t len, char* dst) {
+        auto i = encode_sse41<A>(src, len, dst);
+        dst += i / 3 * 4;
+        while (len - i >= 3) {
+            const auto bytes = std::min(len - i, size_t{12}) / 3 * 3;
+            alignas(16) uint8_t lane[16]{};
+            alignas(16) char chars[16];
+            std::memcpy(lane, src + i, bytes);
+            _mm_store_si128(reinterpret_cast<__m128i*>(chars), encode_lane_sse41<A>(_mm_load_si128(
+                    reinterpret_cast<const __m128i*>(lane))));
+            std::memcpy(dst, chars, bytes / 3 * 4);
+            i += bytes;
+            dst += bytes / 3 * 4;
+        }
+        return i;
+    }
+
+    template <base64_alphabet A>
+    __attribute__((target("avx2")))
+    inline __m256i encode_lanes_avx2(__m256i in) {
+        in = _mm256_shuffle_epi8(in, _mm256_set_epi8(
+                10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+                10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+        const __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+        const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        const __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+        const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        const __m256i indices = _mm256_or_si256(t1, t3);
+
+        __m256i offset_idx = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        const __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+        offset_idx = _mm256_or_si256(offset_idx, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+        const __m256i offsets = _mm256_broadcastsi128_si256(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ENCODE_OFFSETS<A>.data())));
+        return _mm256_add_epi8(_mm256_shuffle_epi8(offsets, offset_idx), indices);
+    }
+
+    template <base64_alphabet A>
+    __attribute__((target("avx2")))
+    size_t encode_avx2(const uint8_t* src, size_t len, char* dst) {
+        size_t i = 0;
+        // EACH ITERATION LOADS 28 BYTES BUT ONLY CONSUMES 24
+        for (; i + 28 <= len; i += 24, dst += 32) {
+            const __m256i in = _mm256_inserti128_si256(
+                    _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i))),
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 12)), 1);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), encode_lanes_avx2<A>(in));
+        }
+        return i;
+    }
+
+    template <base64_alphabet A>
+    __attribute__((target("sse4.1")))
+    inline bool decode_lane_sse41(__m128i& str) {
+        constexpr auto& luts = DECODE_LUTS<A>;
+        const __m128i lut_lo = _mm_load_si128(reinterpret_cast<const __m128i*>(luts.lo.data()));
+        const __m128i lut_hi = _mm_load_si128(reinterpret_cast<const __m128i*>(luts.hi.data()));
+        const __m128i lut_roll = _mm_load_si128(reinterpret_cast<const __m128i*>(luts.roll.data()));
+        const __m128i mask_2f = _mm_set1_epi8(0x2f);
+
+        const __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(str, 4), mask_2f);
+        const __m128i lo_nibbles = _mm_and_si128(str, mask_2f);
+        const __m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+        const __m128i lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+        if (!_mm_testz_si128(lo, hi))
+            return false;
+
+        const __m128i is_special = _mm_cmpeq_epi8(str, _mm_set1_epi8(luts.special));
+        const __m128i roll_idx = _mm_add_epi8(hi_nibbles, _mm_and_si128(is_special, _mm_set1_epi8(8)));
+        str = _mm_add_epi8(str, _mm_shuffle_epi8(lut_roll, roll_idx));
+
+        const __m128i merged = _mm_madd_epi16(
+                _mm_maddubs_epi16(str, _mm_set1_epi32(0x01400140)), _mm_set1_epi32(0x00011000));
+        str = _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        return true;
+    }
+
+    template <base64_alphabet A>
+    __attribute__((target("sse4.1")))
+    size_t decode_sse41(const char* src, size_t len, uint8_t* dst) {
+        size_t i = 0;
+        for (; i + 16 <= len; i += 16, dst += 12) {
+            __m128i str = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            if (!decode_lane_sse41<A>(str))
+                break;
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), str);
+            const auto upper = static_cast<uint32_t>(_mm_extract_epi32(str, 2));
+            std::memcpy(dst + 8, &upper, 4);
+        }
+        return i;
+    }
+
+    template <base64_alphabet A>
+    __attribute__((target("avx2")))
+    inline bool decode_lanes_avx2(__m256i& str) {
+        constexpr auto& luts = DECODE_LUTS<A>;
+        const __m256i lut_lo = _mm256_broadcastsi128_si256(
+                _mm_load_si128(reinterpret_cast<const __m128i*>(luts.lo.data())));
+        const __m256i lut_hi = _mm256_broadcastsi128_si256(
+                _mm_load_si128(reinterpret_cast<const __m128i*>(luts.hi.data())));
+        const __m256i lut_roll = _mm256_broadcastsi128_si256(
+                _mm_load_si128(reinterpret_cast<const __m128i*>(luts.roll.data())));
+        const __m256i mask_2f = _mm256_set1_epi8(0x2f);
+
+        const __m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(str, 4), mask_2f);
+        const __m256i lo_nibbles = _mm256_and_si256(str, mask_2f);
+        const __m256i hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+        const __m256i lo = _mm256_shuffle_epi8(lut_lo, lo_nibbles);
+        if (!_mm256_testz_si256(lo, hi))
+            return false;
+
+        const __m256i is_special = _mm256_cmpeq_epi8(str, _mm256_set1_epi8(luts.special));
+        const __m256i roll_idx = _mm256_add_epi8(hi_nibbles, _mm256_and_si256(is_special, _mm256_set1_epi8(8)));
+        str = _mm256_add_epi8(str, _mm256_shuffle_epi8(lut_roll, roll_idx));
+
+        const __m256i merged = _mm256_madd_epi16(
+                _mm256_maddubs_epi16(str, _mm256_set1_epi32(0x01400140)), _mm256_set1_epi32(0x00011000));
+        str = _mm256_shuffle_epi8(merged, _mm256_setr_epi8(
+                2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        // MOVE THE 12 BYTES OF THE UPPER LANE RIGHT BEHIND THE 12 BYTES OF THE LOWER LANE
+        str = _mm256_permutevar8x32_epi32(str, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+        return true;
+    }
+
+    template <base64_alphabet A>
+    __attribute__((target("avx2")))
+    size_t decode_avx2(const char* src, size_t len, uint8_t* dst) {
+        size_t i = 0;
+        for (; i + 32 <= len; i += 32, dst += 24) {
+            __m256i str = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            if (!decode_lanes_avx2<A>(str))
+                break;
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm256_castsi256_si128(str));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + 16), _mm256_extracti128_si256(str, 1));
+        }
+        return i;
+    }
+
+    // AVX-512 KERNELS REQUIRE VBMI AND FOLLOW W. MULA AND D. LEMIRE, "BASE64 ENCODING AND DECODING AT ALMOST THE
+    // SPEED OF A MEMORY COPY". EACH ITERATION TURNS 48 BYTES INTO 64 CHARACTERS AND VICE VERSA.
+
+    constexpr uint64_t AVX512_BLOCK_MASK = 0x0000ffffffffffff;
+    // THE MASKED FORMS ARE USED WITH A FULL MASK BECAUSE GCC WARNS ABOUT THE UNDEFINED SOURCE OF THE UNMASKED ONES
+    constexpr uint64_t AVX512_FULL_MASK = ~uint64_t{0};
+
+    template <base64_alphabet A>
+    __attribute__((target("avx512f,avx512bw,avx512vbmi")))
+    size_t encode_avx512(const uint8_t* src, size_t len, char* dst) {
+        const __m512i shuffle_input = _mm512_setr_epi32(
+                0x01020001, 0x04050304, 0x07080607, 0x0a0b090a, 0x0d0e0c0d, 0x10110f10, 0x13141213, 0x16171516,
+                0x191a1819, 0x1c1d1b1c, 0x1f201e1f, 0x22232122, 0x25262425, 0x28292728, 0x2b2c2a2b, 0x2e2f2d2e);
+        const __m512i shifts = _mm512_set1_epi64(0x3036242a1016040a);
+        const __m512i lookup = _mm512_load_si512(ENCODE_TABLE<A>.data());
+
+        size_t i = 0;
+        for (; i + 48 <= len; i += 48, dst += 64) {
+            const __m512i v = _mm512_maskz_loadu_epi8(AVX512_BLOCK_MASK, src + i);
+            const __m512i in = _mm512_maskz_permutexvar_epi8(AVX512_FULL_MASK, shuffle_input, v);
+            const __m512i indices = _mm512_maskz_multishift_epi64_epi8(AVX512_FULL_MASK, shifts, in);
+            _mm512_storeu_si512(dst, _mm512_maskz_permutexvar_epi8(AVX512_FULL_MASK, indices, lookup));
+        }
+        return i;
+    }
+
+    template <base64_alphabet A>
+    __attribute__((target("avx512f,avx512bw,avx512vbmi")))
+    size_t decode_avx512(const char* src, size_t len, uint8_t* dst) {
+        const __m512i lookup_0 = _mm512_load_si512(DECODE_TABLE<A>.data());
+        const __m512i lookup_1 = _mm512_load_si512(DECODE_TABLE<A>.data() + 64);
+        const __m512i pack = _mm512_setr_epi32(
+                0x06000102, 0x090a0405, 0x0c0d0e08, 0x16101112, 0x191a1415, 0x1c1d1e18, 0x26202122, 0x292a2425,
+                0x2c2d2e28, 0x36303132, 0x393a3435, 0x3c3d3e38, 0, 0, 0, 0);
+
+        size_t i = 0;
+        for (; i + 64 <= len; i += 64, dst += 48) {
+            const __m512i in = _mm512_loadu_si512(src + i);
+            const __m512i translated = _mm512_permutex2var_epi8(lookup_0, in, lookup_1);
+            // THE PERMUTATION ONLY LOOKS AT 7 BITS, SO NON-ASCII INPUT HAS TO BE CAUGHT BY ITS OWN SIGN BIT
+            if (_mm512_movepi8_mask(_mm512_or_si512(translated, in)) != 0)
+                break;
+            const __m512i merged = _mm512_madd_epi16(
+                    _mm512_maddubs_epi16(translated, _mm512_set1_epi32(0x01400140)),
+                    _mm512_set1_epi32(0x00011000));
+            _mm512_mask_storeu_epi8(dst, AVX512_BLOCK_MASK,
+                                    _mm512_maskz_permutexvar_epi8(AVX512_BLOCK_MASK, pack, merged));
+        }
+        return i;
+    }
+#endif
+
+    struct kernels {
+        encode_kernel encode;
+        decode_kernel decode;
+    };
+
+    bool is_supported(base64_kernel kind) {
+#if defined(__x86_64__) || defined(__i386__)
+        switch (kind) {
+            case base64_kernel::SCALAR:
+                return true;
+            case base64_kernel::SSE41:
+                return __builtin_cpu_supports("sse4.1");
+            case base64_kernel::AVX2:
+                return __builtin_cpu_supports("avx2");
+            case base64_kernel::AVX512:
+                return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+                       __builtin_cpu_supports("avx512vbmi");
+        }
+        return false;
+#else
+        return kind == base64_kernel::SCALAR;
+#endif
+    }
+
+    template <base64_alphabet A>
+    constexpr kernels make_kernels(base64_kernel kind) {
+        switch (kind) {
+#if defined(__x86_64__) || defined(__i386__)
+            case base64_kernel::AVX512:
+                return {encode_avx512<A>, decode_avx512<A>};
+            case base64_kernel::AVX2:
+                return {encode_avx2<A>, decode_avx2<A>};
+            case base64_kernel::SSE41:
+                return {encode_sse41<A>, decode_sse41<A>};
+#endif
+            default:
+                return {encode_scalar<A>, decode_scalar<A>};
+        }
+    }
+
+    /**
+     * @details Every alphabet has its own set of kernels, indexed by base64_kernel.
+     */
+    template <base64_alphabet A>
+    constexpr kernels KERNELS[4] = {
+            make_kernels<A>(base64_kernel::SCALAR), make_kernels<A>(base64_kernel::SSE41),
+            make_kernels<A>(base64_kernel::AVX2), make_kernels<A>(base64_kernel::AVX512)
+    };
+
+    /**
+     * @details The kernel in use. Resolved once by CPUID on first use, picking the widest supported instruction set.
+     */
+    base64_kernel& active_kind() {
+        static base64_kernel active = [] {
+            for (auto kind : {base64_kernel::AVX512, base64_kernel::AVX2, base64_kernel::SSE41}) {
+                if (is_supported(kind))
+                    return kind;
+            }
+            return base64_kernel::SCALAR;
+        }();
+        return active;
+    }
+
+    template <base64_alphabet A>
+    const kernels& active_kernels() {
+        return KERNELS<A>[static_cast<size_t>(active_kind())];
+    }
+
+    [[noreturn]] void throw_invalid_encoding() {
         throw std::invalid_argument{"Given string is not a valid base64 encoding"};
     }
 
+    /**
+     * @returns The amount of padding characters at the end of the 4 character block \p src
+     */
+    int padding_length(const char* src) {
+        if (src[3] != '=')
+            return 0;
+        return src[2] == '=' ? 2 : 1;
+    }
+
+    /**
+     * @brief A fixed set of worker threads executing the tasks of one job at a time
+     * @details The thread submitting a job works on its tasks as well and returns once all of them are done.
+     * Concurrent jobs are executed one after another.
+     */
+    class thread_pool {
+    public:
+        explicit thread_pool(unsigned workers) {
+            for (unsigned i = 0; i < workers; ++i)
+                m_Workers.emplace_back([this] { work(); });
+        }
+
+        ~thread_pool() {
+            {
+                std::lock_guard lock{m_Mutex};
+                m_Stop = true;
+            }
+            m_Wake.notify_all();
+            for (auto& worker : m_Workers)
+                worker.join();
+        }
+
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+
+        [[nodiscard]] unsigned size() const {
+            return static_cast<unsigned>(m_Workers.size()) + 1;
+        }
+
+        /**
+         * @details Calls \p task with every index in [0, tasks) and waits until all calls returned.
+         */
+        void run(size_t tasks, const std::function<void(size_t)>& task) {
+            std::lock_guard job_lock{m_JobMutex};
+            std::unique_lock lock{m_Mutex};
+            m_Task = &task;
+            m_Tasks = tasks;
+            m_Next = 0;
+            m_Pending = tasks;
+            ++m_Generation;
+            m_Wake.notify_all();
+            execute(lock);
+            m_Done.wait(lock, [this] { return m_Pending == 0; });
+        }
+
+    private:
+        void work() {
+            std::unique_lock lock{m_Mutex};
+            uint64_t seen = 0;
+            while (true) {
+                m_Wake.wait(lock, [&] { return m_Stop || m_Generation != seen; });
+                if (m_Stop)
+                    return;
+                seen = m_Generation;
+                execute(lock);
+            }
+        }
+
+        // TASKS ARE CLAIMED UNDER THE LOCK. THERE ARE ONLY A FEW OF THEM PER JOB, EACH WORTH MANY KILOBYTES.
+        void execute(std::unique_lock<std::mutex>& lock) {
+            while (m_Next < m_Tasks) {
+                const auto index = m_Next++;
+                const auto* task = m_Task;
+                lock.unlock();
+                (*task)(index);
+                lock.lock();
+                if (--m_Pending == 0)
+                    m_Done.notify_all();
+            }
+        }
+
+        std::vector<std::thread> m_Workers;
+        std::mutex m_JobMutex;
+        std::mutex m_Mutex;
+        std::condition_variable m_Wake;
+        std::condition_variable m_Done;
+        const std::function<void(size_t)>* m_Task{nullptr};
+        size_t m_Tasks{0};
+        size_t m_Next{0};
+        size_t m_Pending{0};
+        uint64_t m_Generation{0};
+        bool m_Stop{false};
+    };
+
+    /**
+     * @details The pool is only started by the first input large enough to be split.
+     */
+    thread_pool& shared_pool() {
+        static thread_pool pool{std::max(std::thread::hardware_concurrency(), 1u) - 1};
+        return pool;
+    }
+
+    struct parallel_settings {
+        size_t threshold{std::numeric_limits<size_t>::max()};
+        unsigned threads{0};
+    };
+
+    parallel_settings& parallelism() {
+        static parallel_settings settings;
+        return settings;
+    }
+
+    // CHUNK BOUNDARIES ARE MULTIPLES OF 64 BLOCKS, SO EVERY CHUNK STARTS ON A CACHE LINE OF THE ENCODED SIDE
+    constexpr size_t CHUNK_BLOCKS = 64;
+
+    /**
+     * @details Splits \p len bytes or characters, made up of blocks of \p block_size, into one chunk per thread
+     * of the parallel mode. The pool runs at most one chunk per hardware thread at a time.
+     * @returns The size of each chunk but the last, or 0 if the input should be processed by the calling thread
+     */
+    size_t parallel_chunk_size(size_t len, size_t block_size) {
+        const auto& settings = parallelism();
+        if (len < settings.threshold)
+            return 0;
+        const size_t threads = settings.threads != 0 ? settings.threads : shared_pool().size();
+        const auto alignment = CHUNK_BLOCKS * block_size;
+        const auto chunk = (len / threads + alignment - 1) / alignment * alignment;
+        return threads > 1 && chunk < len ? chunk : 0;
+    }
+
+    template <base64_alphabet A>
+    size_t encode_serial(const uint8_t* src, size_t len, char* dst) {
+        const auto consumed = active_kernels<A>().encode(src, len, dst);
+        return consumed + encode_scalar<A>(src + consumed, len - consumed, dst + consumed / 3 * 4);
+    }
+
+    /**
+     * @details Base64 alphabets only contain characters above the space, so runs of characters are separated by
+     * bytes up to 0x20. Only some of them are whitespace.
+     */
+    inline bool is_separator(char c) {
+        return static_cast<uint8_t>(c) <= 0x20;
+    }
+
+    inline bool is_whitespace(char c) {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f';
+    }
+
+    /**
+     * @returns The index of the first separator in \p src or \p len if there is none
+     */
+    size_t find_separator(const char* src, size_t len) {
+        size_t i = 0;
+#if defined(__SSE2__)
+        const __m128i space = _mm_set1_epi8(0x20);
+        for (; i + 16 <= len; i += 16) {
+            const __m128i str = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            const auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(str, space), str)));
+            if (mask != 0)
+                return i + static_cast<size_t>(__builtin_ctz(mask));
+        }
+#endif
+        while (i < len && !is_separator(src[i]))
+            ++i;
+        return i;
+    }
+
+    /**
+     * @returns The amount of characters in \p src that aren't separators
+     */
+    size_t count_non_separators(const char* src, size_t len) {
+        size_t i = 0;
+        size_t count = 0;
+#if defined(__SSE2__)
+        const __m128i space = _mm_set1_epi8(0x20);
+        while (i + 16 <= len) {
+            // EVERY SEPARATOR SUBTRACTS ONE FROM ITS BYTE OF THE ACCUMULATOR, WHICH IS SUMMED UP BEFORE IT CAN WRAP
+            __m128i separators = _mm_setzero_si128();
+            for (size_t j = 0; j < 255 && i + 16 <= len; ++j, i += 16) {
+                const __m128i str = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                separators = _mm_sub_epi8(separators, _mm_cmpeq_epi8(_mm_min_epu8(str, space), str));
+                count += 16;
+            }
+            const __m128i sums = _mm_sad_epu8(separators, _mm_setzero_si128());
+            count -= static_cast<size_t>(_mm_cvtsi128_si32(sums) + _mm_extract_epi16(sums, 4));
+        }
+#endif
+        for (; i < len; ++i)
+            count += !is_separator(src[i]);
+        return count;
+    }
+
+    template <base64_alphabet A>
+    size_t decode_serial(const char* src, size_t len, uint8_t* dst) {
+        const auto consumed = active_kernels<A>().decode(src, len, dst);
+        return consumed + decode_scalar<A>(src + consumed, len - consumed, dst + consumed / 4 * 3);
+    }
+}
+
+pinepp::base64_kernel pinepp::base64_active_kernel() {
+    return active_kind();
+}
+
+bool pinepp::base64_select_kernel(base64_kernel kernel) {
+    if (!is_supported(kernel))
+        return false;
+    active_kind() = kernel;
+    return true;
+}
 
-    const auto char_count = base64.size();
-    int padding_len = 0;
-    if (base64[char_count - 1] == '=')
-        padding_len++;
-    if (base64[char_count - 2] == '=')
-        padding_len++;
-
-    std::string rv{};
-    rv.reserve((size_t)((double)base64.size() * 0.75));
-    uint8_t idx[4];
-    for (auto i = decltype(char_count){0}; i < char_count; i += 4) {
-        for (int j = 0; j < 4; ++j) {
-            if (base64[i + j] >= 'A' && base64[i + j] <= 'Z')
-                idx[j] = base64[i + j] - 'A';
-            else if (base64[i + j] >= 'a' && base64[i + j] <= 'z')
-                idx[j] = base64[i + j] - 'a' + 26;
-            else if (base64[i + j] >= '0' && base64[i + j] <= '9')
-                idx[j] = base64[i + j] - '0' + 52;
-            else if (base64[i + j] == '+')
-                idx[j] = 62;
-            else if (base64[i + j] == '/')
-                idx[j] = 63;
-            else
-                idx[j] = -1;
-        }
-
-        auto c1 = static_cast<char>(((idx[0] << 2) & 252) | ((idx[1] >> 4) & 3));
-        rv.push_back(c1);
-        if (i != char_count - 4 || (i == char_count - 4 && padding_len <= 1)) {
-            auto c2 = static_cast<char>(((idx[1] << 4) & 0xf0) | ((idx[2] >> 2) & 0x0f));
-            rv.push_back(c2);
-        }
-        if (i != char_count - 4 || (i == char_count - 4 && padding_len == 0)) {
-            auto c3 = static_cast<char>(((idx[2] << 6) & 192) | (idx[3] & 63));
-            rv.push_back(c3);
-        }
-    }
-
-    rv.shrink_to_fit();
-    return rv;
-}
\ No newline at end of file
+void pinepp::base64_set_parallelism(size_t threshold, unsigned threads) {
+    parallelism() = {threshold, threads};
+}
+
+size_t pinepp::base64_parallel_threshold() {
+    return parallelism().threshold;
+}
+
+template <pinepp::base64_alphabet A>
+size_t pinepp::base64_blocks<A>::encode(const std::byte* src, size_t len, char* dst) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(src);
+    const auto chunk = parallel_chunk_size(len, 3);
+    if (chunk == 0)
+        return encode_serial<A>(bytes, len, dst);
+
+    const auto chunks = (len + chunk - 1) / chunk;
+    shared_pool().run(chunks, [&](size_t i) {
+        const auto begin = i * chunk;
+        encode_serial<A>(bytes + begin, std::min(chunk, len - begin), dst + begin / 3 * 4);
+    });
+    return len / 3 * 3;
+}
+
+template <pinepp::base64_alphabet A>
+size_t pinepp::base64_blocks<A>::encode_tail(const std::byte* src, size_t len, char* dst, bool pad) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(src);
+    if (len == 1) {
+        dst[0] = ENCODE_TABLE<A>[(bytes[0] >> 2) & 63];
+        dst[1] = ENCODE_TABLE<A>[(bytes[0] << 4) & 48];
+        if (!pad)
+            return 2;
+        dst[2] = '=';
+        dst[3] = '=';
+        return 4;
+    } else if (len == 2) {
+        dst[0] = ENCODE_TABLE<A>[(bytes[0] >> 2) & 63];
+        dst[1] = ENCODE_TABLE<A>[((bytes[0] << 4) & 48) | ((bytes[1] >> 4) & 15)];
+        dst[2] = ENCODE_TABLE<A>[(bytes[1] << 2) & 60];
+        if (!pad)
+            return 3;
+        dst[3] = '=';
+        return 4;
+    }
+    return 0;
+}
+
+template <pinepp::base64_alphabet A>
+size_t pinepp::base64_blocks<A>::decode(const char* src, size_t len, std::byte* dst) {
+    auto* bytes = reinterpret_cast<uint8_t*>(dst);
+    const auto chunk = parallel_chunk_size(len, 4);
+    if (chunk == 0)
+        return decode_serial<A>(src, len, bytes);
+
+    // DECODING STOPS IN FRONT OF THE FIRST BLOCK ANY CHUNK STOPPED AT
+    const auto chunks = (len + chunk - 1) / chunk;
+    std::vector<size_t> consumed(chunks);
+    shared_pool().run(chunks, [&](size_t i) {
+        const auto begin = i * chunk;
+        consumed[i] = decode_serial<A>(src + begin, std::min(chunk, len - begin), bytes + begin / 4 * 3);
+    });
+    for (size_t i = 0; i < chunks; ++i) {
+        if (consumed[i] != std::min(chunk, len - i * chunk))
+            return i * chunk + consumed[i];
+    }
+    return len / 4 * 4;
+}
+
+template <pinepp::base64_alphabet A>
+size_t pinepp::base64_blocks<A>::decode_tail(const char* src, size_t len, std::byte* dst) {
+    if (len == 0)
+        return 0;
+    // ONLY A WHOLE BLOCK CAN BE PADDED
+    if (len == 4)
+        len -= padding_length(src);
+    if (len < 2 || len > 4)
+        throw_invalid_encoding();
+
+    uint8_t idx[4]{};
+    for (size_t j = 0; j < len; ++j) {
+        idx[j] = decode_char<A>(src[j]);
+        if (idx[j] & 0x80)
+            throw_invalid_encoding();
+    }
+    auto* bytes = reinterpret_cast<uint8_t*>(dst);
+    bytes[0] = static_cast<uint8_t>(((idx[0] << 2) & 252) | ((idx[1] >> 4) & 3));
+    if (len >= 3)
+        bytes[1] = static_cast<uint8_t>(((idx[1] << 4) & 0xf0) | ((idx[2] >> 2) & 0x0f));
+    if (len == 4)
+        bytes[2] = static_cast<uint8_t>(((idx[2] << 6) & 192) | (idx[3] & 63));
+    return len - 1;
+}
+
+template <pinepp::base64_alphabet A>
+size_t pinepp::base64_blocks<A>::decode_lenient(std::string_view src, std::span<std::byte> dst,
+                                                base64_padding padding) {
+    const char* it = src.data();
+    const char* const end = it + src.size();
+    std::byte* out = dst.data();
+    std::byte* const out_end = out + dst.size();
+    char carry[4]{};
+    size_t carry_len = 0;
+    bool finished = false;
+
+    const auto write = [&](const std::byte* bytes, size_t n) {
+        if (static_cast<size_t>(out_end - out) < n)
+            throw std::invalid_argument{"Destination buffer is too small for the decoded base64"};
+        out = std::copy_n(bytes, n, out);
+    };
+    // DECODES A BLOCK THE KERNELS DIDN'T TAKE, EITHER BECAUSE IT IS SPLIT BY WHITESPACE, THE LAST ONE OR FOR LACK OF
+    // SPACE
+    const auto decode_block = [&](const char* block, size_t len) {
+        std::byte bytes[3];
+        if (len == 4 && decode_serial<A>(block, 4, reinterpret_cast<uint8_t*>(bytes)) == 4)
+            return write(bytes, 3);
+        if (padding == base64_padding::NONE && std::find(block, block + len, '=') != block + len)
+            throw_invalid_encoding();
+        write(bytes, decode_tail(block, len, bytes));
+        finished = true;
+    };
+
+    while (it < end) {
+        const char* const run_end = it + find_separator(it, static_cast<size_t>(end - it));
+        if (finished && it < run_end)
+            throw_invalid_encoding();
+
+        // COMPLETE THE BLOCK CARRIED OVER FROM THE LAST RUN
+        if (carry_len > 0) {
+            while (carry_len < 4 && it < run_end)
+                carry[carry_len++] = *it++;
+            if (carry_len == 4) {
+                carry_len = 0;
+                decode_block(carry, 4);
+            }
+        }
+
+        // THE WHOLE BLOCKS OF THE RUN ARE DECODED IN PLACE
+        while (!finished && run_end - it >= 4) {
+            const auto capacity = static_cast<size_t>(out_end - out) / 3 * 4;
+            const auto chars = std::min(static_cast<size_t>(run_end - it) / 4 * 4, capacity);
+            const auto consumed = decode_serial<A>(it, chars, reinterpret_cast<uint8_t*>(out));
+            out += consumed / 4 * 3;
+            it += consumed;
+            if (consumed == chars && chars > 0)
+                continue;
+            decode_block(it, 4);
+            it += 4;
+        }
+        if (finished && it < run_end)
+            throw_invalid_encoding();
+        while (it < run_end)
+            carry[carry_len++] = *it++;
+
+        for (; it < end && is_separator(*it); ++it) {
+            if (!is_whitespace(*it))
+                throw_invalid_encoding();
+        }
+    }
+
+    if (carry_len > 0) {
+        if (padding == base64_padding::REQUIRED)
+            throw_invalid_encoding();
+        decode_block(carry, carry_len);
+    }
+    return static_cast<size_t>(out - dst.data());
+}
+
+namespace {
+    // INPUTS BELOW THIS SIZE ARE ENCODED BY THE SSE4.1 KERNEL IN A BATCH
+    constexpr size_t SMALL_INPUT = 256;
+}
+
+template <pinepp::base64_alphabet A>
+size_t pinepp::base64_blocks<A>::encode_batch(const std::string_view* inputs, size_t count, char* dst, bool pad) {
+    const auto encode = active_kernels<A>().encode;
+    // THE WIDER KERNELS SPEND MORE TIME SETTING UP THAN ENCODING WHEN INPUTS ARE ONLY A FEW DOZEN BYTES LONG
+    auto encode_small = encode;
+#if defined(__x86_64__) || defined(__i386__)
+    if (active_kind() != base64_kernel::SCALAR)
+        encode_small = encode_sse41_small<A>;
+#endif
+    const char* const begin = dst;
+    for (size_t i = 0; i < count; ++i) {
+        const auto* src = reinterpret_cast<const uint8_t*>(inputs[i].data());
+        const auto len = inputs[i].size();
+        auto consumed = (len < SMALL_INPUT ? encode_small : encode)(src, len, dst);
+        consumed += encode_scalar<A>(src + consumed, len - consumed, dst + consumed / 3 * 4);
+        dst += consumed / 3 * 4;
+        dst += encode_tail(reinterpret_cast<const std::byte*>(src + consumed), len - consumed, dst, pad);
+    }
+    return static_cast<size_t>(dst - begin);
+}
+
+template class pinepp::base64_blocks<pinepp::base64_alphabet::STANDARD>;
+template class pinepp::base64_blocks<pinepp::base64_alphabet::URL>;
+
+size_t pinepp::base64_decoded_size(std::string_view base64) {
+    return base64::decoded_size(base64);
+}
+
+size_t pinepp::base64_decoded_size_lenient(std::string_view base64, base64_padding padding) {
+    const auto chars = count_non_separators(base64.data(), base64.size());
+    if (chars % 4 == 1 || (padding == base64_padding::REQUIRED && chars % 4 != 0))
+        throw_invalid_encoding();
+
+    size_t padding_chars = 0;
+    if (padding != base64_padding::NONE && chars % 4 == 0) {
+        for (auto it = base64.rbegin(); it != base64.rend() && padding_chars < 2; ++it) {
+            if (*it == '=')
+                padding_chars++;
+            else if (!is_separator(*it))
+                break;
+        }
+    }
+    return chars / 4 * 3 + (chars % 4 ? chars % 4 - 1 : 0) - padding_chars;
+}
+
+size_t pinepp::base64_encode(std::span<const std::byte> bytes, std::span<char> dst) {
+    return base64::encode(bytes, dst);
+}
+
+size_t pinepp::base64_encode(std::string_view str, std::span<char> dst) {
+    return base64::encode(str, dst);
+}
+
+std::string pinepp::base64_encode(std::span<const std::byte> bytes) {
+    return base64::encode(bytes);
+}
+
+std::string pinepp::base64_encode(std::string_view str) {
+    return base64::encode(str);
+}
+
+size_t pinepp::base64_decode(std::string_view input, std::span<std::byte> dst) {
+    return base64::decode(input, dst);
+}
+
+size_t pinepp::base64_decode(std::string_view input, std::span<char> dst) {
+    return base64::decode(input, dst);
+}
+
+std::string pinepp::base64_decode(std::string_view input) {
+    return base64::decode(input);
+}
+
+pinepp::base64_batch pinepp::base64_encode_batch(std::span<const std::string_view> inputs) {
+    return base64::encode_batch(inputs);
+}
+
+std::string pinepp::base64_decode_lenient(std::string_view input) {
+    return base64::decode_lenient(input);
+}
+
+namespace {
+    /**
+     * @brief Owns a file descriptor
+     */
+    class file_descriptor {
+    public:
+        file_descriptor(const std::string& path, int flags) : m_Fd(::open(path.c_str(), flags, 0644)) {
+            if (m_Fd < 0)
+                throw std::runtime_error{"Could not open file " + path + "."};
+        }
+
+        ~file_descriptor() {
+            ::close(m_Fd);
+        }
+
+        file_descriptor(const file_descriptor&) = delete;
+        file_descriptor& operator=(const file_descriptor&) = delete;
+
+        [[nodiscard]] int get() const {
+            return m_Fd;
+        }
+
+        [[nodiscard]] size_t size() const {
+            struct stat st{};
+            if (::fstat(m_Fd, &st) < 0)
+                throw std::runtime_error{"Could not determine the size of a file."};
+            return static_cast<size_t>(st.st_size);
+        }
+
+        void resize(size_t size) const {
+            if (::ftruncate(m_Fd, static_cast<off_t>(size)) < 0)
+                throw std::runtime_error{"Could not resize a file."};
+        }
+
+        /**
+         * @returns True if both descriptors refer to the same file, even through different paths or links
+         */
+        [[nodiscard]] bool same_file(const file_descriptor& other) const {
+            struct stat st{};
+            struct stat other_st{};
+            if (::fstat(m_Fd, &st) < 0 || ::fstat(other.m_Fd, &other_st) < 0)
+                throw std::runtime_error{"Could not identify a file."};
+            return st.st_dev == other_st.st_dev && st.st_ino == other_st.st_ino;
+        }
+
+    private:
+        int m_Fd;
+    };
+
+    /**
+     * @brief Owns a shared memory mapping of a whole file. Empty files aren't mapped at all.
+     */
+    class file_mapping {
+    public:
+        file_mapping(const file_descriptor& file, size_t size, bool writable) : m_Size(size) {
+            if (m_Size == 0)
+                return;
+            m_Data = ::mmap(nullptr, m_Size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, file.get(), 0);
+            if (m_Data == MAP_FAILED)
+                throw std::runtime_error{"Could not map a file into memory."};
+            // BOTH FILES ARE ONLY EVER TRAVERSED ONCE FROM FRONT TO BACK
+            ::madvise(m_Data, m_Size, MADV_SEQUENTIAL);
+        }
+
+        ~file_mapping() {
+            if (m_Size > 0)
+                ::munmap(m_Data, m_Size);
+        }
+
+        file_mapping(const file_mapping&) = delete;
+        file_mapping& operator=(const file_mapping&) = delete;
+
+        [[nodiscard]] std::span<std::byte> bytes() const {
+            return {static_cast<std::byte*>(m_Data), m_Size};
+        }
+
+        [[nodiscard]] std::span<char> chars() const {
+            return {static_cast<char*>(m_Data), m_Size};
+        }
+
+    private:
+        void* m_Data{nullptr};
+        size_t m_Size;
+    };
+
+    /**
+     * @details Maps \p src, creates \p dst with the size \p output_size computes from the mapped input and calls
+     * \p transcode with both mappings. Removes \p dst again if anything fails. \p dst is only truncated once it is
+     * known not to be \p src, whose mapping would otherwise be destroyed.
+     * @throws std::invalid_argument if \p src and \p dst are the same file
+     */
+    template <typename S, typename T>
+    void transcode_file(const std::string& src, const std::string& dst, S&& output_size, T&& transcode) {
+        const file_descriptor in{src, O_RDONLY};
+        const file_mapping input{in, in.size(), false};
+        const file_descriptor out{dst, O_RDWR | O_CREAT};
+        if (out.same_file(in))
+            throw std::invalid_argument{"Can't transcode a file into itself."};
+        try {
+            const auto size = output_size(input);
+            out.resize(size);
+            const file_mapping output{out, size, true};
+            transcode(input, output);
+        } catch (...) {
+            ::unlink(dst.c_str());
+            throw;
+        }
+    }
+}
+
+void pinepp::base64_encode_file(const std::string& src, const std::string& dst) {
+    transcode_file(src, dst, [](const file_mapping& input) { return base64::encoded_size(input.bytes().size()); },
+                   [](const file_mapping& input, const file_mapping& output) {
+                       base64::encode(input.bytes(), output.chars());
+                   });
+}
+
+void pinepp::base64_decode_file(const std::string& src, const std::string& dst) {
+    transcode_file(src, dst, [](const file_mapping& input) {
+                       const auto chars = input.chars();
+                       return base64::decoded_size_lenient(std::string_view{chars.data(), chars.size()});
+                   },
+                   [](const file_mapping& input, const file_mapping& output) {
+                       // FILES WRITTEN BY base64(1) OR AN EDITOR END IN A LINE BREAK AND MAY BE WRAPPED
+                       const auto chars = input.chars();
+                       base64::decode_lenient(std::string_view{chars.data(), chars.size()}, output.bytes());
+                   });
+}
+
+namespace {
+    using standard_blocks = pinepp::base64_blocks<base64_alphabet::STANDARD>;
+}
+
+pinepp::base64_encoder::base64_encoder(sink out) : m_Sink(std::move(out)) {}
+
+void pinepp::base64_encoder::update(std::string_view chunk) {
+    const auto* src = reinterpret_cast<const std::byte*>(chunk.data());
+    auto len = chunk.size();
+
+    // COMPLETE THE BLOCK CARRIED OVER FROM THE LAST CALL
+    if (m_CarryLen > 0) {
+        while (m_CarryLen < 3 && len > 0) {
+            m_Carry[m_CarryLen++] = *src++;
+            len--;
+        }
+        if (m_CarryLen < 3)
+            return;
+        standard_blocks::encode(m_Carry, 3, m_Buffer.data());
+        m_Sink(std::string_view{m_Buffer.data(), 4});
+        m_CarryLen = 0;
+    }
+
+    constexpr auto max_bytes = std::tuple_size_v<decltype(m_Buffer)> / 4 * 3;
+    while (len >= 3) {
+        const auto consumed = standard_blocks::encode(src, std::min(len, max_bytes), m_Buffer.data());
+        m_Sink(std::string_view{m_Buffer.data(), consumed / 3 * 4});
+        src += consumed;
+        len -= consumed;
+    }
+
+    while (len > 0) {
+        m_Carry[m_CarryLen++] = *src++;
+        len--;
+    }
+}
+
+void pinepp::base64_encoder::finish() {
+    if (m_CarryLen > 0)
+        m_Sink(std::string_view{m_Buffer.data(), standard_blocks::encode_tail(m_Carry, m_CarryLen,
+                                                                             m_Buffer.data(), true)});
+    m_CarryLen = 0;
+}
+
+pinepp::base64_decoder::base64_decoder(sink out) : m_Sink(std::move(out)) {}
+
+void pinepp::base64_decoder::update(std::string_view chunk) {
+    if (chunk.empty())
+        return;
+    // NOTHING MAY FOLLOW A PADDED BLOCK
+    if (m_Finished)
+        throw_invalid_encoding();
+
+    auto* dst = reinterpret_cast<std::byte*>(m_Buffer.data());
+    const char* src = chunk.data();
+    auto len = chunk.size();
+
+    // COMPLETE THE BLOCK CARRIED OVER FROM THE LAST CALL
+    if (m_CarryLen > 0) {
+        while (m_CarryLen < 4 && len > 0) {
+            m_Carry[m_CarryLen++] = *src++;
+            len--;
+        }
+        if (m_CarryLen < 4)
+            return;
+        m_CarryLen = 0;
+        if (standard_blocks::decode(m_Carry, 4, dst) == 4) {
+            m_Sink(std::string_view{m_Buffer.data(), 3});
+        } else {
+            m_Sink(std::string_view{m_Buffer.data(), standard_blocks::decode_tail(m_Carry, 4, dst)});
+            m_Finished = true;
+            if (len > 0)
+                throw_invalid_encoding();
+            return;
+        }
+    }
+
+    constexpr auto max_chars = std::tuple_size_v<decltype(m_Buffer)> / 3 * 4;
+    while (len >= 4) {
+        const auto block_chars = std::min(len, max_chars) / 4 * 4;
+        const auto consumed = standard_blocks::decode(src, block_chars, dst);
+        if (consumed > 0)
+            m_Sink(std::string_view{m_Buffer.data(), consumed / 4 * 3});
+        src += consumed;
+        len -= consumed;
+        if (consumed != block_chars) {
+            m_Sink(std::string_view{m_Buffer.data(), standard_blocks::decode_tail(src, 4, dst)});
+            m_Finished = true;
+            if (len > 4)
+                throw_invalid_encoding();
+            return;
+        }
+    }
+
+    while (len > 0) {
+        m_Carry[m_CarryLen++] = *src++;
+        len--;
+    }
+}
+
+void pinepp::base64_decoder::finish() {
+    const auto incomplete = m_CarryLen > 0;
+    m_CarryLen = 0;
+    m_Finished = false;
+    if (incomplete)
+        throw_invalid_encoding();
+}
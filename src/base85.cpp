@@ -0,0 +1,154 @@
+//
+// Created by konstantin on 17.10.26.
+//
+
+#include <cstdint>
+#include <stdexcept>
+#include "base85.hpp"
+
+// ASCII85 HAS NO SIMD KERNELS: EVERY GROUP NEEDS A CHAIN OF DIVISIONS BY 85 (OR MULTIPLICATIONS WHEN DECODING),
+// WHICH THE COMPILER ALREADY TURNS INTO MULTIPLY-SHIFT SEQUENCES, AND THE 'z' SHORTCUT MAKES THE OUTPUT POSITIONS
+// DATA DEPENDENT.
+
+namespace {
+    [[noreturn]] void throw_invalid_encoding() {
+        throw std::invalid_argument{"Given string is not a valid base85 encoding"};
+    }
+
+    inline bool is_whitespace(char c) {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\f' || c == '\v' || c == '\0';
+    }
+
+    /**
+     * @details Writes the 5 digits of \p group, most significant first.
+     */
+    inline void encode_group(uint32_t group, char* dst) {
+        for (int i = 4; i >= 0; --i) {
+            dst[i] = static_cast<char>('!' + group % 85);
+            group /= 85;
+        }
+    }
+
+    /**
+     * @details Combines \p count digits into a group, the missing ones being 'u' as the padding of Ascii85.
+     * @throws std::invalid_argument if the group doesn't fit 32 bits
+     */
+    inline uint32_t decode_group(const uint8_t* digits, size_t count) {
+        uint64_t group = 0;
+        for (size_t i = 0; i < 5; ++i)
+            group = group * 85 + (i < count ? digits[i] : 84);
+        if (group > UINT32_MAX)
+            throw_invalid_encoding();
+        return static_cast<uint32_t>(group);
+    }
+
+    inline void store_group(uint32_t group, size_t count, uint8_t* dst) {
+        for (size_t i = 0; i < count; ++i)
+            dst[i] = static_cast<uint8_t>(group >> (24 - 8 * i));
+    }
+}
+
+size_t pinepp::base85_decoded_size(std::string_view base85) {
+    size_t bytes = 0;
+    size_t digits = 0;
+    for (char c : base85) {
+        if (c == 'z' && digits == 0)
+            bytes += 4;
+        else if (!is_whitespace(c) && ++digits == 5) {
+            bytes += 4;
+            digits = 0;
+        }
+    }
+    // A SINGLE DIGIT CAN'T HOLD A WHOLE BYTE
+    if (digits == 1)
+        throw_invalid_encoding();
+    return bytes + (digits == 0 ? 0 : digits - 1);
+}
+
+size_t pinepp::base85_encode(std::span<const std::byte> bytes, std::span<char> dst) {
+    const auto len = bytes.size();
+    if (dst.size() < base85_max_encoded_size(len))
+        throw std::invalid_argument{"Destination buffer is too small for the base85 encoding"};
+
+    const auto* src = reinterpret_cast<const uint8_t*>(bytes.data());
+    char* out = dst.data();
+    size_t i = 0;
+    for (; i + 4 <= len; i += 4) {
+        const auto group = uint32_t{src[i]} << 24 | uint32_t{src[i + 1]} << 16 | uint32_t{src[i + 2]} << 8 |
+                           uint32_t{src[i + 3]};
+        if (group == 0) {
+            *out++ = 'z';
+        } else {
+            encode_group(group, out);
+            out += 5;
+        }
+    }
+
+    // A FINAL GROUP OF n BYTES IS PADDED WITH ZEROS AND TRUNCATED TO n + 1 DIGITS, NEVER SHORTENED TO 'z'
+    if (i < len) {
+        uint32_t group = 0;
+        for (size_t j = 0; j < 4; ++j)
+            group = group << 8 | (i + j < len ? src[i + j] : 0);
+        char digits[5];
+        encode_group(group, digits);
+        for (size_t j = 0; j <= len - i; ++j)
+            *out++ = digits[j];
+    }
+    return static_cast<size_t>(out - dst.data());
+}
+
+size_t pinepp::base85_encode(std::string_view str, std::span<char> dst) {
+    return base85_encode(std::as_bytes(std::span{str}), dst);
+}
+
+std::string pinepp::base85_encode(std::span<const std::byte> bytes) {
+    std::string rv(base85_max_encoded_size(bytes.size()), '\0');
+    rv.resize(base85_encode(bytes, std::span{rv}));
+    return rv;
+}
+
+std::string pinepp::base85_encode(std::string_view str) {
+    return base85_encode(std::as_bytes(std::span{str}));
+}
+
+size_t pinepp::base85_decode(std::string_view input, std::span<std::byte> dst) {
+    const auto byte_count = base85_decoded_size(input);
+    if (dst.size() < byte_count)
+        throw std::invalid_argument{"Destination buffer is too small for the decoded base85"};
+
+    auto* out = reinterpret_cast<uint8_t*>(dst.data());
+    uint8_t digits[5];
+    size_t count = 0;
+    for (char c : input) {
+        if (c == 'z' && count == 0) {
+            store_group(0, 4, out);
+            out += 4;
+            continue;
+        }
+        if (is_whitespace(c))
+            continue;
+        if (c < '!' || c > 'u')
+            throw_invalid_encoding();
+        digits[count++] = static_cast<uint8_t>(c - '!');
+        if (count == 5) {
+            store_group(decode_group(digits, 5), 4, out);
+            out += 4;
+            count = 0;
+        }
+    }
+    if (count > 0) {
+        store_group(decode_group(digits, count), count - 1, out);
+        out += count - 1;
+    }
+    return byte_count;
+}
+
+size_t pinepp::base85_decode(std::string_view input, std::span<char> dst) {
+    return base85_decode(input, std::as_writable_bytes(dst));
+}
+
+std::string pinepp::base85_decode(std::string_view input) {
+    std::string rv(base85_decoded_size(input), '\0');
+    base85_decode(input, std::span{rv});
+    return rv;
+}
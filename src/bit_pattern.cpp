@@ -2,10 +2,744 @@
 // Created by konstantin on 31.05.23.
 //
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
 #include <iostream>
-#include <ranges>
-#include <regex>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <immintrin.h>
 #include "bit_pattern.hpp"
+#include "base16_digits.hpp"
+
+namespace {
+    using pinepp::bit_pattern_kernel;
+    using pinepp::detail::BASE16_VALUES;
+    using pinepp::detail::pack_base16_word;
+#if defined(__x86_64__) || defined(__i386__)
+    using pinepp::detail::pack_base16_words_avx2;
+#endif
+
+    constexpr std::align_val_t WORD_ALIGNMENT{64};
+
+    uint64_t* allocate_words(size_t n) {
+        return static_cast<uint64_t*>(::operator new(n * sizeof(uint64_t), WORD_ALIGNMENT));
+    }
+
+    void free_words(uint64_t* words) {
+        ::operator delete(words, WORD_ALIGNMENT);
+    }
+
+    /**
+     * @details A kernel combines \p n words of \p a and \p b into \p dst, which may alias either of them. Unary
+     * operations pass their operand twice.
+     */
+    using binary_kernel = void (*)(uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t n);
+
+    // EVERY OPERATION PROVIDES ONE OVERLOAD PER REGISTER WIDTH, WHICH THE KERNEL TEMPLATES BELOW ARE INSTANTIATED WITH
+
+    struct and_op {
+        static uint64_t apply(uint64_t a, uint64_t b) { return a & b; }
+#if defined(__x86_64__) || defined(__i386__)
+        __attribute__((target("avx2")))
+        static __m256i apply(__m256i a, __m256i b) { return _mm256_and_si256(a, b); }
+        __attribute__((target("avx512f")))
+        static __m512i apply(__m512i a, __m512i b) { return _mm512_and_si512(a, b); }
+#endif
+    };
+
+    struct or_op {
+        static uint64_t apply(uint64_t a, uint64_t b) { return a | b; }
+#if defined(__x86_64__) || defined(__i386__)
+        __attribute__((target("avx2")))
+        static __m256i apply(__m256i a, __m256i b) { return _mm256_or_si256(a, b); }
+        __attribute__((target("avx512f")))
+        static __m512i apply(__m512i a, __m512i b) { return _mm512_or_si512(a, b); }
+#endif
+    };
+
+    struct xor_op {
+        static uint64_t apply(uint64_t a, uint64_t b) { return a ^ b; }
+#if defined(__x86_64__) || defined(__i386__)
+        __attribute__((target("avx2")))
+        static __m256i apply(__m256i a, __m256i b) { return _mm256_xor_si256(a, b); }
+        __attribute__((target("avx512f")))
+        static __m512i apply(__m512i a, __m512i b) { return _mm512_xor_si512(a, b); }
+#endif
+    };
+
+    struct not_op {
+        static uint64_t apply(uint64_t a, uint64_t) { return ~a; }
+#if defined(__x86_64__) || defined(__i386__)
+        __attribute__((target("avx2")))
+        static __m256i apply(__m256i a, __m256i) { return _mm256_xor_si256(a, _mm256_set1_epi64x(-1)); }
+        __attribute__((target("avx512f")))
+        static __m512i apply(__m512i a, __m512i) { return _mm512_ternarylogic_epi64(a, a, a, 0x55); }
+#endif
+    };
+
+    template <typename Op>
+    void combine_scalar(uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t n) {
+        for (size_t i = 0; i < n; ++i)
+            dst[i] = Op::apply(a[i], b[i]);
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    template <typename Op>
+    __attribute__((target("avx2")))
+    void combine_avx2(uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t n) {
+        size_t i = 0;
+        // TWO REGISTERS PER ITERATION KEEP ENOUGH LOADS IN FLIGHT TO SATURATE THE MEMORY BUS
+        for (; i + 8 <= n; i += 8) {
+            const __m256i a0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            const __m256i a1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i + 4));
+            const __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+            const __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i + 4));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), Op::apply(a0, b0));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 4), Op::apply(a1, b1));
+        }
+        for (; i < n; ++i)
+            dst[i] = Op::apply(a[i], b[i]);
+    }
+
+    template <typename Op>
+    __attribute__((target("avx512f")))
+    void combine_avx512(uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t n) {
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            const __m512i a0 = _mm512_loadu_si512(a + i);
+            const __m512i a1 = _mm512_loadu_si512(a + i + 8);
+            const __m512i b0 = _mm512_loadu_si512(b + i);
+            const __m512i b1 = _mm512_loadu_si512(b + i + 8);
+            _mm512_storeu_si512(dst + i, Op::apply(a0, b0));
+            _mm512_storeu_si512(dst + i + 8, Op::apply(a1, b1));
+        }
+        // THE REMAINING WORDS ARE HANDLED WITH MASKED LOADS AND STORES INSTEAD OF A SCALAR LOOP
+        for (; i < n; i += 8) {
+            const auto mask = static_cast<__mmask8>(n - i >= 8 ? 0xff : (1u << (n - i)) - 1);
+            const __m512i a0 = _mm512_maskz_loadu_epi64(mask, a + i);
+            const __m512i b0 = _mm512_maskz_loadu_epi64(mask, b + i);
+            _mm512_mask_storeu_epi64(dst + i, mask, Op::apply(a0, b0));
+        }
+    }
+#endif
+
+    /**
+     * @details Every operation has its own set of kernels, indexed by bit_pattern_kernel.
+     */
+    template <typename Op>
+    constexpr binary_kernel KERNELS[3] = {
+#if defined(__x86_64__) || defined(__i386__)
+            combine_scalar<Op>, combine_avx2<Op>, combine_avx512<Op>
+#else
+            combine_scalar<Op>, combine_scalar<Op>, combine_scalar<Op>
+#endif
+    };
+
+    bool is_supported(bit_pattern_kernel kind) {
+#if defined(__x86_64__) || defined(__i386__)
+        switch (kind) {
+            case bit_pattern_kernel::SCALAR:
+                return true;
+            case bit_pattern_kernel::AVX2:
+                return __builtin_cpu_supports("avx2");
+            case bit_pattern_kernel::AVX512:
+                return __builtin_cpu_supports("avx512f");
+        }
+        return false;
+#else
+        return kind == bit_pattern_kernel::SCALAR;
+#endif
+    }
+
+    /**
+     * @details The kernel in use. Resolved once by CPUID on first use, picking the widest supported instruction set.
+     */
+    bit_pattern_kernel& active_kind() {
+        static bit_pattern_kernel active = [] {
+            for (auto kind : {bit_pattern_kernel::AVX512, bit_pattern_kernel::AVX2}) {
+                if (is_supported(kind))
+                    return kind;
+            }
+            return bit_pattern_kernel::SCALAR;
+        }();
+        return active;
+    }
+
+    template <typename Op>
+    binary_kernel active_kernel() {
+        return KERNELS<Op>[static_cast<size_t>(active_kind())];
+    }
+
+    using count_kernel = size_t (*)(const uint64_t* words, size_t count);
+
+    size_t count_scalar(const uint64_t* words, size_t count) {
+        size_t rv = 0;
+        for (size_t i = 0; i < count; ++i)
+            rv += static_cast<size_t>(std::popcount(words[i]));
+        return rv;
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    /**
+     * @details Every CPU with AVX2 has POPCNT, which the scalar kernel can't assume. Four accumulators hide the
+     * latency of the instruction.
+     */
+    __attribute__((target("popcnt")))
+    size_t count_popcnt(const uint64_t* words, size_t count) {
+        uint64_t sums[4]{};
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            sums[0] += static_cast<uint64_t>(__builtin_popcountll(words[i]));
+            sums[1] += static_cast<uint64_t>(__builtin_popcountll(words[i + 1]));
+            sums[2] += static_cast<uint64_t>(__builtin_popcountll(words[i + 2]));
+            sums[3] += static_cast<uint64_t>(__builtin_popcountll(words[i + 3]));
+        }
+        for (; i < count; ++i)
+            sums[0] += static_cast<uint64_t>(__builtin_popcountll(words[i]));
+        return sums[0] + sums[1] + sums[2] + sums[3];
+    }
+#endif
+
+    /**
+     * @details Indexed by bit_pattern_kernel.
+     */
+    constexpr count_kernel COUNT_KERNELS[3] = {
+#if defined(__x86_64__) || defined(__i386__)
+            count_scalar, count_popcnt, count_popcnt
+#else
+            count_scalar, count_scalar, count_scalar
+#endif
+    };
+
+    /**
+     * @returns The index of the first bit set to 1 in \p words at or after \p index or npos if there is none
+     */
+    size_t find_set_bit(const uint64_t* words, size_t count, size_t index) {
+        size_t i = index / 64;
+        if (i >= count)
+            return pinepp::bit_pattern::npos;
+        // THE BITS BELOW index IN ITS OWN WORD ARE MASKED OUT
+        uint64_t word = words[i] & (~uint64_t{0} << (index % 64));
+        while (word == 0) {
+            if (++i == count)
+                return pinepp::bit_pattern::npos;
+            word = words[i];
+        }
+        return i * 64 + static_cast<size_t>(std::countr_zero(word));
+    }
+
+    /**
+     * @returns The upper 64 bits of \p hi:lo shifted left \p n bits, with 0 < n < 64. Compiles to a single SHLD.
+     */
+    inline uint64_t funnel_shift_left(uint64_t hi, uint64_t lo, unsigned n) {
+        return hi << n | lo >> (64 - n);
+    }
+
+    /**
+     * @returns The lower 64 bits of \p hi:lo shifted right \p n bits, with 0 < n < 64. Compiles to a single SHRD.
+     */
+    inline uint64_t funnel_shift_right(uint64_t hi, uint64_t lo, unsigned n) {
+        return lo >> n | hi << (64 - n);
+    }
+
+    /**
+     * @details Shifts the \p count words of \p src left \p n < 64 * count bits into \p dst, which may be \p src.
+     * Words are visited from the most significant one down, so every source word is read before it is overwritten.
+     * If \p accumulate is set, the result is ORed into \p dst instead of replacing it.
+     */
+    void shift_words_left(const uint64_t* src, uint64_t* dst, size_t count, uint64_t n, bool accumulate) {
+        const auto word_shift = static_cast<size_t>(n / 64);
+        const auto bit_shift = static_cast<unsigned>(n % 64);
+        for (size_t i = count; i-- > word_shift;) {
+            const auto lo = i > word_shift ? src[i - word_shift - 1] : 0;
+            const auto word = bit_shift == 0 ? src[i - word_shift]
+                                             : funnel_shift_left(src[i - word_shift], lo, bit_shift);
+            dst[i] = accumulate ? dst[i] | word : word;
+        }
+        if (!accumulate)
+            std::fill_n(dst, std::min(word_shift, count), 0);
+    }
+
+    /**
+     * @details Shifts the \p count words of \p src right \p n < 64 * count bits into \p dst, which may be
+     * \p src. Words are visited from the least significant one up. If \p accumulate is set, the result is ORed into
+     * \p dst instead of replacing it.
+     */
+    void shift_words_right(const uint64_t* src, uint64_t* dst, size_t count, uint64_t n, bool accumulate) {
+        const auto word_shift = static_cast<size_t>(n / 64);
+        const auto bit_shift = static_cast<unsigned>(n % 64);
+        for (size_t i = 0; i + word_shift < count; ++i) {
+            const auto hi = i + word_shift + 1 < count ? src[i + word_shift + 1] : 0;
+            const auto word = bit_shift == 0 ? src[i + word_shift]
+                                             : funnel_shift_right(hi, src[i + word_shift], bit_shift);
+            dst[i] = accumulate ? dst[i] | word : word;
+        }
+        if (!accumulate && word_shift < count)
+            std::fill(dst + count - word_shift, dst + count, 0);
+    }
+
+    /**
+     * @details Copies the \p n bits of the \p count words at \p words starting at bit \p first into the lowest bits
+     * of \p dst, which needs room for (n + 63) / 64 words. Bits of \p dst past \p n are cleared.
+     */
+    void extract_bits(const uint64_t* words, size_t count, size_t first, size_t n, uint64_t* dst) {
+        const auto word_shift = first / 64;
+        const auto bit_shift = static_cast<unsigned>(first % 64);
+        for (size_t i = 0; i < (n + 63) / 64; ++i) {
+            const auto w = word_shift + i;
+            const auto hi = w + 1 < count ? words[w + 1] : 0;
+            dst[i] = bit_shift == 0 ? words[w] : funnel_shift_right(hi, words[w], bit_shift);
+        }
+        if (n % 64 != 0)
+            dst[n / 64] &= (uint64_t{1} << (n % 64)) - 1;
+    }
+
+    /**
+     * @details ORs the \p n bits at \p src into the \p count words at \p words, starting at bit \p first. The bits
+     * must fit into the words.
+     */
+    void or_bits(uint64_t* words, size_t count, size_t first, const uint64_t* src, size_t n) {
+        const auto word_shift = first / 64;
+        const auto bit_shift = static_cast<unsigned>(first % 64);
+        for (size_t i = 0; i < (n + 63) / 64; ++i) {
+            words[word_shift + i] |= src[i] << bit_shift;
+            if (bit_shift != 0 && word_shift + i + 1 < count)
+                words[word_shift + i + 1] |= src[i] >> (64 - bit_shift);
+        }
+    }
+
+    /**
+     * @returns \p word with the order of its bits reversed
+     */
+    inline uint64_t reverse_bits(uint64_t word) {
+        word = (word >> 1 & 0x5555555555555555) | (word & 0x5555555555555555) << 1;
+        word = (word >> 2 & 0x3333333333333333) | (word & 0x3333333333333333) << 2;
+        word = (word >> 4 & 0x0f0f0f0f0f0f0f0f) | (word & 0x0f0f0f0f0f0f0f0f) << 4;
+        return __builtin_bswap64(word);
+    }
+
+    /**
+     * @details A parse kernel turns the last \p count * 64 bits of a string ending at \p end into \p count
+     * words, the last character becoming the least significant bit of words[0].
+     * @returns False if one of the characters isn't a valid digit
+     */
+    using parse_kernel = bool (*)(const char* end, uint64_t* words, size_t count);
+
+    bool parse_binary_scalar(const char* end, uint64_t* words, size_t count) {
+        for (size_t w = 0; w < count; ++w) {
+            const char* chunk = end - 64 * (w + 1);
+            uint64_t word = 0;
+            uint64_t invalid = 0;
+            // 8 CHARACTERS AT A TIME: '0' AND '1' ONLY DIFFER IN THE LOWEST BIT, WHICH THE MULTIPLICATION GATHERS
+            // INTO THE TOP BYTE, FIRST CHARACTER MOST SIGNIFICANT
+            for (size_t group = 0; group < 8; ++group) {
+                uint64_t chars;
+                std::memcpy(&chars, chunk + 8 * group, 8);
+                invalid |= (chars & 0xfefefefefefefefe) ^ 0x3030303030303030;
+                word |= ((chars & 0x0101010101010101) * 0x8040201008040201 >> 56) << (8 * (7 - group));
+            }
+            if (invalid != 0)
+                return false;
+            words[w] = word;
+        }
+        return true;
+    }
+
+    bool parse_hex_scalar(const char* end, uint64_t* words, size_t count) {
+        for (size_t w = 0; w < count; ++w) {
+            if (!pack_base16_word(end - 16 * (w + 1), words[w]))
+                return false;
+        }
+        return true;
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    __attribute__((target("avx2")))
+    bool parse_binary_avx2(const char* end, uint64_t* words, size_t count) {
+        const __m256i zero = _mm256_set1_epi8('0');
+        const __m256i one = _mm256_set1_epi8('1');
+        const __m256i not_lowest = _mm256_set1_epi8(static_cast<char>(0xfe));
+        for (size_t w = 0; w < count; ++w) {
+            const char* chunk = end - 64 * (w + 1);
+            const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(chunk));
+            const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(chunk + 32));
+            const __m256i valid = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(lo, not_lowest), zero),
+                                                   _mm256_cmpeq_epi8(_mm256_and_si256(hi, not_lowest), zero));
+            if (_mm256_movemask_epi8(valid) != -1)
+                return false;
+            // MOVEMASK PUTS THE FIRST CHARACTER INTO THE LOWEST BIT, BUT IT IS THE MOST SIGNIFICANT ONE
+            const auto ones = uint64_t{static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, one)))} |
+                              uint64_t{static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, one)))} << 32;
+            words[w] = reverse_bits(ones);
+        }
+        return true;
+    }
+
+    __attribute__((target("avx2")))
+    bool parse_hex_avx2(const char* end, uint64_t* words, size_t count) {
+        size_t w = 0;
+        // 32 DIGITS, OR TWO WORDS, PER ITERATION
+        for (; w + 2 <= count; w += 2) {
+            if (!pack_base16_words_avx2(end - 16 * (w + 2), words[w + 1], words[w]))
+                return false;
+        }
+        return parse_hex_scalar(end - 16 * w, words + w, count - w);
+    }
+#endif
+
+    struct parse_kernels {
+        parse_kernel binary;
+        parse_kernel hex;
+    };
+
+    /**
+     * @details Indexed by bit_pattern_kernel. Parsing is bound by the movemask, so AVX-512 uses the AVX2 kernels,
+     * which only need AVX-512F to be present.
+     */
+    constexpr parse_kernels PARSE_KERNELS[3] = {
+#if defined(__x86_64__) || defined(__i386__)
+            {parse_binary_scalar, parse_hex_scalar},
+            {parse_binary_avx2, parse_hex_avx2},
+            {parse_binary_avx2, parse_hex_avx2}
+#else
+            {parse_binary_scalar, parse_hex_scalar},
+            {parse_binary_scalar, parse_hex_scalar},
+            {parse_binary_scalar, parse_hex_scalar}
+#endif
+    };
+
+    /**
+     * @details A reverse kernel reverses the order of all 64 * \p count bits of \p words in place.
+     */
+    using reverse_kernel = void (*)(uint64_t* words, size_t count);
+
+    void reverse_scalar(uint64_t* words, size_t count) {
+        for (size_t lo = 0, hi = count; lo < hi--; ++lo) {
+            const auto word = reverse_bits(words[lo]);
+            words[lo] = reverse_bits(words[hi]);
+            words[hi] = word;
+        }
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    /**
+     * @returns The 256 bits of \p v in reverse order. PSHUFB reverses the bytes of each lane and looks up the
+     * reversed nibbles, VPERMQ swaps the lanes.
+     */
+    __attribute__((target("avx2")))
+    inline __m256i reverse_bits_avx2(__m256i v) {
+        const __m256i reverse_bytes = _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+                                                       15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+        const __m256i reversed_nibbles = _mm256_setr_epi8(0x0, 0x8, 0x4, 0xc, 0x2, 0xa, 0x6, 0xe,
+                                                          0x1, 0x9, 0x5, 0xd, 0x3, 0xb, 0x7, 0xf,
+                                                          0x0, 0x8, 0x4, 0xc, 0x2, 0xa, 0x6, 0xe,
+                                                          0x1, 0x9, 0x5, 0xd, 0x3, 0xb, 0x7, 0xf);
+        const __m256i low_nibbles = _mm256_set1_epi8(0x0f);
+        v = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(v, reverse_bytes), 0x4e);
+        const __m256i lo = _mm256_shuffle_epi8(reversed_nibbles, _mm256_and_si256(v, low_nibbles));
+        const __m256i hi = _mm256_shuffle_epi8(reversed_nibbles, _mm256_and_si256(_mm256_srli_epi16(v, 4), low_nibbles));
+        return _mm256_or_si256(_mm256_slli_epi16(lo, 4), hi);
+    }
+
+    __attribute__((target("avx2")))
+    void reverse_avx2(uint64_t* words, size_t count) {
+        size_t lo = 0;
+        size_t hi = count;
+        // SWAPS FOUR WORDS FROM THE FRONT WITH FOUR FROM THE BACK UNTIL THEY WOULD OVERLAP
+        for (; hi - lo >= 8; lo += 4, hi -= 4) {
+            const __m256i front = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + lo));
+            const __m256i back = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + hi - 4));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(words + lo), reverse_bits_avx2(back));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(words + hi - 4), reverse_bits_avx2(front));
+        }
+        reverse_scalar(words + lo, hi - lo);
+    }
+#endif
+
+    /**
+     * @details Indexed by bit_pattern_kernel. Reversing is bound by the byte shuffles, which AVX-512 only widens
+     * with AVX-512BW, so it uses the AVX2 kernel.
+     */
+    constexpr reverse_kernel REVERSE_KERNELS[3] = {
+#if defined(__x86_64__) || defined(__i386__)
+            reverse_scalar, reverse_avx2, reverse_avx2
+#else
+            reverse_scalar, reverse_scalar, reverse_scalar
+#endif
+    };
+
+    /**
+     * @details Parses the \p n < 64 digits at \p src that don't fill a whole word.
+     * @returns False if one of the characters isn't a valid digit
+     */
+    bool parse_head(const char* src, size_t n, bool hex, uint64_t& word) {
+        word = 0;
+        for (size_t i = 0; i < n; ++i) {
+            const auto value = hex ? BASE16_VALUES[static_cast<uint8_t>(src[i])] : static_cast<uint8_t>(src[i] - '0');
+            if (value > (hex ? 15 : 1))
+                return false;
+            word = word << (hex ? 4 : 1) | value;
+        }
+        return true;
+    }
+
+    /**
+     * @details BINARY_CHARS[b] are the 8 characters of the byte b, most significant bit first, as they are stored
+     * in memory.
+     */
+    constexpr auto BINARY_CHARS = [] {
+        std::array<uint64_t, 256> table{};
+        for (size_t byte = 0; byte < 256; ++byte) {
+            for (size_t j = 0; j < 8; ++j)
+                table[byte] |= uint64_t{'0' + (byte >> (7 - j) & 1)} << (8 * j);
+        }
+        return table;
+    }();
+
+    constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+    /**
+     * @details HEX_CHARS[b] are the 2 digits of the byte b, as they are stored in memory.
+     */
+    constexpr auto HEX_CHARS = [] {
+        std::array<uint16_t, 256> table{};
+        for (size_t byte = 0; byte < 256; ++byte)
+            table[byte] = static_cast<uint16_t>(HEX_DIGITS[byte >> 4] | HEX_DIGITS[byte & 0xf] << 8);
+        return table;
+    }();
+
+    /**
+     * @details Writes the bits [first, last) of \p words to \p dst, most significant first, 8 at a time. \p first
+     * must be a multiple of 8.
+     */
+    void write_binary(const uint64_t* words, size_t first, size_t last, char* dst) {
+        auto bit = last;
+        for (; bit % 8 != 0; --bit)
+            *dst++ = static_cast<char>('0' + (words[(bit - 1) / 64] >> ((bit - 1) % 64) & 1));
+        for (; bit > first; bit -= 8, dst += 8)
+            std::memcpy(dst, &BINARY_CHARS[words[(bit - 8) / 64] >> ((bit - 8) % 64) & 0xff], 8);
+    }
+
+    /**
+     * @returns The upper and lower half of the 128 bit product of \p a and \p b, XORed together
+     */
+    inline uint64_t multiply_mix(uint64_t a, uint64_t b) {
+#ifdef __SIZEOF_INT128__
+        __extension__ typedef unsigned __int128 uint128;
+        const auto product = static_cast<uint128>(a) * b;
+        return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#else
+        const uint64_t lo_lo = (a & 0xffffffff) * (b & 0xffffffff);
+        const uint64_t hi_lo = (a >> 32) * (b & 0xffffffff);
+        const uint64_t lo_hi = (a & 0xffffffff) * (b >> 32);
+        const uint64_t hi_hi = (a >> 32) * (b >> 32);
+        const uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xffffffff) + lo_hi;
+        return (cross << 32 | (lo_lo & 0xffffffff)) ^ (hi_hi + (hi_lo >> 32) + (cross >> 32));
+#endif
+    }
+
+    /**
+     * @details The default secret of wyhash, four odd constants with 32 set bits each
+     */
+    constexpr uint64_t HASH_SECRET[4] = {0xa0761d6478bd642f, 0xe7037ed1a0b428db, 0x8ebc6af09c88c6e3,
+                                         0x589965cc75374cc3};
+
+    /**
+     * @details Hashes \p count words like wyhash does with 8 byte blocks: two words at a time are mixed with a
+     * single 64x64 -> 128 bit multiplication, in two independent lanes to keep the multiplier busy. \p len is the
+     * seed, so patterns that only differ in their amount of trailing zeros hash differently.
+     */
+    uint64_t hash_words(const uint64_t* words, size_t count, uint64_t len) {
+        uint64_t seed = len ^ multiply_mix(len ^ HASH_SECRET[0], HASH_SECRET[1]);
+        size_t i = 0;
+        if (count >= 4) {
+            uint64_t lane = seed;
+            for (; i + 4 <= count; i += 4) {
+                seed = multiply_mix(words[i] ^ HASH_SECRET[1], words[i + 1] ^ seed);
+                lane = multiply_mix(words[i + 2] ^ HASH_SECRET[2], words[i + 3] ^ lane);
+            }
+            seed ^= lane;
+        }
+        for (; i + 2 <= count; i += 2)
+            seed = multiply_mix(words[i] ^ HASH_SECRET[1], words[i + 1] ^ seed);
+        const uint64_t last = i < count ? words[i] : 0;
+        return multiply_mix(HASH_SECRET[1] ^ count, multiply_mix(last ^ HASH_SECRET[1], seed ^ HASH_SECRET[3]));
+    }
+
+    /**
+     * @details Writes the hexadecimal digits [first, last) of \p words to \p dst, most significant first, 2 at a
+     * time. \p first must be even.
+     */
+    void write_hex(const uint64_t* words, size_t first, size_t last, char* dst) {
+        auto digit = last;
+        if (digit % 2 != 0) {
+            digit--;
+            *dst++ = HEX_DIGITS[words[digit / 16] >> (digit % 16 * 4) & 0xf];
+        }
+        for (; digit > first; digit -= 2, dst += 2)
+            std::memcpy(dst, &HEX_CHARS[words[(digit - 2) / 16] >> ((digit - 2) % 16 * 4) & 0xff], 2);
+    }
+}
+
+/**
+ * @details A two level directory after "Space-Efficient, High-Performance Rank & Select Structures on Uncompressed
+ * Bit Sequences" (Zhou, Andersen, Kaminsky). The pattern is split into lower blocks of 2048 bits, each made of
+ * four basic blocks of 512 bits, or 8 words. Every lower block has one entry holding the ones before it,
+ * relative to its 2^32 bit upper block, and the counts of its first three basic blocks. On top of that every
+ * SELECT_SAMPLE-th one is sampled with the lower block it lies in.
+ */
+struct pinepp::bit_pattern::rank_index {
+    static constexpr size_t LOWER_BLOCK_BITS = 2048;
+    static constexpr size_t BASIC_BLOCK_WORDS = 8;
+    static constexpr size_t LOWER_BLOCKS_PER_UPPER_BLOCK = (size_t{1} << 32) / LOWER_BLOCK_BITS;
+    static constexpr size_t SELECT_SAMPLE = 8192;
+
+    /**
+     * @brief The amount of ones before every 2^32 bit upper block
+     */
+    std::vector<uint64_t> upper;
+    /**
+     * @brief One entry per lower block. The low 32 bits hold the ones before the block relative to its upper
+     * block, followed by three 10 bit counts of its first basic blocks.
+     */
+    std::vector<uint64_t> lower;
+    /**
+     * @brief The lower block containing the one with index i * SELECT_SAMPLE for every i
+     */
+    std::vector<uint32_t> samples;
+    size_t ones = 0;
+
+    [[nodiscard]] size_t ones_before(size_t block) const {
+        return upper[block / LOWER_BLOCKS_PER_UPPER_BLOCK] + (lower[block] & 0xffffffff);
+    }
+
+    [[nodiscard]] static size_t basic_block_count(uint64_t entry, size_t basic_block) {
+        return entry >> (32 + 10 * basic_block) & 0x3ff;
+    }
+};
+
+namespace {
+    /**
+     * @details SELECT_IN_BYTE[b][k] is the position of the k-th set bit in the byte b
+     */
+    constexpr auto SELECT_IN_BYTE = [] {
+        std::array<std::array<uint8_t, 8>, 256> table{};
+        for (size_t byte = 0; byte < 256; ++byte) {
+            uint8_t k = 0;
+            for (uint8_t bit = 0; bit < 8; ++bit) {
+                if (byte >> bit & 1)
+                    table[byte][k++] = bit;
+            }
+        }
+        return table;
+    }();
+
+    /**
+     * @returns The position of the k-th set bit in \p word, which must have more than \p k bits set
+     */
+    size_t select_in_word(uint64_t word, size_t k) {
+        size_t shift = 0;
+        for (;; shift += 8) {
+            const auto ones = static_cast<size_t>(std::popcount(word >> shift & 0xff));
+            if (k < ones)
+                break;
+            k -= ones;
+        }
+        return shift + SELECT_IN_BYTE[word >> shift & 0xff][k];
+    }
+}
+
+pinepp::bit_pattern_kernel pinepp::bit_pattern_active_kernel() {
+    return active_kind();
+}
+
+bool pinepp::bit_pattern_select_kernel(bit_pattern_kernel kernel) {
+    if (!is_supported(kernel))
+        return false;
+    active_kind() = kernel;
+    return true;
+}
+
+pinepp::bit_pattern::word_buffer::word_buffer(const word_buffer& other) {
+    resize_for_overwrite(other.m_Size);
+    std::copy_n(other.mp_Data, other.m_Size, mp_Data);
+}
+
+pinepp::bit_pattern::word_buffer::word_buffer(word_buffer&& other) noexcept {
+    steal(other);
+}
+
+pinepp::bit_pattern::word_buffer& pinepp::bit_pattern::word_buffer::operator=(const word_buffer& other) {
+    if (&other == this)
+        return *this;
+    resize_for_overwrite(other.m_Size);
+    std::copy_n(other.mp_Data, other.m_Size, mp_Data);
+    return *this;
+}
+
+pinepp::bit_pattern::word_buffer& pinepp::bit_pattern::word_buffer::operator=(word_buffer&& other) noexcept {
+    if (&other == this)
+        return *this;
+    if (!is_inline())
+        free_words(mp_Data);
+    mp_Data = m_Inline;
+    m_Capacity = INLINE_WORDS;
+    m_Size = 0;
+    steal(other);
+    return *this;
+}
+
+pinepp::bit_pattern::word_buffer::~word_buffer() {
+    if (!is_inline())
+        free_words(mp_Data);
+}
+
+void pinepp::bit_pattern::word_buffer::steal(word_buffer& other) noexcept {
+    if (other.is_inline()) {
+        // INLINE WORDS CAN'T BE HANDED OVER, BUT THERE ARE ONLY A FEW OF THEM
+        std::copy_n(other.m_Inline, other.m_Size, m_Inline);
+    } else {
+        mp_Data = std::exchange(other.mp_Data, other.m_Inline);
+        m_Capacity = std::exchange(other.m_Capacity, INLINE_WORDS);
+    }
+    m_Size = std::exchange(other.m_Size, 0);
+}
+
+void pinepp::bit_pattern::word_buffer::reserve(size_t n) {
+    if (n <= m_Capacity)
+        return;
+    const auto capacity = std::max(n, 2 * m_Capacity);
+    auto* data = allocate_words(capacity);
+    std::copy_n(mp_Data, m_Size, data);
+    if (!is_inline())
+        free_words(mp_Data);
+    mp_Data = data;
+    m_Capacity = capacity;
+}
+
+void pinepp::bit_pattern::word_buffer::resize(size_t n) {
+    reserve(n);
+    if (n > m_Size)
+        std::fill(mp_Data + m_Size, mp_Data + n, 0);
+    m_Size = n;
+}
+
+void pinepp::bit_pattern::word_buffer::resize_for_overwrite(size_t n) {
+    if (n > m_Capacity) {
+        // NOTHING TO PRESERVE, SO THE OLD WORDS AREN'T COPIED OVER
+        auto* data = allocate_words(n);
+        if (!is_inline())
+            free_words(mp_Data);
+        mp_Data = data;
+        m_Capacity = n;
+    }
+    m_Size = n;
+}
 
 
 pinepp::bit_pattern::bit_pattern() : m_Len(0) {}
@@ -14,71 +748,252 @@ pinepp::bit_pattern::bit_pattern(const std::string& str) {
     from_string(str);
 }
 
+pinepp::bit_pattern::bit_pattern(size_t n, bool value) : m_Len(n) {
+    m_Words.resize_for_overwrite((n + 63) / 64);
+    std::fill_n(m_Words.data(), m_Words.size(), value ? ~uint64_t{0} : 0);
+    clear_unused_bits();
+}
+
 void pinepp::bit_pattern::from_string(const std::string& str) {
-    m_RawBytes.clear();
-    if (std::regex pattern{"^[01]+$"}; std::regex_match(str, pattern)) {
-        m_Len = str.size();
-        m_RawBytes.resize(((m_Len - 1) / 8) + 1, 0);
-        int counter = 0;
-        for (auto c : std::ranges::reverse_view(str)) {
-            if (c == '1')
-                m_RawBytes[counter / 8] |= (1 << (counter % 8));
-            counter++;
-        }
-    } else if (pattern = "^0[xX][0-9a-fA-F]+$"; std::regex_match(str, pattern)) {
-        m_Len = (str.size() - 2) * 4;
-        m_RawBytes.resize((m_Len - 1 / 8) + 1, 0);
-        size_t counter = 0;
-        auto it = str.rbegin();
-        while (counter < str.size()) {
-            uint8_t digit = 0;
-
-            if (*it >= '1' && *it <= '9')
-                digit = *it - '1' + 1;
-            else if (*it >= 'a' && *it <= 'f')
-                digit = *it - 'a' + 10;
-            else if (*it >= 'A' && *it <= 'F')
-                digit = *it - 'A' + 10;
-
-            if (counter % 2 == 0)
-                m_RawBytes[counter / 2] |= digit;
-            else
-                m_RawBytes[counter / 2] |= digit << 4;
+    mp_RankIndex.reset();
+    // A BINARY STRING CAN'T START WITH 0x, SO THE PREFIX DECIDES
+    const bool hex = str.size() > 2 && str[0] == '0' && (str[1] == 'x' || str[1] == 'X');
+    const auto digits = hex ? str.size() - 2 : str.size();
+    const size_t digits_per_word = hex ? 16 : 64;
+    m_Len = hex ? digits * 4 : digits;
+    m_Words.resize_for_overwrite((m_Len + 63) / 64);
 
-            counter++;
-            ++it;
-        }
+    const auto& kernels = PARSE_KERNELS[static_cast<size_t>(active_kind())];
+    const char* end = str.data() + str.size();
+    const auto whole_words = digits / digits_per_word;
+    bool valid = (hex ? kernels.hex : kernels.binary)(end, m_Words.data(), whole_words);
+    if (valid && digits % digits_per_word != 0)
+        valid = parse_head(end - digits, digits % digits_per_word, hex, m_Words[whole_words]);
+    if (!valid) {
+        m_Len = 0;
+        m_Words.clear();
     }
 }
 
+void pinepp::bit_pattern::clear_unused_bits() {
+    if (m_Len % 64 != 0)
+        m_Words[m_Words.size() - 1] &= (uint64_t{1} << (m_Len % 64)) - 1;
+}
+
+pinepp::bit_pattern::bit_pattern(const bit_pattern& other)
+        : m_Words(other.m_Words), m_Len(other.m_Len), mp_RankIndex(std::atomic_load(&other.mp_RankIndex)) {}
+
 pinepp::bit_pattern::bit_pattern(bit_pattern&& other) noexcept {
-    m_RawBytes = std::move(other.m_RawBytes);
+    m_Words = std::move(other.m_Words);
     m_Len = other.m_Len;
+    mp_RankIndex = std::move(other.mp_RankIndex);
+    other.m_Len = 0;
 }
 
 size_t pinepp::bit_pattern::size() const {
     return m_Len;
 }
 
+size_t pinepp::bit_pattern::count() const noexcept {
+    return COUNT_KERNELS[static_cast<size_t>(active_kind())](m_Words.data(), m_Words.size());
+}
+
+bool pinepp::bit_pattern::any() const noexcept {
+    return std::any_of(m_Words.data(), m_Words.data() + m_Words.size(), [](uint64_t word) { return word != 0; });
+}
+
+bool pinepp::bit_pattern::none() const noexcept {
+    return !any();
+}
 
-void pinepp::bit_pattern::set_bit(int index, bool value) {
+bool pinepp::bit_pattern::all() const noexcept {
+    if (m_Len == 0)
+        return true;
+    const auto full_words = m_Len / 64;
+    if (!std::all_of(m_Words.data(), m_Words.data() + full_words, [](uint64_t word) { return word == ~uint64_t{0}; }))
+        return false;
+    return m_Len % 64 == 0 || m_Words[full_words] == (uint64_t{1} << (m_Len % 64)) - 1;
+}
+
+size_t pinepp::bit_pattern::find_first() const noexcept {
+    return find_set_bit(m_Words.data(), m_Words.size(), 0);
+}
+
+size_t pinepp::bit_pattern::find_next(size_t index) const noexcept {
+    if (m_Len == 0 || index >= m_Len - 1)
+        return npos;
+    return find_set_bit(m_Words.data(), m_Words.size(), index + 1);
+}
+
+size_t pinepp::bit_pattern::find_last() const noexcept {
+    for (size_t i = m_Words.size(); i-- > 0;) {
+        if (m_Words[i] != 0)
+            return i * 64 + 63 - static_cast<size_t>(std::countl_zero(m_Words[i]));
+    }
+    return npos;
+}
+
+size_t pinepp::bit_pattern::countl_zero() const noexcept {
+    const auto last = find_last();
+    return last == npos ? m_Len : m_Len - 1 - last;
+}
+
+size_t pinepp::bit_pattern::countr_zero() const noexcept {
+    const auto first = find_first();
+    return first == npos ? m_Len : first;
+}
+
+const pinepp::bit_pattern::rank_index& pinepp::bit_pattern::rank_directory() const {
+    // THE DIRECTORY, ONCE PUBLISHED, STAYS ALIVE UNTIL THE PATTERN CHANGES, SO RETURNING A REFERENCE IS SAFE
+    if (const auto current = std::atomic_load_explicit(&mp_RankIndex, std::memory_order_acquire))
+        return *current;
+
+    const auto count_words = COUNT_KERNELS[static_cast<size_t>(active_kind())];
+    auto index = std::make_shared<rank_index>();
+    const auto blocks = (m_Len + rank_index::LOWER_BLOCK_BITS - 1) / rank_index::LOWER_BLOCK_BITS;
+    index->lower.resize(blocks);
+    index->upper.resize(blocks / rank_index::LOWER_BLOCKS_PER_UPPER_BLOCK + 1);
+    size_t ones = 0;
+    size_t next_sample = 0;
+    for (size_t block = 0; block < blocks; ++block) {
+        if (block % rank_index::LOWER_BLOCKS_PER_UPPER_BLOCK == 0)
+            index->upper[block / rank_index::LOWER_BLOCKS_PER_UPPER_BLOCK] = ones;
+        uint64_t entry = ones - index->upper[block / rank_index::LOWER_BLOCKS_PER_UPPER_BLOCK];
+        size_t block_ones = 0;
+        for (size_t basic_block = 0; basic_block < 4; ++basic_block) {
+            const auto first = (block * 4 + basic_block) * rank_index::BASIC_BLOCK_WORDS;
+            const auto last = std::min(first + rank_index::BASIC_BLOCK_WORDS, m_Words.size());
+            const auto count = first < last ? count_words(m_Words.data() + first, last - first) : 0;
+            if (basic_block < 3)
+                entry |= uint64_t{count} << (32 + 10 * basic_block);
+            block_ones += count;
+        }
+        index->lower[block] = entry;
+        for (; next_sample < ones + block_ones; next_sample += rank_index::SELECT_SAMPLE)
+            index->samples.push_back(static_cast<uint32_t>(block));
+        ones += block_ones;
+    }
+    index->ones = ones;
+    // THREADS RACING ON THE FIRST CALL ALL USE THE DIRECTORY THAT WAS PUBLISHED FIRST
+    std::shared_ptr<const rank_index> published{};
+    std::shared_ptr<const rank_index> built = std::move(index);
+    if (std::atomic_compare_exchange_strong(&mp_RankIndex, &published, built))
+        return *built;
+    return *published;
+}
+
+size_t pinepp::bit_pattern::rank1(size_t index) const {
+    const auto& directory = rank_directory();
+    if (index >= m_Len)
+        return directory.ones;
+
+    const auto block = index / rank_index::LOWER_BLOCK_BITS;
+    const auto entry = directory.lower[block];
+    auto rv = directory.ones_before(block);
+    const auto basic_block = index / 512 % 4;
+    for (size_t i = 0; i < basic_block; ++i)
+        rv += rank_index::basic_block_count(entry, i);
+    const auto first = index / 512 * rank_index::BASIC_BLOCK_WORDS;
+    rv += count_scalar(m_Words.data() + first, index / 64 - first);
+    if (index % 64 != 0)
+        rv += static_cast<size_t>(std::popcount(m_Words[index / 64] & ((uint64_t{1} << (index % 64)) - 1)));
+    return rv;
+}
+
+size_t pinepp::bit_pattern::select1(size_t k) const {
+    const auto& directory = rank_directory();
+    if (k >= directory.ones)
+        return npos;
+
+    // THE SAMPLES NARROW THE SEARCH DOWN TO THE LOWER BLOCKS BETWEEN TWO SAMPLED ONES
+    const auto sample = k / rank_index::SELECT_SAMPLE;
+    size_t lo = directory.samples[sample];
+    size_t hi = sample + 1 < directory.samples.size() ? directory.samples[sample + 1] : directory.lower.size() - 1;
+    while (lo < hi) {
+        const auto mid = lo + (hi - lo + 1) / 2;
+        if (directory.ones_before(mid) <= k)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+
+    auto remaining = k - directory.ones_before(lo);
+    const auto entry = directory.lower[lo];
+    size_t basic_block = 0;
+    for (; basic_block < 3 && remaining >= rank_index::basic_block_count(entry, basic_block); ++basic_block)
+        remaining -= rank_index::basic_block_count(entry, basic_block);
+
+    auto word = (lo * 4 + basic_block) * rank_index::BASIC_BLOCK_WORDS;
+    for (;; ++word) {
+        const auto ones = static_cast<size_t>(std::popcount(m_Words[word]));
+        if (remaining < ones)
+            break;
+        remaining -= ones;
+    }
+    return word * 64 + select_in_word(m_Words[word], remaining);
+}
+
+
+void pinepp::bit_pattern::set_bit(size_t index, bool value) {
+    if (index >= m_Len)
+        throw std::out_of_range{"Index is out of range of the bit_pattern"};
+    mp_RankIndex.reset();
     if (value)
-        m_RawBytes[index / 8] |= (1 << (index % 8));
+        m_Words[index / 64] |= uint64_t{1} << (index % 64);
     else
-        m_RawBytes[index / 8] &= ~(1 << (index % 8));
+        m_Words[index / 64] &= ~(uint64_t{1} << (index % 64));
 }
 
 void pinepp::bit_pattern::reverse() {
-    auto c = this->str();
-    std::reverse(c.begin(), c.end());
-    *this = bit_pattern{c};
+    mp_RankIndex.reset();
+    if (m_Len == 0)
+        return;
+    REVERSE_KERNELS[static_cast<size_t>(active_kind())](m_Words.data(), m_Words.size());
+    // THE UNUSED BITS OF THE LAST WORD ARE NOW THE LOWEST ONES
+    const auto unused = m_Words.size() * 64 - m_Len;
+    if (unused != 0)
+        shift_words_right(m_Words.data(), m_Words.data(), m_Words.size(), unused, false);
+}
+
+pinepp::bit_pattern& pinepp::bit_pattern::push_back(bool value) {
+    mp_RankIndex.reset();
+    if (m_Len % 64 == 0)
+        m_Words.resize(m_Words.size() + 1);
+    m_Words[m_Len / 64] |= uint64_t{value} << (m_Len % 64);
+    m_Len++;
+    return *this;
+}
+
+pinepp::bit_pattern& pinepp::bit_pattern::append(uint64_t bits, size_t n) {
+    if (n > 64)
+        throw std::invalid_argument{"Can't append more than 64 bits at once"};
+    if (n == 0)
+        return *this;
+    const auto word = n == 64 ? bits : bits & ((uint64_t{1} << n) - 1);
+    append_words(&word, n);
+    return *this;
+}
+
+void pinepp::bit_pattern::append_words(const uint64_t* words, size_t n) {
+    mp_RankIndex.reset();
+    const auto word_shift = m_Len / 64;
+    const auto bit_shift = static_cast<unsigned>(m_Len % 64);
+    m_Len += n;
+    // THE NEW WORDS START AT 0 AND SO DO THE UNUSED BITS OF THE OLD LAST WORD, SO THE BITS CAN BE ORED IN
+    m_Words.resize((m_Len + 63) / 64);
+    for (size_t i = 0; i < (n + 63) / 64; ++i) {
+        m_Words[word_shift + i] |= words[i] << bit_shift;
+        if (bit_shift != 0 && word_shift + i + 1 < m_Words.size())
+            m_Words[word_shift + i + 1] |= words[i] >> (64 - bit_shift);
+    }
 }
 
 pinepp::bit_pattern& pinepp::bit_pattern::operator=(const pinepp::bit_pattern& other) {
     if (&other == this)
         return *this;
     this->m_Len = other.m_Len;
-    this->m_RawBytes = other.m_RawBytes;
+    this->m_Words = other.m_Words;
+    this->mp_RankIndex = std::atomic_load(&other.mp_RankIndex);
     return *this;
 }
 
@@ -91,77 +1006,107 @@ pinepp::bit_pattern& pinepp::bit_pattern::operator=(pinepp::bit_pattern&& other)
     if (&other == this)
         return *this;
     this->m_Len = other.m_Len;
-    this->m_RawBytes = std::move(other.m_RawBytes);
+    this->m_Words = std::move(other.m_Words);
+    this->mp_RankIndex = std::move(other.mp_RankIndex);
     other.m_Len = 0;
     return *this;
 }
 
-int pinepp::bit_pattern::operator[](unsigned int index) const {
-    return m_RawBytes[index / 8] & (1 << (index % 8)) ? 1 : 0;
+int pinepp::bit_pattern::operator[](size_t index) const {
+    return static_cast<int>(m_Words[index / 64] >> (index % 64) & 1);
 }
 
-pinepp::bit_pattern pinepp::bit_pattern::operator&(const bit_pattern& other) const {
-    const auto& shorterPattern = this->m_Len < other.m_Len ? *this : other;
-    const auto& longerPattern = this->m_Len < other.m_Len ? other : *this;
-    bit_pattern rv{shorterPattern};
-
-    for (decltype(shorterPattern.m_RawBytes)::size_type i = 0; i < shorterPattern.m_RawBytes.size(); ++i)
-        rv.m_RawBytes[i] = shorterPattern.m_RawBytes[i] & longerPattern.m_RawBytes[i];
+pinepp::bit_pattern::reference pinepp::bit_pattern::operator[](size_t index) {
+    return reference{this, index};
+}
 
-    return rv;
+pinepp::bit_pattern& pinepp::bit_pattern::operator&=(const bit_pattern& other) {
+    mp_RankIndex.reset();
+    m_Len = std::min(m_Len, other.m_Len);
+    m_Words.resize((m_Len + 63) / 64);
+    active_kernel<and_op>()(m_Words.data(), m_Words.data(), other.m_Words.data(), m_Words.size());
+    return *this;
 }
 
-pinepp::bit_pattern pinepp::bit_pattern::operator|(const bit_pattern& other) const {
-    const auto& shorterPattern = this->m_Len < other.m_Len ? *this : other;
-    const auto& longerPattern = this->m_Len < other.m_Len ? other : *this;
-    bit_pattern rv{shorterPattern};
+pinepp::bit_pattern& pinepp::bit_pattern::operator|=(const bit_pattern& other) {
+    mp_RankIndex.reset();
+    m_Len = std::min(m_Len, other.m_Len);
+    m_Words.resize((m_Len + 63) / 64);
+    active_kernel<or_op>()(m_Words.data(), m_Words.data(), other.m_Words.data(), m_Words.size());
+    // THE LAST WORD OF THE LONGER PATTERN MAY HAVE BITS PAST THE LENGTH OF THE RESULT
+    clear_unused_bits();
+    return *this;
+}
 
-    for (decltype(shorterPattern.m_RawBytes)::size_type i = 0; i < shorterPattern.m_RawBytes.size(); ++i)
-        rv.m_RawBytes[i] = shorterPattern.m_RawBytes[i] | longerPattern.m_RawBytes[i];
+pinepp::bit_pattern& pinepp::bit_pattern::operator^=(const bit_pattern& other) {
+    mp_RankIndex.reset();
+    m_Len = std::min(m_Len, other.m_Len);
+    m_Words.resize((m_Len + 63) / 64);
+    active_kernel<xor_op>()(m_Words.data(), m_Words.data(), other.m_Words.data(), m_Words.size());
+    clear_unused_bits();
+    return *this;
+}
 
-    return rv;
+pinepp::bit_pattern& pinepp::bit_pattern::flip() {
+    mp_RankIndex.reset();
+    active_kernel<not_op>()(m_Words.data(), m_Words.data(), m_Words.data(), m_Words.size());
+    clear_unused_bits();
+    return *this;
 }
 
-pinepp::bit_pattern pinepp::bit_pattern::operator^(const bit_pattern& other) const {
-    const auto& shorterPattern = this->m_Len < other.m_Len ? *this : other;
-    const auto& longerPattern = this->m_Len < other.m_Len ? other : *this;
-    bit_pattern rv{shorterPattern};
+void pinepp::bit_and_words::apply(uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t n) {
+    active_kernel<and_op>()(dst, a, b, n);
+}
 
-    for (decltype(shorterPattern.m_RawBytes)::size_type i = 0; i < shorterPattern.m_RawBytes.size(); ++i)
-        rv.m_RawBytes[i] = shorterPattern.m_RawBytes[i] ^ longerPattern.m_RawBytes[i];
+void pinepp::bit_or_words::apply(uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t n) {
+    active_kernel<or_op>()(dst, a, b, n);
+}
 
-    return rv;
+void pinepp::bit_xor_words::apply(uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t n) {
+    active_kernel<xor_op>()(dst, a, b, n);
 }
 
-pinepp::bit_pattern pinepp::bit_pattern::operator~() const {
-    bit_pattern rv{*this};
+void pinepp::bit_not_words::apply(uint64_t* dst, const uint64_t* a, size_t n) {
+    active_kernel<not_op>()(dst, a, a, n);
+}
 
-    for (decltype(this->m_RawBytes)::size_type i = 0; i < this->m_RawBytes.size(); ++i)
-        rv.m_RawBytes[i] = ~rv.m_RawBytes[i];
+size_t pinepp::bit_count_words::apply(const uint64_t* a, size_t n) {
+    return COUNT_KERNELS[static_cast<size_t>(active_kind())](a, n);
+}
 
+std::string pinepp::bit_pattern::str() const {
+    std::string rv(m_Len, '0');
+    write_binary(m_Words.data(), 0, m_Len, rv.data());
     return rv;
 }
 
-std::string pinepp::bit_pattern::str() const {
-    std::stringstream ss;
-    ss << *this;
-    return ss.str();
+std::string pinepp::bit_pattern::hex_str() const {
+    if (m_Len == 0)
+        return {};
+    const auto digits = (m_Len + 3) / 4;
+    std::string rv(digits + 2, '0');
+    rv[1] = 'x';
+    write_hex(m_Words.data(), 0, digits, rv.data() + 2);
+    return rv;
 }
 
 bool pinepp::bit_pattern::operator==(const pinepp::bit_pattern &other) const noexcept {
-    if (this->size() != other.size())
-        return false;
-    if (this == &other)
-        return true;
-    auto it1 = this->begin();
-    auto it2 = other.begin();
-    while (it1 != this->end() && it2 != other.end()) {
-        if (*it1 != *it2)
-            return false;
-        ++it1;
-        ++it2;
+    // THE BITS PAST m_Len ARE ALWAYS 0, SO WHOLE WORDS CAN BE COMPARED
+    return m_Len == other.m_Len && std::equal(m_Words.data(), m_Words.data() + m_Words.size(), other.m_Words.data());
+}
+
+std::strong_ordering pinepp::bit_pattern::operator<=>(const bit_pattern& other) const noexcept {
+    if (m_Len != other.m_Len)
+        return m_Len <=> other.m_Len;
+    for (size_t i = m_Words.size(); i-- > 0;) {
+        if (m_Words[i] != other.m_Words[i])
+            return m_Words[i] <=> other.m_Words[i];
     }
-    return true;
+    return std::strong_ordering::equal;
+}
+
+size_t pinepp::bit_pattern::hash() const noexcept {
+    return static_cast<size_t>(hash_words(m_Words.data(), m_Words.size(), m_Len));
 }
 
 bool pinepp::bit_pattern::operator!=(const pinepp::bit_pattern &other) const noexcept {
@@ -171,56 +1116,138 @@ bool pinepp::bit_pattern::operator!=(const pinepp::bit_pattern &other) const noe
 pinepp::bit_pattern& pinepp::bit_pattern::resize(size_t n) {
     if (m_Len == n)
         return *this;
-    else if (std::string str = this->str(); m_Len > n) {
-        from_string(str.substr(str.size() - n));
-    } else {
-        from_string(std::string(n - str.size(), '0') + str);
-    }
+    mp_RankIndex.reset();
+    // NEW WORDS ARE 0 AND SO ARE THE UNUSED BITS OF THE OLD LAST WORD, SO ONLY SHRINKING NEEDS TO CLEAR BITS
+    m_Len = n;
+    m_Words.resize((n + 63) / 64);
+    clear_unused_bits();
     return *this;
 }
 
 pinepp::bit_pattern pinepp::bit_pattern::operator<<(uint64_t n) const {
-    uint64_t shift = n % m_Len;
-    if (m_Len <= 1 || shift == 0)
-        return *this;
-    auto str = this->str();
-    std::string firstPart = str.substr(0, shift);
-    std::string secondPart = str.substr(shift);
-    bit_pattern rv{secondPart + firstPart};
+    if (n >= m_Len)
+        return bit_pattern{m_Len};
+    bit_pattern rv{};
+    rv.m_Len = m_Len;
+    rv.m_Words.resize_for_overwrite(m_Words.size());
+    shift_words_left(m_Words.data(), rv.m_Words.data(), m_Words.size(), n, false);
+    rv.clear_unused_bits();
     return rv;
 }
 
 pinepp::bit_pattern pinepp::bit_pattern::operator>>(uint64_t n) const {
-    uint64_t shift = n % m_Len;
-    if (m_Len <= 1 || shift == 0)
-        return *this;
-    auto str = this->str();
-    std::string firstPart = str.substr(0, str.size() - shift);
-    std::string secondPart = str.substr(str.size() - shift);
-    bit_pattern rv{secondPart + firstPart};
+    if (n >= m_Len)
+        return bit_pattern{m_Len};
+    bit_pattern rv{};
+    rv.m_Len = m_Len;
+    rv.m_Words.resize_for_overwrite(m_Words.size());
+    shift_words_right(m_Words.data(), rv.m_Words.data(), m_Words.size(), n, false);
     return rv;
 }
 
+pinepp::bit_pattern& pinepp::bit_pattern::operator<<=(uint64_t n) {
+    mp_RankIndex.reset();
+    if (n >= m_Len) {
+        std::fill_n(m_Words.data(), m_Words.size(), 0);
+        return *this;
+    }
+    shift_words_left(m_Words.data(), m_Words.data(), m_Words.size(), n, false);
+    clear_unused_bits();
+    return *this;
+}
 
-pinepp::bit_pattern pinepp::bit_pattern::operator+(const bit_pattern& other) const {
-    if (this->m_Len > 0 && other.m_Len > 0) {
-        return bit_pattern{this->str() + other.str()};
-    } else if (this->m_Len == 0 && other.m_Len > 0)
-        return other;
-    else if (this->m_Len > 0 && other.m_Len == 0)
+pinepp::bit_pattern& pinepp::bit_pattern::operator>>=(uint64_t n) {
+    mp_RankIndex.reset();
+    if (n >= m_Len) {
+        std::fill_n(m_Words.data(), m_Words.size(), 0);
         return *this;
-    else
-        return bit_pattern{};
+    }
+    shift_words_right(m_Words.data(), m_Words.data(), m_Words.size(), n, false);
+    return *this;
+}
+
+pinepp::bit_pattern& pinepp::bit_pattern::rotate_left(uint64_t n) {
+    if (m_Len <= 1 || n % m_Len == 0)
+        return *this;
+    mp_RankIndex.reset();
+    const auto shift = static_cast<size_t>(n % m_Len);
+    auto* words = m_Words.data();
+    const auto count = m_Words.size();
+    // ONLY THE BITS THAT WRAP AROUND ARE KEPT ASIDE, SO WHICHEVER DIRECTION MOVES FEWER OF THEM IS SHIFTED
+    if (shift <= m_Len - shift) {
+        std::vector<uint64_t> wrapped((shift + 63) / 64);
+        extract_bits(words, count, m_Len - shift, shift, wrapped.data());
+        shift_words_left(words, words, count, shift, false);
+        clear_unused_bits();
+        or_bits(words, count, 0, wrapped.data(), shift);
+    } else {
+        const auto back = m_Len - shift;
+        std::vector<uint64_t> wrapped((back + 63) / 64);
+        extract_bits(words, count, 0, back, wrapped.data());
+        shift_words_right(words, words, count, back, false);
+        or_bits(words, count, m_Len - back, wrapped.data(), back);
+    }
+    return *this;
+}
+
+pinepp::bit_pattern& pinepp::bit_pattern::rotate_right(uint64_t n) {
+    if (m_Len <= 1 || n % m_Len == 0)
+        return *this;
+    return rotate_left(m_Len - n % m_Len);
+}
+
+namespace pinepp {
+    bit_pattern rotl(const bit_pattern& pattern, uint64_t n) {
+        const auto len = pattern.m_Len;
+        if (len <= 1 || n % len == 0)
+            return pattern;
+        const auto shift = n % len;
+        bit_pattern rv{};
+        rv.m_Len = len;
+        rv.m_Words.resize_for_overwrite(pattern.m_Words.size());
+        // THE BITS SHIFTED OUT ON THE LEFT ARE THE TOP shift BITS, WHICH LAND IN THE ZEROS SHIFTED IN ON THE RIGHT
+        shift_words_left(pattern.m_Words.data(), rv.m_Words.data(), rv.m_Words.size(), shift, false);
+        rv.clear_unused_bits();
+        shift_words_right(pattern.m_Words.data(), rv.m_Words.data(), rv.m_Words.size(), len - shift, true);
+        return rv;
+    }
+
+    bit_pattern rotr(const bit_pattern& pattern, uint64_t n) {
+        const auto len = pattern.m_Len;
+        if (len <= 1 || n % len == 0)
+            return pattern;
+        return rotl(pattern, len - n % len);
+    }
+}
+
+pinepp::bit_pattern pinepp::bit_pattern::operator+(const bit_pattern& other) const {
+    bit_pattern rv;
+    rv.m_Words.reserve((m_Len + other.m_Len + 63) / 64);
+    rv.m_Words = other.m_Words;
+    rv.m_Len = other.m_Len;
+    rv.append_words(m_Words.data(), m_Len);
+    return rv;
 }
 
 namespace pinepp {
     std::ostream &operator<<(std::ostream &os, const bit_pattern &pattern) {
+        const bool hex = (os.flags() & std::ios_base::basefield) == std::ios_base::hex;
         if (pattern.m_Len == 0)
             return os;
+        if (hex && os.flags() & std::ios_base::showbase)
+            os.write("0x", 2);
 
-        for (size_t i = pattern.m_Len; i != 0; i--)
-            os << ((pattern.m_RawBytes[(i - 1) / 8] & (1 << ((i - 1) % 8))) > 0 ? 1 : 0);
-
+        // CHUNKS END AT MULTIPLES OF THE BUFFER SIZE, SO ALL BUT THE MOST SIGNIFICANT ONE ARE WHOLE BYTES
+        char buffer[4096];
+        for (auto last = hex ? (pattern.m_Len + 3) / 4 : pattern.m_Len; last > 0;) {
+            const auto first = (last - 1) / sizeof(buffer) * sizeof(buffer);
+            if (hex)
+                write_hex(pattern.m_Words.data(), first, last, buffer);
+            else
+                write_binary(pattern.m_Words.data(), first, last, buffer);
+            os.write(buffer, static_cast<std::streamsize>(last - first));
+            last = first;
+        }
         return os;
     }
 }
@@ -237,6 +1264,10 @@ pinepp::bit_pattern::iterator pinepp::bit_pattern::end() const {
     return iterator{m_Len, this};
 }
 
+pinepp::bit_pattern::set_bit_range pinepp::bit_pattern::set_bits() const noexcept {
+    return set_bit_range{m_Words.data(), m_Words.size()};
+}
+
 
 pinepp::bit_pattern::iterator& pinepp::bit_pattern::iterator::operator++() {
     m_Index++;
@@ -252,5 +1283,5 @@ bool pinepp::bit_pattern::iterator::operator!=(pinepp::bit_pattern::iterator oth
 }
 
 int pinepp::bit_pattern::iterator::operator*() const {
-    return mp_BitPattern->m_RawBytes[m_Index / 8] & (1 << (m_Index % 8)) ? 1 : 0;
+    return static_cast<int>(mp_BitPattern->m_Words[m_Index / 64] >> (m_Index % 64) & 1);
 }
\ No newline at end of file
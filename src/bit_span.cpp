@@ -0,0 +1,244 @@
+//
+// Created by konstantin on 17.10.26.
+//
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+#include "bit_span.hpp"
+
+namespace {
+    /**
+     * @returns A mask of the \p n <= 64 least significant bits
+     */
+    inline uint64_t low_bits(size_t n) {
+        return n >= 64 ? ~uint64_t{0} : (uint64_t{1} << n) - 1;
+    }
+
+    /**
+     * @returns The \p n <= 64 bits of \p words starting at bit \p pos, in the lowest bits of the result. Only reads
+     * the words those bits lie in.
+     */
+    inline uint64_t load_bits(const uint64_t* words, size_t pos, size_t n) {
+        const auto word = pos / 64;
+        const auto shift = static_cast<unsigned>(pos % 64);
+        uint64_t bits = words[word] >> shift;
+        if (shift != 0 && shift + n > 64)
+            bits |= words[word + 1] << (64 - shift);
+        return bits & low_bits(n);
+    }
+
+    /**
+     * @details Splits the \p n bits starting at bit \p first into the partial words at its edges, passed to
+     * \p edge with the index of the word and a mask of the bits in range, and the whole words in between, passed
+     * to \p middle with the index of the first word and their amount.
+     */
+    template <typename Edge, typename Middle>
+    void visit_range(size_t first, size_t n, Edge&& edge, Middle&& middle) {
+        if (n == 0)
+            return;
+        auto word = first / 64;
+        const auto shift = first % 64;
+        if (shift != 0 || n < 64) {
+            const auto head = std::min<size_t>(n, 64 - shift);
+            edge(word, low_bits(head) << shift);
+            word++;
+            n -= head;
+        }
+        if (n >= 64)
+            middle(word, n / 64);
+        if (n % 64 != 0)
+            edge(word + n / 64, low_bits(n % 64));
+    }
+
+    /**
+     * @details Combines the \p n bits of \p src starting at bit \p src_first into the bits of \p dst starting at
+     * bit \p dst_first with \p op. If the whole words of \p dst line up with words of \p src, they are handed to
+     * the SIMD \p Kernel, otherwise every word of \p src is put together from two with a funnel shift.
+     */
+    template <typename Kernel, typename Op>
+    void combine(uint64_t* dst, size_t dst_first, const uint64_t* src, size_t src_first, size_t n, Op op) {
+        visit_range(dst_first, n, [&](size_t word, uint64_t mask) {
+            const auto shift = static_cast<unsigned>(std::countr_zero(mask));
+            const auto pos = src_first + (word * 64 + shift - dst_first);
+            const auto bits = load_bits(src, pos, static_cast<size_t>(std::popcount(mask))) << shift;
+            dst[word] = (dst[word] & ~mask) | (op(dst[word], bits) & mask);
+        }, [&](size_t word, size_t count) {
+            const auto pos = src_first + (word * 64 - dst_first);
+            const auto* from = src + pos / 64;
+            const auto shift = static_cast<unsigned>(pos % 64);
+            if (shift == 0) {
+                Kernel::apply(dst + word, dst + word, from, count);
+                return;
+            }
+            // THE LAST BIT OF EVERY WHOLE WORD LIES IN from[i + 1], SO THIS NEVER READS PAST THE SOURCE RANGE
+            for (size_t i = 0; i < count; ++i)
+                dst[word + i] = op(dst[word + i], from[i] >> shift | from[i + 1] << (64 - shift));
+        });
+    }
+
+    /**
+     * @brief Replaces the destination words with the source words, for assign
+     */
+    struct copy_words {
+        static void apply(uint64_t* dst, const uint64_t*, const uint64_t* b, size_t n) {
+            std::memmove(dst, b, n * sizeof(uint64_t));
+        }
+    };
+
+    [[noreturn]] void throw_size_mismatch() {
+        throw std::invalid_argument{"Both bit spans need to be of the same size"};
+    }
+}
+
+template <typename Word>
+pinepp::basic_bit_span<Word>::basic_bit_span(Word* words, size_t offset, size_t len) noexcept
+        : mp_Words(words), m_Offset(offset), m_Len(len) {}
+
+template <typename Word>
+pinepp::basic_bit_span<Word>::basic_bit_span(pattern_type& pattern) noexcept
+        : mp_Words(pattern.m_Words.data()), mp_Pattern(&pattern), m_Len(pattern.m_Len) {}
+
+template <typename Word>
+pinepp::basic_bit_span<Word>::basic_bit_span(pattern_type& pattern, size_t offset, size_t len)
+        : basic_bit_span(pattern) {
+    check_range(offset, len);
+    m_Offset = offset;
+    m_Len = len;
+}
+
+template <typename Word>
+void pinepp::basic_bit_span<Word>::check_range(size_t first, size_t n) const {
+    if (first > m_Len || n > m_Len - first)
+        throw std::out_of_range{"Range is out of range of the bit span"};
+}
+
+template <typename Word>
+void pinepp::basic_bit_span<Word>::invalidate() const noexcept {
+    if constexpr (!std::is_const_v<Word>) {
+        if (mp_Pattern != nullptr)
+            mp_Pattern->mp_RankIndex.reset();
+    }
+}
+
+template <typename Word>
+pinepp::basic_bit_span<Word> pinepp::basic_bit_span<Word>::subspan(size_t first, size_t n) const {
+    check_range(first, n);
+    auto rv = *this;
+    rv.m_Offset += first;
+    rv.m_Len = n;
+    return rv;
+}
+
+template <typename Word>
+size_t pinepp::basic_bit_span<Word>::count() const noexcept {
+    size_t rv = 0;
+    visit_range(m_Offset, m_Len, [&](size_t word, uint64_t mask) {
+        rv += static_cast<size_t>(std::popcount(mp_Words[word] & mask));
+    }, [&](size_t word, size_t count) {
+        rv += bit_count_words::apply(mp_Words + word, count);
+    });
+    return rv;
+}
+
+template <typename Word>
+size_t pinepp::basic_bit_span<Word>::count_range(size_t first, size_t n) const {
+    return subspan(first, n).count();
+}
+
+template <typename Word>
+pinepp::bit_pattern pinepp::basic_bit_span<Word>::to_bit_pattern() const {
+    bit_pattern rv{m_Len};
+    bit_span{rv}.assign(*this);
+    return rv;
+}
+
+template <typename Word>
+void pinepp::basic_bit_span<Word>::set_bit(size_t index, bool value) const requires (!std::is_const_v<Word>) {
+    if (index >= m_Len)
+        throw std::out_of_range{"Index is out of range of the bit span"};
+    invalidate();
+    const auto bit = m_Offset + index;
+    const auto mask = uint64_t{1} << (bit % 64);
+    mp_Words[bit / 64] = value ? mp_Words[bit / 64] | mask : mp_Words[bit / 64] & ~mask;
+}
+
+template <typename Word>
+void pinepp::basic_bit_span<Word>::set_range(size_t first, size_t n) const requires (!std::is_const_v<Word>) {
+    check_range(first, n);
+    invalidate();
+    visit_range(m_Offset + first, n, [&](size_t word, uint64_t mask) {
+        mp_Words[word] |= mask;
+    }, [&](size_t word, size_t count) {
+        std::fill_n(mp_Words + word, count, ~uint64_t{0});
+    });
+}
+
+template <typename Word>
+void pinepp::basic_bit_span<Word>::reset_range(size_t first, size_t n) const requires (!std::is_const_v<Word>) {
+    check_range(first, n);
+    invalidate();
+    visit_range(m_Offset + first, n, [&](size_t word, uint64_t mask) {
+        mp_Words[word] &= ~mask;
+    }, [&](size_t word, size_t count) {
+        std::fill_n(mp_Words + word, count, 0);
+    });
+}
+
+template <typename Word>
+void pinepp::basic_bit_span<Word>::flip_range(size_t first, size_t n) const requires (!std::is_const_v<Word>) {
+    check_range(first, n);
+    invalidate();
+    visit_range(m_Offset + first, n, [&](size_t word, uint64_t mask) {
+        mp_Words[word] ^= mask;
+    }, [&](size_t word, size_t count) {
+        bit_not_words::apply(mp_Words + word, mp_Words + word, count);
+    });
+}
+
+template <typename Word>
+void pinepp::basic_bit_span<Word>::assign(basic_bit_span<const uint64_t> other) const
+        requires (!std::is_const_v<Word>) {
+    if (other.m_Len != m_Len)
+        throw_size_mismatch();
+    invalidate();
+    combine<copy_words>(mp_Words, m_Offset, other.mp_Words, other.m_Offset, m_Len,
+                        [](uint64_t, uint64_t b) { return b; });
+}
+
+template <typename Word>
+const pinepp::basic_bit_span<Word>& pinepp::basic_bit_span<Word>::operator&=(basic_bit_span<const uint64_t> other)
+        const requires (!std::is_const_v<Word>) {
+    if (other.m_Len != m_Len)
+        throw_size_mismatch();
+    invalidate();
+    combine<bit_and_words>(mp_Words, m_Offset, other.mp_Words, other.m_Offset, m_Len,
+                           [](uint64_t a, uint64_t b) { return a & b; });
+    return *this;
+}
+
+template <typename Word>
+const pinepp::basic_bit_span<Word>& pinepp::basic_bit_span<Word>::operator|=(basic_bit_span<const uint64_t> other)
+        const requires (!std::is_const_v<Word>) {
+    if (other.m_Len != m_Len)
+        throw_size_mismatch();
+    invalidate();
+    combine<bit_or_words>(mp_Words, m_Offset, other.mp_Words, other.m_Offset, m_Len,
+                          [](uint64_t a, uint64_t b) { return a | b; });
+    return *this;
+}
+
+template <typename Word>
+const pinepp::basic_bit_span<Word>& pinepp::basic_bit_span<Word>::operator^=(basic_bit_span<const uint64_t> other)
+        const requires (!std::is_const_v<Word>) {
+    if (other.m_Len != m_Len)
+        throw_size_mismatch();
+    invalidate();
+    combine<bit_xor_words>(mp_Words, m_Offset, other.mp_Words, other.m_Offset, m_Len,
+                           [](uint64_t a, uint64_t b) { return a ^ b; });
+    return *this;
+}
+
+template class pinepp::basic_bit_span<uint64_t>;
+template class pinepp::basic_bit_span<const uint64_t>;
@@ -0,0 +1,634 @@
+//
+// Created by konstantin on 17.10.26.
+//
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <stdexcept>
+#include "compressed_bit_pattern.hpp"
+
+/**
+ * @details Gives the algorithms below access to the private parts of compressed_bit_pattern.
+ */
+struct pinepp::compressed_bit_pattern_ops {
+    using container = compressed_bit_pattern::container;
+    enum class operation : uint8_t { AND, OR, XOR };
+
+    static compressed_bit_pattern combine(const compressed_bit_pattern& a, const compressed_bit_pattern& b,
+                                          operation op);
+};
+
+namespace {
+    using container = pinepp::compressed_bit_pattern_ops::container;
+    using operation = pinepp::compressed_bit_pattern_ops::operation;
+    using chunk_words = std::array<uint64_t, 1024>;
+
+    constexpr size_t CHUNK_BITS = 65536;
+    constexpr size_t CHUNK_WORDS = CHUNK_BITS / 64;
+    /**
+     * @brief The largest cardinality stored in an array, at which the array takes as much memory as a bitmap
+     */
+    constexpr size_t ARRAY_MAX = 4096;
+
+    /**
+     * @returns The amount of bits in the chunk \p key of a pattern with \p len bits
+     */
+    size_t chunk_bits(size_t len, size_t key) {
+        return std::min(CHUNK_BITS, len - key * CHUNK_BITS);
+    }
+
+    /**
+     * @details Sets the bits in [\p begin, \p end) of \p words to 1.
+     */
+    void set_range(uint64_t* words, size_t begin, size_t end) {
+        if (begin >= end)
+            return;
+        const auto first = begin / 64;
+        const auto last = (end - 1) / 64;
+        const auto first_mask = ~uint64_t{0} << (begin % 64);
+        const auto last_mask = ~uint64_t{0} >> (63 - (end - 1) % 64);
+        if (first == last) {
+            words[first] |= first_mask & last_mask;
+            return;
+        }
+        words[first] |= first_mask;
+        std::fill(words + first + 1, words + last, ~uint64_t{0});
+        words[last] |= last_mask;
+    }
+
+    /**
+     * @returns The position of the first bit at or after \p pos that equals \p value, or CHUNK_BITS
+     */
+    size_t find_in_words(const uint64_t* words, size_t pos, bool value) {
+        if (pos >= CHUNK_BITS)
+            return CHUNK_BITS;
+        size_t i = pos / 64;
+        uint64_t word = (value ? words[i] : ~words[i]) & (~uint64_t{0} << (pos % 64));
+        while (word == 0) {
+            if (++i == CHUNK_WORDS)
+                return CHUNK_BITS;
+            word = value ? words[i] : ~words[i];
+        }
+        return i * 64 + static_cast<size_t>(std::countr_zero(word));
+    }
+
+    /**
+     * @details ORs the bits of \p c into the first \p count words of \p words.
+     */
+    void write_words(const container& c, uint64_t* words, size_t count) {
+        switch (c.type) {
+            case container::kind::ARRAY:
+                for (auto v : c.values)
+                    words[v / 64] |= uint64_t{1} << (v % 64);
+                break;
+            case container::kind::BITMAP:
+                for (size_t i = 0; i < count; ++i)
+                    words[i] |= c.words[i];
+                break;
+            case container::kind::RUN:
+                for (size_t i = 0; i < c.values.size(); i += 2)
+                    set_range(words, c.values[i], size_t{c.values[i]} + c.values[i + 1] + 1);
+                break;
+        }
+    }
+
+    void to_words(const container& c, uint64_t* words) {
+        std::fill_n(words, CHUNK_WORDS, 0);
+        write_words(c, words, CHUNK_WORDS);
+    }
+
+    /**
+     * @details Picks the smallest container for the bits of a chunk: runs take 4 bytes per run, arrays 2 bytes per
+     * set bit and bitmaps 8 KiB.
+     * @returns The container, whose cardinality is 0 if no bit is set
+     */
+    container from_words(const uint64_t* words) {
+        size_t cardinality = 0;
+        size_t runs = 0;
+        uint64_t carry = 0;
+        for (size_t i = 0; i < CHUNK_WORDS; ++i) {
+            const auto word = words[i];
+            cardinality += static_cast<size_t>(std::popcount(word));
+            // A RUN STARTS AT EVERY SET BIT WHOSE LOWER NEIGHBOUR IS NOT SET
+            runs += static_cast<size_t>(std::popcount(word & ~(word << 1 | carry)));
+            carry = word >> 63;
+        }
+
+        container rv{};
+        rv.cardinality = static_cast<uint32_t>(cardinality);
+        if (cardinality == 0)
+            return rv;
+        const auto array_bytes = cardinality <= ARRAY_MAX ? 2 * cardinality : CHUNK_BITS;
+        if (4 * runs < std::min(array_bytes, CHUNK_BITS / 8)) {
+            rv.type = container::kind::RUN;
+            rv.values.reserve(2 * runs);
+            for (size_t pos = find_in_words(words, 0, true); pos < CHUNK_BITS;
+                 pos = find_in_words(words, pos, true)) {
+                const auto end = find_in_words(words, pos, false);
+                rv.values.push_back(static_cast<uint16_t>(pos));
+                rv.values.push_back(static_cast<uint16_t>(end - pos - 1));
+                pos = end;
+            }
+        } else if (cardinality <= ARRAY_MAX) {
+            rv.type = container::kind::ARRAY;
+            rv.values.reserve(cardinality);
+            for (size_t i = 0; i < CHUNK_WORDS; ++i) {
+                for (auto word = words[i]; word != 0; word &= word - 1)
+                    rv.values.push_back(static_cast<uint16_t>(i * 64 + std::countr_zero(word)));
+            }
+        } else {
+            rv.type = container::kind::BITMAP;
+            rv.words.assign(words, words + CHUNK_WORDS);
+        }
+        return rv;
+    }
+
+    container full_container(size_t bits) {
+        container rv{};
+        rv.type = container::kind::RUN;
+        rv.cardinality = static_cast<uint32_t>(bits);
+        rv.values = {0, static_cast<uint16_t>(bits - 1)};
+        return rv;
+    }
+
+    /**
+     * @returns The position of the first set bit at or after \p pos or CHUNK_BITS if there is none
+     */
+    size_t find_in_container(const container& c, size_t pos) {
+        switch (c.type) {
+            case container::kind::ARRAY: {
+                const auto it = std::lower_bound(c.values.begin(), c.values.end(), pos);
+                return it == c.values.end() ? CHUNK_BITS : *it;
+            }
+            case container::kind::BITMAP:
+                return find_in_words(c.words.data(), pos, true);
+            case container::kind::RUN:
+                for (size_t i = 0; i < c.values.size(); i += 2) {
+                    if (size_t{c.values[i]} + c.values[i + 1] >= pos)
+                        return std::max<size_t>(c.values[i], pos);
+                }
+                return CHUNK_BITS;
+        }
+        return CHUNK_BITS;
+    }
+
+    bool contains(const container& c, size_t pos) {
+        return find_in_container(c, pos) == pos;
+    }
+
+    /**
+     * @returns The position of the last set bit of \p c, which must not be empty
+     */
+    size_t last_bit(const container& c) {
+        switch (c.type) {
+            case container::kind::ARRAY:
+                return c.values.back();
+            case container::kind::BITMAP:
+                for (size_t i = CHUNK_WORDS; i-- > 0;) {
+                    if (c.words[i] != 0)
+                        return i * 64 + 63 - static_cast<size_t>(std::countl_zero(c.words[i]));
+                }
+                return 0;
+            case container::kind::RUN:
+                return size_t{c.values[c.values.size() - 2]} + c.values.back();
+        }
+        return 0;
+    }
+
+    /**
+     * @details Clears the bits of \p c at positions of at least \p bits.
+     */
+    void truncate(container& c, size_t bits) {
+        if (c.cardinality == 0 || last_bit(c) < bits)
+            return;
+        chunk_words words;
+        to_words(c, words.data());
+        std::fill(words.begin() + static_cast<ptrdiff_t>((bits + 63) / 64), words.end(), 0);
+        if (bits % 64 != 0)
+            words[bits / 64] &= (uint64_t{1} << (bits % 64)) - 1;
+        c = from_words(words.data());
+    }
+
+    container array_container(std::vector<uint16_t>&& values) {
+        container rv{};
+        rv.type = container::kind::ARRAY;
+        rv.cardinality = static_cast<uint32_t>(values.size());
+        rv.values = std::move(values);
+        return rv;
+    }
+
+    container combine_containers(const container& a, const container& b, operation op) {
+        using kind = container::kind;
+        // ARRAYS ARE MERGED OR FILTERED WITHOUT TOUCHING 8 KIB OF WORDS
+        if (a.type == kind::ARRAY && b.type == kind::ARRAY) {
+            std::vector<uint16_t> values;
+            switch (op) {
+                case operation::AND:
+                    std::set_intersection(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(),
+                                          std::back_inserter(values));
+                    return array_container(std::move(values));
+                case operation::OR:
+                    if (a.cardinality + b.cardinality > ARRAY_MAX)
+                        break;
+                    std::set_union(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(),
+                                   std::back_inserter(values));
+                    return array_container(std::move(values));
+                case operation::XOR:
+                    if (a.cardinality + b.cardinality > ARRAY_MAX)
+                        break;
+                    std::set_symmetric_difference(a.values.begin(), a.values.end(), b.values.begin(),
+                                                  b.values.end(), std::back_inserter(values));
+                    return array_container(std::move(values));
+            }
+        } else if (op == operation::AND && (a.type == kind::ARRAY || b.type == kind::ARRAY)) {
+            const auto& array = a.type == kind::ARRAY ? a : b;
+            const auto& other = a.type == kind::ARRAY ? b : a;
+            std::vector<uint16_t> values;
+            std::copy_if(array.values.begin(), array.values.end(), std::back_inserter(values),
+                         [&other](uint16_t v) { return contains(other, v); });
+            return array_container(std::move(values));
+        }
+
+        chunk_words words_a;
+        chunk_words words_b;
+        to_words(a, words_a.data());
+        to_words(b, words_b.data());
+        for (size_t i = 0; i < CHUNK_WORDS; ++i) {
+            switch (op) {
+                case operation::AND:
+                    words_a[i] &= words_b[i];
+                    break;
+                case operation::OR:
+                    words_a[i] |= words_b[i];
+                    break;
+                case operation::XOR:
+                    words_a[i] ^= words_b[i];
+                    break;
+            }
+        }
+        return from_words(words_a.data());
+    }
+
+    bool equal_containers(const container& a, const container& b) {
+        if (a.cardinality != b.cardinality)
+            return false;
+        if (a.type == b.type)
+            return a.values == b.values && a.words == b.words;
+        chunk_words words_a;
+        chunk_words words_b;
+        to_words(a, words_a.data());
+        to_words(b, words_b.data());
+        return words_a == words_b;
+    }
+
+    size_t container_bytes(const container& c) {
+        return sizeof(container) + sizeof(size_t) + c.values.capacity() * sizeof(uint16_t) +
+               c.words.capacity() * sizeof(uint64_t);
+    }
+}
+
+pinepp::compressed_bit_pattern pinepp::compressed_bit_pattern_ops::combine(const compressed_bit_pattern& a,
+                                                                           const compressed_bit_pattern& b,
+                                                                           operation op) {
+    compressed_bit_pattern rv{std::min(a.m_Len, b.m_Len)};
+    const auto chunks = (rv.m_Len + CHUNK_BITS - 1) / CHUNK_BITS;
+    auto push = [&rv, chunks](size_t key, container&& c) {
+        if (key + 1 == chunks)
+            truncate(c, chunk_bits(rv.m_Len, key));
+        if (c.cardinality == 0)
+            return;
+        rv.m_Keys.push_back(key);
+        rv.m_Containers.push_back(std::move(c));
+    };
+
+    size_t i = 0;
+    size_t j = 0;
+    while (i < a.m_Keys.size() && j < b.m_Keys.size() && std::min(a.m_Keys[i], b.m_Keys[j]) < chunks) {
+        if (a.m_Keys[i] < b.m_Keys[j]) {
+            if (op != operation::AND)
+                push(a.m_Keys[i], container{a.m_Containers[i]});
+            ++i;
+        } else if (b.m_Keys[j] < a.m_Keys[i]) {
+            if (op != operation::AND)
+                push(b.m_Keys[j], container{b.m_Containers[j]});
+            ++j;
+        } else {
+            push(a.m_Keys[i], combine_containers(a.m_Containers[i], b.m_Containers[j], op));
+            ++i;
+            ++j;
+        }
+    }
+    // CHUNKS ONLY ONE PATTERN HAS ARE COPIED, UNLESS THE RESULT IS AN INTERSECTION
+    if (op != operation::AND) {
+        for (; i < a.m_Keys.size() && a.m_Keys[i] < chunks; ++i)
+            push(a.m_Keys[i], container{a.m_Containers[i]});
+        for (; j < b.m_Keys.size() && b.m_Keys[j] < chunks; ++j)
+            push(b.m_Keys[j], container{b.m_Containers[j]});
+    }
+    return rv;
+}
+
+pinepp::compressed_bit_pattern::compressed_bit_pattern(size_t n) : m_Len(n) {}
+
+pinepp::compressed_bit_pattern::compressed_bit_pattern(const bit_pattern& pattern) : m_Len(pattern.m_Len) {
+    const auto& words = pattern.m_Words;
+    for (size_t key = 0; key * CHUNK_WORDS < words.size(); ++key) {
+        const auto first = key * CHUNK_WORDS;
+        container c;
+        if (first + CHUNK_WORDS <= words.size()) {
+            c = from_words(words.data() + first);
+        } else {
+            chunk_words tail{};
+            std::copy(words.data() + first, words.data() + words.size(), tail.begin());
+            c = from_words(tail.data());
+        }
+        if (c.cardinality == 0)
+            continue;
+        m_Keys.push_back(key);
+        m_Containers.push_back(std::move(c));
+    }
+}
+
+pinepp::bit_pattern pinepp::compressed_bit_pattern::to_bit_pattern() const {
+    bit_pattern rv{m_Len};
+    auto& words = rv.m_Words;
+    for (size_t i = 0; i < m_Keys.size(); ++i) {
+        const auto first = m_Keys[i] * CHUNK_WORDS;
+        write_words(m_Containers[i], words.data() + first, std::min(CHUNK_WORDS, words.size() - first));
+    }
+    return rv;
+}
+
+size_t pinepp::compressed_bit_pattern::size() const noexcept {
+    return m_Len;
+}
+
+size_t pinepp::compressed_bit_pattern::memory_usage() const noexcept {
+    size_t rv = 0;
+    for (const auto& c : m_Containers)
+        rv += container_bytes(c);
+    return rv;
+}
+
+size_t pinepp::compressed_bit_pattern::count() const noexcept {
+    size_t rv = 0;
+    for (const auto& c : m_Containers)
+        rv += c.cardinality;
+    return rv;
+}
+
+bool pinepp::compressed_bit_pattern::any() const noexcept {
+    // EMPTY CONTAINERS ARE NEVER KEPT
+    return !m_Keys.empty();
+}
+
+bool pinepp::compressed_bit_pattern::none() const noexcept {
+    return m_Keys.empty();
+}
+
+size_t pinepp::compressed_bit_pattern::find_first() const noexcept {
+    return m_Keys.empty() ? npos : m_Keys.front() * CHUNK_BITS + find_in_container(m_Containers.front(), 0);
+}
+
+size_t pinepp::compressed_bit_pattern::find_next(size_t index) const noexcept {
+    if (m_Len == 0 || index >= m_Len - 1)
+        return npos;
+    const auto from = index + 1;
+    auto i = static_cast<size_t>(std::lower_bound(m_Keys.begin(), m_Keys.end(), from / CHUNK_BITS) - m_Keys.begin());
+    for (; i < m_Keys.size(); ++i) {
+        const auto pos = m_Keys[i] == from / CHUNK_BITS ? from % CHUNK_BITS : 0;
+        const auto found = find_in_container(m_Containers[i], pos);
+        if (found < CHUNK_BITS)
+            return m_Keys[i] * CHUNK_BITS + found;
+    }
+    return npos;
+}
+
+void pinepp::compressed_bit_pattern::set_bit(size_t index, bool value) {
+    if (index >= m_Len)
+        throw std::out_of_range{"Index is out of range of the compressed_bit_pattern"};
+    const auto key = index / CHUNK_BITS;
+    const auto pos = static_cast<uint16_t>(index % CHUNK_BITS);
+    const auto it = std::lower_bound(m_Keys.begin(), m_Keys.end(), key);
+    const auto i = static_cast<size_t>(it - m_Keys.begin());
+    if (it == m_Keys.end() || *it != key) {
+        if (!value)
+            return;
+        m_Keys.insert(it, key);
+        m_Containers.insert(m_Containers.begin() + static_cast<ptrdiff_t>(i), array_container({pos}));
+        return;
+    }
+
+    auto& c = m_Containers[i];
+    if (contains(c, pos) == value)
+        return;
+    switch (c.type) {
+        case container::kind::ARRAY: {
+            const auto at = std::lower_bound(c.values.begin(), c.values.end(), pos);
+            if (value)
+                c.values.insert(at, pos);
+            else
+                c.values.erase(at);
+            c.cardinality = static_cast<uint32_t>(c.values.size());
+            if (c.cardinality > ARRAY_MAX) {
+                chunk_words words;
+                to_words(c, words.data());
+                c = from_words(words.data());
+            }
+            break;
+        }
+        case container::kind::BITMAP:
+            c.words[pos / 64] ^= uint64_t{1} << (pos % 64);
+            c.cardinality = value ? c.cardinality + 1 : c.cardinality - 1;
+            if (c.cardinality <= ARRAY_MAX)
+                c = from_words(c.words.data());
+            break;
+        case container::kind::RUN: {
+            // RUNS ARE SPLIT OR MERGED BY REBUILDING THE CHUNK
+            chunk_words words;
+            to_words(c, words.data());
+            words[pos / 64] ^= uint64_t{1} << (pos % 64);
+            c = from_words(words.data());
+            break;
+        }
+    }
+    if (c.cardinality == 0) {
+        m_Keys.erase(it);
+        m_Containers.erase(m_Containers.begin() + static_cast<ptrdiff_t>(i));
+    }
+}
+
+int pinepp::compressed_bit_pattern::operator[](size_t index) const {
+    const auto key = index / CHUNK_BITS;
+    const auto it = std::lower_bound(m_Keys.begin(), m_Keys.end(), key);
+    if (it == m_Keys.end() || *it != key)
+        return 0;
+    return contains(m_Containers[static_cast<size_t>(it - m_Keys.begin())], index % CHUNK_BITS) ? 1 : 0;
+}
+
+pinepp::compressed_bit_pattern pinepp::compressed_bit_pattern::operator&(const compressed_bit_pattern& other) const {
+    return compressed_bit_pattern_ops::combine(*this, other, compressed_bit_pattern_ops::operation::AND);
+}
+
+pinepp::compressed_bit_pattern pinepp::compressed_bit_pattern::operator|(const compressed_bit_pattern& other) const {
+    return compressed_bit_pattern_ops::combine(*this, other, compressed_bit_pattern_ops::operation::OR);
+}
+
+pinepp::compressed_bit_pattern pinepp::compressed_bit_pattern::operator^(const compressed_bit_pattern& other) const {
+    return compressed_bit_pattern_ops::combine(*this, other, compressed_bit_pattern_ops::operation::XOR);
+}
+
+pinepp::compressed_bit_pattern pinepp::compressed_bit_pattern::operator~() const {
+    compressed_bit_pattern rv{m_Len};
+    const auto chunks = (m_Len + CHUNK_BITS - 1) / CHUNK_BITS;
+    size_t i = 0;
+    for (size_t key = 0; key < chunks; ++key) {
+        const auto bits = chunk_bits(m_Len, key);
+        container c;
+        if (i < m_Keys.size() && m_Keys[i] == key) {
+            chunk_words words;
+            to_words(m_Containers[i++], words.data());
+            for (auto& word : words)
+                word = ~word;
+            c = from_words(words.data());
+            truncate(c, bits);
+        } else {
+            c = full_container(bits);
+        }
+        if (c.cardinality == 0)
+            continue;
+        rv.m_Keys.push_back(key);
+        rv.m_Containers.push_back(std::move(c));
+    }
+    return rv;
+}
+
+bool pinepp::compressed_bit_pattern::operator==(const compressed_bit_pattern& other) const {
+    if (m_Len != other.m_Len || m_Keys != other.m_Keys)
+        return false;
+    for (size_t i = 0; i < m_Containers.size(); ++i) {
+        if (!equal_containers(m_Containers[i], other.m_Containers[i]))
+            return false;
+    }
+    return true;
+}
+
+bool pinepp::compressed_bit_pattern::operator!=(const compressed_bit_pattern& other) const {
+    return !(*this == other);
+}
+
+namespace pinepp {
+    std::ostream& operator<<(std::ostream& os, const compressed_bit_pattern& pattern) {
+        return os << pattern.to_bit_pattern();
+    }
+}
+
+pinepp::compressed_bit_pattern::iterator::iterator(size_t index, const compressed_bit_pattern* ptr)
+        : mp_Pattern(ptr), m_Index(index) {}
+
+pinepp::compressed_bit_pattern::iterator pinepp::compressed_bit_pattern::begin() const {
+    return iterator{0, this};
+}
+
+pinepp::compressed_bit_pattern::iterator pinepp::compressed_bit_pattern::end() const {
+    return iterator{m_Len, this};
+}
+
+pinepp::compressed_bit_pattern::iterator& pinepp::compressed_bit_pattern::iterator::operator++() {
+    m_Index++;
+    return *this;
+}
+
+bool pinepp::compressed_bit_pattern::iterator::operator==(iterator other) const {
+    return m_Index == other.m_Index;
+}
+
+bool pinepp::compressed_bit_pattern::iterator::operator!=(iterator other) const {
+    return m_Index != other.m_Index;
+}
+
+int pinepp::compressed_bit_pattern::iterator::operator*() const {
+    return (*mp_Pattern)[m_Index];
+}
+
+pinepp::compressed_bit_pattern::set_bit_iterator::set_bit_iterator(const compressed_bit_pattern* ptr,
+                                                                   size_t chunk) noexcept
+        : mp_Pattern(ptr), m_Chunk(chunk) {
+    enter_chunk();
+}
+
+void pinepp::compressed_bit_pattern::set_bit_iterator::enter_chunk() noexcept {
+    m_Slot = 0;
+    m_Position = 0;
+    m_Word = 0;
+    if (m_Chunk >= mp_Pattern->m_Keys.size())
+        return;
+    // CONTAINERS ARE NEVER EMPTY, SO THE CHUNK HAS A FIRST BIT
+    const auto& c = mp_Pattern->m_Containers[m_Chunk];
+    if (c.type != container::kind::BITMAP) {
+        m_Position = c.values.front();
+        return;
+    }
+    while (c.words[m_Slot] == 0)
+        m_Slot++;
+    m_Word = c.words[m_Slot];
+    m_Position = m_Slot * 64 + static_cast<size_t>(std::countr_zero(m_Word));
+}
+
+size_t pinepp::compressed_bit_pattern::set_bit_iterator::operator*() const noexcept {
+    return mp_Pattern->m_Keys[m_Chunk] * CHUNK_BITS + m_Position;
+}
+
+pinepp::compressed_bit_pattern::set_bit_iterator&
+pinepp::compressed_bit_pattern::set_bit_iterator::operator++() noexcept {
+    const auto& c = mp_Pattern->m_Containers[m_Chunk];
+    switch (c.type) {
+        case container::kind::ARRAY:
+            if (++m_Slot < c.values.size()) {
+                m_Position = c.values[m_Slot];
+                return *this;
+            }
+            break;
+        case container::kind::BITMAP:
+            // CLEARS THE LOWEST SET BIT
+            m_Word &= m_Word - 1;
+            while (m_Word == 0 && ++m_Slot < CHUNK_WORDS)
+                m_Word = c.words[m_Slot];
+            if (m_Word != 0) {
+                m_Position = m_Slot * 64 + static_cast<size_t>(std::countr_zero(m_Word));
+                return *this;
+            }
+            break;
+        case container::kind::RUN:
+            if (m_Position < size_t{c.values[m_Slot]} + c.values[m_Slot + 1]) {
+                m_Position++;
+                return *this;
+            }
+            m_Slot += 2;
+            if (m_Slot < c.values.size()) {
+                m_Position = c.values[m_Slot];
+                return *this;
+            }
+            break;
+    }
+    m_Chunk++;
+    enter_chunk();
+    return *this;
+}
+
+pinepp::compressed_bit_pattern::set_bit_iterator
+pinepp::compressed_bit_pattern::set_bit_iterator::operator++(int) noexcept {
+    auto rv = *this;
+    ++*this;
+    return rv;
+}
+
+bool pinepp::compressed_bit_pattern::set_bit_iterator::operator==(const set_bit_iterator& other) const noexcept {
+    // WITHIN A CHUNK THE POSITION IDENTIFIES THE BIT, AND THE END HAS POSITION 0
+    return m_Chunk == other.m_Chunk && m_Position == other.m_Position;
+}
+
+pinepp::compressed_bit_pattern::set_bit_range pinepp::compressed_bit_pattern::set_bits() const noexcept {
+    return set_bit_range{this};
+}
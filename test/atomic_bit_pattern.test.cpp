@@ -0,0 +1,108 @@
+//
+// Created by konstantin on 17.10.26.
+//
+#include <thread>
+#include <vector>
+#include "atomic_bit_pattern.hpp"
+#include "gtest/gtest.h"
+
+TEST(AtomicBitPattern, TestsSetsAndResetsSingleBits) {
+    using namespace pinepp;
+    atomic_bit_pattern bits{130};
+    EXPECT_EQ(130, bits.size());
+    EXPECT_EQ(3, bits.word_count());
+    EXPECT_FALSE(bits.test(129));
+    EXPECT_FALSE(bits.test_and_set(129));
+    EXPECT_TRUE(bits.test_and_set(129));
+    EXPECT_TRUE(bits.test(129));
+    EXPECT_TRUE(bits.test_and_reset(129));
+    EXPECT_FALSE(bits.test_and_reset(129));
+    bits.set_bit(64, true);
+    bits.set_bit(0, true);
+    bits.set_bit(0, false);
+    EXPECT_EQ(uint64_t{1}, bits.load_word(1));
+
+    EXPECT_THROW(static_cast<void>(bits.test(130)), std::out_of_range);
+    EXPECT_THROW(bits.test_and_set(130), std::out_of_range);
+    EXPECT_THROW(bits.set_bit(200, false), std::out_of_range);
+    EXPECT_THROW(static_cast<void>(bits.load_word(3)), std::out_of_range);
+    EXPECT_THROW(bits.fetch_or_word(3, 1), std::out_of_range);
+}
+
+TEST(AtomicBitPattern, WordOperationsKeepTheBitsPastTheSizeCleared) {
+    using namespace pinepp;
+    atomic_bit_pattern bits{100};
+    EXPECT_EQ(0, bits.fetch_or_word(1, ~uint64_t{0}));
+    EXPECT_EQ((uint64_t{1} << 36) - 1, bits.load_word(1));
+    EXPECT_EQ((uint64_t{1} << 36) - 1, bits.fetch_xor_word(1, ~uint64_t{0} << 32));
+    EXPECT_EQ(0xffffffff, bits.fetch_and_word(1, 0xff));
+    EXPECT_EQ(0xff, bits.load_word(1));
+    bits.fetch_or_word(0, 0x5);
+
+    const auto snapshot = bits.snapshot();
+    EXPECT_EQ(100, snapshot.size());
+    EXPECT_EQ(10, snapshot.count());
+    EXPECT_EQ(bit_pattern{std::string(28, '0') + "11111111" + std::string(61, '0') + "101"}, snapshot);
+}
+
+TEST(AtomicBitPattern, RoundTripsThroughABitPattern) {
+    using namespace pinepp;
+    bit_pattern pattern{size_t{1000}};
+    for (size_t i = 0; i < pattern.size(); i += 7)
+        pattern[i] = true;
+    atomic_bit_pattern bits{pattern};
+    EXPECT_TRUE(bits.test(994));
+    EXPECT_FALSE(bits.test(995));
+    EXPECT_EQ(pattern, bits.snapshot());
+
+    atomic_bit_pattern moved{std::move(bits)};
+    EXPECT_EQ(0, bits.size());
+    EXPECT_EQ(pattern, moved.snapshot(std::memory_order_acquire));
+    bits = std::move(moved);
+    EXPECT_EQ(pattern, bits.snapshot());
+    EXPECT_EQ(0, atomic_bit_pattern{0}.snapshot().size());
+}
+
+TEST(AtomicBitPattern, ConcurrentWritersNeverLoseUpdates) {
+    using namespace pinepp;
+    constexpr size_t BITS = 100'000;
+    const auto threads = std::max(4u, std::thread::hardware_concurrency());
+
+    // EVERY THREAD TRIES TO CLAIM EVERY BIT, BUT EACH BIT CAN ONLY BE CLAIMED ONCE
+    atomic_bit_pattern claimed{BITS};
+    std::vector<size_t> claims(threads);
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            for (size_t i = 0; i < BITS; ++i) {
+                const auto bit = (i + t * 7919) % BITS;
+                if (!claimed.test_and_set(bit, std::memory_order_relaxed))
+                    claims[t]++;
+            }
+        });
+    }
+    for (auto& worker : workers)
+        worker.join();
+    size_t total = 0;
+    for (auto c : claims)
+        total += c;
+    EXPECT_EQ(BITS, total);
+    EXPECT_EQ(BITS, claimed.snapshot().count());
+
+    // NEIGHBOURING BITS SHARE WORDS, SO THREADS WRITING INTERLEAVED BITS RACE ON EVERY WORD
+    atomic_bit_pattern interleaved{BITS};
+    workers.clear();
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            for (size_t i = t; i < BITS; i += threads)
+                interleaved.set_bit(i, true, std::memory_order_relaxed);
+            for (size_t i = t; i < BITS; i += 2 * threads)
+                interleaved.test_and_reset(i, std::memory_order_relaxed);
+        });
+    }
+    for (auto& worker : workers)
+        worker.join();
+    const auto snapshot = interleaved.snapshot();
+    for (size_t i = 0; i < BITS; ++i)
+        ASSERT_EQ(i % (2 * threads) >= threads, snapshot[i] == 1) << i;
+}
@@ -0,0 +1,65 @@
+//
+// Created by konstantin on 17.10.26.
+//
+
+#include "gtest/gtest.h"
+#include "base16.hpp"
+
+TEST(Base16EncodeFunction, EncodesTheTestVectorsOfRfc4648) {
+    using namespace pinepp;
+    EXPECT_EQ("", base16_encode(""));
+    EXPECT_EQ("66", base16_encode("f"));
+    EXPECT_EQ("666f6f626172", base16_encode("foobar"));
+    EXPECT_EQ("666F6F626172", base16_encode("foobar", base16_case::UPPER));
+    EXPECT_EQ("00ff7f80", base16_encode(std::string_view{"\x00\xff\x7f\x80", 4}));
+}
+
+TEST(Base16DecodeFunction, AcceptsBothCasesAndRejectsInvalidDigits) {
+    using namespace pinepp;
+    EXPECT_EQ("foobar", base16_decode("666f6f626172"));
+    EXPECT_EQ("foobar", base16_decode("666F6f626172"));
+    EXPECT_EQ("", base16_decode(""));
+    EXPECT_THROW(base16_decode("666"), std::invalid_argument);
+    EXPECT_THROW(base16_decode("6g"), std::invalid_argument);
+    EXPECT_THROW(base16_decode("6G"), std::invalid_argument);
+    EXPECT_THROW(base16_decode("@1"), std::invalid_argument);
+    EXPECT_THROW(base16_decode("/1"), std::invalid_argument);
+    EXPECT_THROW(base16_decode(":1"), std::invalid_argument);
+
+    char small[2];
+    EXPECT_THROW(base16_decode("666f6f", std::span{small}), std::invalid_argument);
+}
+
+TEST(Base16Kernels, AllSupportedKernelsProduceTheSameResultAsTheScalarKernel) {
+    using namespace pinepp;
+    const auto initial = base64_active_kernel();
+    std::string input;
+    for (int i = 0; i < 1000; ++i)
+        input.push_back(static_cast<char>((i * 7919 + 13) % 256));
+
+    ASSERT_TRUE(base64_select_kernel(base64_kernel::SCALAR));
+    std::vector<std::string> lower;
+    std::vector<std::string> upper;
+    for (size_t len = 0; len <= input.size(); len += 7) {
+        lower.push_back(base16_encode(input.substr(0, len)));
+        upper.push_back(base16_encode(input.substr(0, len), base16_case::UPPER));
+    }
+
+    for (auto kernel : {base64_kernel::SSE41, base64_kernel::AVX2, base64_kernel::AVX512}) {
+        if (!base64_select_kernel(kernel))
+            continue;
+        for (size_t len = 0, i = 0; len <= input.size(); len += 7, ++i) {
+            EXPECT_EQ(lower[i], base16_encode(input.substr(0, len)));
+            EXPECT_EQ(upper[i], base16_encode(input.substr(0, len), base16_case::UPPER));
+            EXPECT_EQ(input.substr(0, len), base16_decode(lower[i]));
+            EXPECT_EQ(input.substr(0, len), base16_decode(upper[i]));
+        }
+        // INVALID CHARACTERS INSIDE A BLOCK THE KERNEL WOULD PROCESS
+        for (char c : {'g', 'G', '/', ':', '@', '`', static_cast<char>(0xc3)}) {
+            std::string invalid = lower.back();
+            invalid[100] = c;
+            EXPECT_THROW(base16_decode(invalid), std::invalid_argument);
+        }
+    }
+    base64_select_kernel(initial);
+}
@@ -0,0 +1,90 @@
+//
+// Created by konstantin on 17.10.26.
+//
+
+#include "gtest/gtest.h"
+#include "base32.hpp"
+
+TEST(Base32, EncodesAndDecodesTheTestVectorsOfRfc4648) {
+    using namespace pinepp;
+    const std::pair<std::string, std::string> standard[] = {
+            {"", ""}, {"f", "MY======"}, {"fo", "MZXQ===="}, {"foo", "MZXW6==="}, {"foob", "MZXW6YQ="},
+            {"fooba", "MZXW6YTB"}, {"foobar", "MZXW6YTBOI======"}};
+    const std::pair<std::string, std::string> hex[] = {
+            {"", ""}, {"f", "CO======"}, {"fo", "CPNG===="}, {"foo", "CPNMU==="}, {"foob", "CPNMUOG="},
+            {"fooba", "CPNMUOJ1"}, {"foobar", "CPNMUOJ1E8======"}};
+    for (const auto& [str, encoding] : standard) {
+        EXPECT_EQ(encoding, base32::encode(str));
+        EXPECT_EQ(str, base32::decode(encoding));
+    }
+    for (const auto& [str, encoding] : hex) {
+        EXPECT_EQ(encoding, base32hex::encode(str));
+        EXPECT_EQ(str, base32hex::decode(encoding));
+    }
+    // LOWER CASE AS IN TOTP SECRETS
+    EXPECT_EQ("foobar", base32::decode("mzxw6ytboi======"));
+    EXPECT_EQ("foobar", base32hex::decode("cpnmuoj1e8======"));
+}
+
+TEST(Base32, PaddingPolicies) {
+    using namespace pinepp;
+    using unpadded = basic_base32<base32_alphabet::STANDARD, base64_padding::NONE>;
+    using optional = basic_base32<base32_alphabet::STANDARD, base64_padding::OPTIONAL>;
+    EXPECT_EQ("MZXW6YTBOI", unpadded::encode("foobar"));
+    EXPECT_EQ("foobar", unpadded::decode("MZXW6YTBOI"));
+    EXPECT_THROW(unpadded::decode("MZXW6YTBOI======"), std::invalid_argument);
+    EXPECT_EQ("foobar", optional::decode("MZXW6YTBOI"));
+    EXPECT_EQ("foobar", optional::decode("MZXW6YTBOI======"));
+    EXPECT_THROW(base32::decode("MZXW6YTBOI"), std::invalid_argument);
+}
+
+TEST(Base32, RejectsInvalidCharactersAndMisplacedPadding) {
+    using namespace pinepp;
+    EXPECT_THROW(base32::decode("MZXW6YT"), std::invalid_argument);
+    EXPECT_THROW(base32::decode("MZXW6YT1"), std::invalid_argument);
+    EXPECT_THROW(base32::decode("MZ=W6YTB"), std::invalid_argument);
+    EXPECT_THROW(base32::decode("MZXW6Y=="), std::invalid_argument);
+    EXPECT_THROW(base32::decode("M======="), std::invalid_argument);
+    EXPECT_THROW(base32::decode("========"), std::invalid_argument);
+    EXPECT_THROW(base32::decode("MY======MZXW6YTB"), std::invalid_argument);
+    EXPECT_THROW(base32hex::decode("CPNMUOJW"), std::invalid_argument);
+}
+
+TEST(Base32Kernels, AllSupportedKernelsProduceTheSameResultAsTheScalarKernel) {
+    using namespace pinepp;
+    const auto initial = base64_active_kernel();
+    std::string input;
+    for (int i = 0; i < 1000; ++i)
+        input.push_back(static_cast<char>((i * 7919 + 13) % 256));
+
+    ASSERT_TRUE(base64_select_kernel(base64_kernel::SCALAR));
+    std::vector<std::string> standard;
+    std::vector<std::string> hex;
+    for (size_t len = 0; len <= input.size(); len += 7) {
+        standard.push_back(base32::encode(input.substr(0, len)));
+        hex.push_back(base32hex::encode(input.substr(0, len)));
+        ASSERT_EQ(input.substr(0, len), base32::decode(standard.back()));
+        ASSERT_EQ(input.substr(0, len), base32hex::decode(hex.back()));
+    }
+
+    for (auto kernel : {base64_kernel::SSE41, base64_kernel::AVX2, base64_kernel::AVX512}) {
+        if (!base64_select_kernel(kernel))
+            continue;
+        for (size_t len = 0, i = 0; len <= input.size(); len += 7, ++i) {
+            EXPECT_EQ(standard[i], base32::encode(input.substr(0, len)));
+            EXPECT_EQ(hex[i], base32hex::encode(input.substr(0, len)));
+            EXPECT_EQ(input.substr(0, len), base32::decode(standard[i]));
+            EXPECT_EQ(input.substr(0, len), base32hex::decode(hex[i]));
+        }
+        // INVALID CHARACTERS INSIDE A BLOCK THE KERNEL WOULD PROCESS
+        for (char c : {'1', '8', '=', '@', static_cast<char>(0xc3)}) {
+            std::string invalid = standard.back();
+            invalid[100] = c;
+            EXPECT_THROW(base32::decode(invalid), std::invalid_argument);
+        }
+        std::string invalid = hex.back();
+        invalid[100] = 'W';
+        EXPECT_THROW(base32hex::decode(invalid), std::invalid_argument);
+    }
+    base64_select_kernel(initial);
+}
@@ -2,6 +2,7 @@
 // Created by konstantin on 09.08.23.
 //
 
+#include <fstream>
 #include "gtest/gtest.h"
 #include "bit_pattern.hpp"
 #include "base64.hpp"
@@ -66,4 +67,382 @@ TEST(Base64, Coverage) {
               base64_encode("Base64 encoding with + symboo"));
     EXPECT_ANY_THROW(base64_decode(";;;;"));
 
-}
\ No newline at end of file
+}
+
+TEST(Base64Kernels, AllSupportedKernelsProduceTheSameResultAsTheScalarKernel) {
+    using namespace pinepp;
+    const auto initial = base64_active_kernel();
+    std::string input;
+    for (int i = 0; i < 1000; ++i)
+        input.push_back(static_cast<char>((i * 7919 + 13) % 256));
+
+    ASSERT_TRUE(base64_select_kernel(base64_kernel::SCALAR));
+    std::vector<std::string> expected;
+    for (size_t len = 0; len <= input.size(); len += 7)
+        expected.push_back(base64_encode(input.substr(0, len)));
+
+    for (auto kernel : {base64_kernel::SSE41, base64_kernel::AVX2, base64_kernel::AVX512}) {
+        if (!base64_select_kernel(kernel))
+            continue;
+        EXPECT_EQ(kernel, base64_active_kernel());
+        for (size_t len = 0, i = 0; len <= input.size(); len += 7, ++i) {
+            EXPECT_EQ(expected[i], base64_encode(input.substr(0, len)));
+            EXPECT_EQ(input.substr(0, len), base64_decode(expected[i]));
+        }
+        // INVALID CHARACTERS INSIDE A BLOCK THE KERNEL WOULD PROCESS
+        std::string invalid = expected.back();
+        invalid[100] = '*';
+        EXPECT_THROW(base64_decode(invalid), std::invalid_argument);
+        invalid[100] = static_cast<char>(0xc3);
+        EXPECT_THROW(base64_decode(invalid), std::invalid_argument);
+    }
+    base64_select_kernel(initial);
+}
+
+TEST(Base64DecodeFunction, RejectsInvalidCharactersAndMisplacedPadding) {
+    using namespace pinepp;
+    EXPECT_THROW(base64_decode("SGVsbG8"), std::invalid_argument);
+    EXPECT_THROW(base64_decode("SG=sbG8="), std::invalid_argument);
+    EXPECT_THROW(base64_decode("SGVsb==="), std::invalid_argument);
+    EXPECT_THROW(base64_decode("===="), std::invalid_argument);
+    EXPECT_THROW(base64_decode("SGVs\xc3\xa4G8"), std::invalid_argument);
+    EXPECT_THROW(base64_decode("SGVs bG8"), std::invalid_argument);
+    EXPECT_THROW(base64_decode("SGVsbG8-"), std::invalid_argument);
+    EXPECT_EQ("", base64_decode(""));
+    EXPECT_EQ("Hello", base64_decode("SGVsbG8="));
+}
+
+TEST(Base64StreamingCodec, ProducesTheSameResultAsTheWholeStringFunctionsForAnyChunkSize) {
+    using namespace pinepp;
+    std::string input;
+    for (int i = 0; i < 10000; ++i)
+        input.push_back(static_cast<char>((i * 7919 + 13) % 256));
+    for (size_t len : {0, 1, 2, 3, 4, 5, 100, 10000}) {
+        const auto data = input.substr(0, len);
+        const auto encoded = base64_encode(data);
+        for (size_t chunk_size : {1, 2, 3, 5, 64, 5000}) {
+            std::string out;
+            base64_encoder encoder{[&](std::string_view piece) { out.append(piece); }};
+            for (size_t i = 0; i < data.size(); i += chunk_size)
+                encoder.update(std::string_view{data}.substr(i, chunk_size));
+            encoder.finish();
+            EXPECT_EQ(encoded, out);
+
+            out.clear();
+            base64_decoder decoder{[&](std::string_view piece) { out.append(piece); }};
+            for (size_t i = 0; i < encoded.size(); i += chunk_size)
+                decoder.update(std::string_view{encoded}.substr(i, chunk_size));
+            decoder.finish();
+            EXPECT_EQ(data, out);
+        }
+    }
+}
+
+TEST(Base64StreamingCodec, DecoderRejectsInvalidInput) {
+    using namespace pinepp;
+    base64_decoder decoder{[](std::string_view) {}};
+    decoder.update("SGVsbG8");
+    EXPECT_THROW(decoder.finish(), std::invalid_argument);
+
+    decoder.update("SGVsbG8=");
+    EXPECT_THROW(decoder.update("SGVs"), std::invalid_argument);
+    decoder.finish();
+
+    EXPECT_THROW(decoder.update("SGVsbG8=SGVs"), std::invalid_argument);
+    decoder.finish();
+
+    EXPECT_THROW(decoder.update("SG*sbG8="), std::invalid_argument);
+}
+
+TEST(Base64BufferFunctions, EncodeAndDecodeIntoCallerBuffersWithExactSizes) {
+    using namespace pinepp;
+    const std::string text = "Hello, world!";
+    EXPECT_EQ(20, base64_encoded_size(text.size()));
+    EXPECT_EQ(0, base64_encoded_size(0));
+    EXPECT_EQ(13, base64_decoded_size("SGVsbG8sIHdvcmxkIQ=="));
+    EXPECT_EQ(14, base64_decoded_size("VGhpcyBpcyBhIHRlc3Q="));
+    EXPECT_EQ(0, base64_decoded_size(""));
+    EXPECT_THROW((void)base64_decoded_size("SGVsbG8"), std::invalid_argument);
+
+    char encoded[20];
+    EXPECT_EQ(20, base64_encode(text, encoded));
+    EXPECT_EQ("SGVsbG8sIHdvcmxkIQ==", std::string_view(encoded, 20));
+    char too_small[19];
+    EXPECT_THROW(base64_encode(text, too_small), std::invalid_argument);
+
+    std::byte decoded[13];
+    EXPECT_EQ(13, base64_decode(std::string_view(encoded, 20), decoded));
+    EXPECT_EQ(text, std::string_view(reinterpret_cast<const char*>(decoded), 13));
+    char decoded_too_small[12];
+    EXPECT_THROW(base64_decode(std::string_view(encoded, 20), decoded_too_small), std::invalid_argument);
+
+    EXPECT_EQ("SGVsbG8sIHdvcmxkIQ==", base64_encode(std::as_bytes(std::span{text})));
+}
+
+TEST(Base64IteratorFunctions, WriteToOutputIterators) {
+    using namespace pinepp;
+    std::string out;
+    base64_encode("Hello, world!", std::back_inserter(out));
+    EXPECT_EQ("SGVsbG8sIHdvcmxkIQ==", out);
+
+    std::vector<char> bytes;
+    base64_decode(out, std::back_inserter(bytes));
+    EXPECT_EQ("Hello, world!", std::string(bytes.begin(), bytes.end()));
+
+    bytes.clear();
+    EXPECT_THROW(base64_decode("SG*sbG8=", std::back_inserter(bytes)), std::invalid_argument);
+}
+
+TEST(Base64Dialects, UrlSafeAlphabetWithoutPaddingRoundTripsOnAllKernels) {
+    using namespace pinepp;
+    const auto initial = base64_active_kernel();
+    std::string input;
+    for (int i = 0; i < 1000; ++i)
+        input.push_back(static_cast<char>((i * 7919 + 13) % 256));
+
+    for (auto kernel : {base64_kernel::SCALAR, base64_kernel::SSE41, base64_kernel::AVX2, base64_kernel::AVX512}) {
+        if (!base64_select_kernel(kernel))
+            continue;
+        for (size_t len = 0; len <= input.size(); len += 7) {
+            const auto standard = base64::encode(input.substr(0, len));
+            auto expected = standard.substr(0, standard.find('='));
+            std::replace(expected.begin(), expected.end(), '+', '-');
+            std::replace(expected.begin(), expected.end(), '/', '_');
+
+            const auto url = base64url::encode(input.substr(0, len));
+            EXPECT_EQ(expected, url);
+            EXPECT_EQ(url.size(), base64url::encoded_size(len));
+            EXPECT_EQ(input.substr(0, len), base64url::decode(url));
+        }
+        EXPECT_THROW(base64url::decode(base64::encode(input)), std::invalid_argument);
+    }
+    base64_select_kernel(initial);
+
+    EXPECT_EQ("-_-_", base64url::encode("\xfb\xff\xbf"));
+    EXPECT_THROW(base64url::decode("QQ=="), std::invalid_argument);
+    EXPECT_THROW(base64url::decode("Q"), std::invalid_argument);
+    EXPECT_THROW(base64url::decode("+/+/"), std::invalid_argument);
+    EXPECT_THROW(base64::decode("-_-_"), std::invalid_argument);
+
+    using base64_optional = basic_base64<base64_alphabet::STANDARD, base64_padding::OPTIONAL>;
+    EXPECT_EQ("QQ", base64_optional::encode("A"));
+    EXPECT_EQ("A", base64_optional::decode("QQ"));
+    EXPECT_EQ("A", base64_optional::decode("QQ=="));
+}
+
+TEST(Base64Dialects, MimeBreaksLinesAfter76Characters) {
+    using namespace pinepp;
+    const std::string input(150, 'x');
+    const auto plain = base64::encode(input);
+    const auto mime = base64_mime::encode(input);
+
+    ASSERT_EQ(plain.size() + 4, mime.size());
+    EXPECT_EQ(mime.size(), base64_mime::encoded_size(input.size()));
+    EXPECT_EQ(plain.substr(0, 76) + "\r\n" + plain.substr(76, 76) + "\r\n" + plain.substr(152), mime);
+    EXPECT_EQ(input, base64_mime::decode(mime));
+    EXPECT_EQ(std::string(57, 'x'), base64_mime::decode(base64_mime::encode(std::string(57, 'x'))));
+    EXPECT_EQ(76, base64_mime::encode(std::string(57, 'x')).size());
+
+    EXPECT_THROW(base64_mime::decode(plain), std::invalid_argument);
+    EXPECT_THROW(base64_mime::decode(mime + "\r\n"), std::invalid_argument);
+    auto wrong_break = mime;
+    wrong_break[76] = '\n';
+    EXPECT_THROW(base64_mime::decode(wrong_break), std::invalid_argument);
+    EXPECT_EQ(std::string(48, 'x'), base64_pem::decode(base64_pem::encode(std::string(48, 'x'))));
+}
+
+TEST(Base64Parallelism, SplitInputsProduceTheSameResultAsTheCallingThread) {
+    using namespace pinepp;
+    const auto initial = base64_parallel_threshold();
+    std::string input;
+    for (int i = 0; i < 100000; ++i)
+        input.push_back(static_cast<char>((i * 7919 + 13) % 256));
+    std::vector<std::string> expected;
+    for (size_t len = input.size() - 10; len <= input.size(); ++len)
+        expected.push_back(base64_encode(input.substr(0, len)));
+
+    base64_set_parallelism(1, 4);
+    EXPECT_EQ(1, base64_parallel_threshold());
+    for (size_t len = input.size() - 10, i = 0; len <= input.size(); ++len, ++i) {
+        EXPECT_EQ(expected[i], base64_encode(input.substr(0, len)));
+        EXPECT_EQ(input.substr(0, len), base64_decode(expected[i]));
+        EXPECT_EQ(input.substr(0, len), base64url::decode(base64url::encode(input.substr(0, len))));
+    }
+    // INVALID CHARACTERS IN THE FIRST AND IN THE LAST CHUNK
+    for (size_t pos : {size_t{10}, expected.back().size() - 10}) {
+        auto invalid = expected.back();
+        invalid[pos] = '*';
+        EXPECT_THROW(base64_decode(invalid), std::invalid_argument);
+    }
+    base64_set_parallelism(initial);
+}
+
+TEST(Base64FileFunctions, TranscodeFilesThroughMemoryMappings) {
+    using namespace pinepp;
+    const std::string plain = testing::TempDir() + "base64_plain";
+    const std::string encoded = testing::TempDir() + "base64_encoded";
+    const std::string decoded = testing::TempDir() + "base64_decoded";
+    std::string input;
+    for (int i = 0; i < 100000; ++i)
+        input.push_back(static_cast<char>((i * 7919 + 13) % 256));
+    const auto read_file = [](const std::string& path) {
+        std::ifstream file{path, std::ios::binary};
+        return std::string{std::istreambuf_iterator<char>{file}, {}};
+    };
+
+    for (const auto& content : {input, std::string{}}) {
+        std::ofstream{plain, std::ios::binary} << content;
+        base64_encode_file(plain, encoded);
+        EXPECT_EQ(base64_encode(content), read_file(encoded));
+        base64_decode_file(encoded, decoded);
+        EXPECT_EQ(content, read_file(decoded));
+    }
+
+    std::ofstream{encoded, std::ios::binary} << "SGVsbG8*";
+    EXPECT_THROW(base64_decode_file(encoded, decoded), std::invalid_argument);
+    EXPECT_FALSE(std::ifstream{decoded}.is_open());
+    EXPECT_THROW(base64_encode_file(testing::TempDir() + "base64_missing", encoded), std::runtime_error);
+    std::remove(plain.c_str());
+    std::remove(encoded.c_str());
+}
+
+TEST(Base64FileFunctions, DecodeFilesEndingInLineBreaksAndWrappedFiles) {
+    using namespace pinepp;
+    const std::string encoded = testing::TempDir() + "base64_wrapped";
+    const std::string decoded = testing::TempDir() + "base64_unwrapped";
+    const auto read_file = [](const std::string& path) {
+        std::ifstream file{path, std::ios::binary};
+        return std::string{std::istreambuf_iterator<char>{file}, {}};
+    };
+
+    // LIKE printf 'aGVsbG8=\n' AND A FILE SAVED WITH WINDOWS LINE BREAKS
+    for (const auto* text : {"aGVsbG8=\n", "aGVsbG8=\r\n"}) {
+        std::ofstream{encoded, std::ios::binary} << text;
+        base64_decode_file(encoded, decoded);
+        EXPECT_EQ("hello", read_file(decoded));
+    }
+
+    // LIKE THE OUTPUT OF base64(1), WRAPPED AFTER 76 COLUMNS
+    std::string input;
+    for (int i = 0; i < 1000; ++i)
+        input.push_back(static_cast<char>((i * 7919 + 13) % 256));
+    const auto encoding = base64_encode(input);
+    std::string wrapped;
+    for (size_t i = 0; i < encoding.size(); i += 76)
+        wrapped += encoding.substr(i, 76) + '\n';
+    std::ofstream{encoded, std::ios::binary} << wrapped;
+    base64_decode_file(encoded, decoded);
+    EXPECT_EQ(input, read_file(decoded));
+    std::remove(encoded.c_str());
+    std::remove(decoded.c_str());
+}
+
+TEST(Base64FileFunctions, RefuseToTranscodeAFileIntoItself) {
+    using namespace pinepp;
+    const std::string path = testing::TempDir() + "base64_same";
+    const std::string alias = testing::TempDir() + "./base64_same";
+    const auto read_file = [](const std::string& file_path) {
+        std::ifstream file{file_path, std::ios::binary};
+        return std::string{std::istreambuf_iterator<char>{file}, {}};
+    };
+
+    std::ofstream{path, std::ios::binary} << "hello";
+    EXPECT_THROW(base64_encode_file(path, path), std::invalid_argument);
+    EXPECT_THROW(base64_encode_file(path, alias), std::invalid_argument);
+    EXPECT_EQ("hello", read_file(path));
+
+    // AN INVALID ENCODING MUST NOT GET THE SOURCE REMOVED EITHER
+    std::ofstream{path, std::ios::binary} << "SGVsbG8*";
+    EXPECT_THROW(base64_decode_file(path, path), std::invalid_argument);
+    EXPECT_EQ("SGVsbG8*", read_file(path));
+    std::remove(path.c_str());
+}
+
+TEST(Base64LenientDecode, SkipsWhitespaceAnywhere) {
+    using namespace pinepp;
+    std::string input;
+    for (int i = 0; i < 1000; ++i)
+        input.push_back(static_cast<char>((i * 7919 + 13) % 256));
+
+    for (size_t len = 0; len <= input.size(); len += 7) {
+        const auto mime = base64_mime::encode(input.substr(0, len));
+        EXPECT_EQ(input.substr(0, len), base64_decode_lenient(mime));
+        EXPECT_EQ(len, base64_decoded_size_lenient(mime));
+        EXPECT_EQ(input.substr(0, len), base64_pem::decode_lenient(mime));
+    }
+
+    EXPECT_EQ("Hello, world!", base64_decode_lenient(" SGVs\tbG8s\nIHdvc\r\nmxkI Q=\n=\n"));
+    EXPECT_EQ("Hello, world!", base64_decode_lenient("S G V s b G 8 s I H d v c m x k I Q = ="));
+    EXPECT_EQ("", base64_decode_lenient(" \r\n "));
+    EXPECT_EQ("Hello, world", base64url::decode_lenient("SGVsbG8s\nIHdvcmxk"));
+    EXPECT_EQ("A", base64url::decode_lenient("Q Q"));
+
+    EXPECT_THROW(base64_decode_lenient("SGVs\x01bG8="), std::invalid_argument);
+    EXPECT_THROW(base64_decode_lenient("SGVsbG8"), std::invalid_argument);
+    EXPECT_THROW(base64_decode_lenient("QQ==\nQUJD"), std::invalid_argument);
+    EXPECT_THROW(base64_decode_lenient("QQ= =QUJD"), std::invalid_argument);
+    EXPECT_THROW(base64_decode_lenient("SG*s bG8="), std::invalid_argument);
+    EXPECT_THROW(base64url::decode_lenient("QQ=="), std::invalid_argument);
+    EXPECT_THROW(base64url::decode_lenient("Q\n"), std::invalid_argument);
+
+    char too_small[4];
+    EXPECT_THROW(base64::decode_lenient("SGVs\nbG8s", too_small), std::invalid_argument);
+    char exact[5];
+    EXPECT_EQ(5, base64::decode_lenient("SGVs\nbG8=", exact));
+    EXPECT_EQ("Hello", std::string_view(exact, 5));
+}
+
+TEST(Base64ConstexprFunctions, EncodeAndDecodeAtCompileTime) {
+    using namespace pinepp;
+    constexpr auto encoded = base64_encode<"Hello, world!">();
+    static_assert(std::string_view(encoded.data(), encoded.size()) == "SGVsbG8sIHdvcmxkIQ==");
+    constexpr auto decoded = base64_decode<"SGVsbG8sIHdvcmxkIQ==">();
+    static_assert(std::string_view(decoded.data(), decoded.size()) == "Hello, world!");
+    static_assert(base64_decode<"">().empty());
+    constexpr auto binary = base64_decode<"AP+A">();
+    static_assert(binary[0] == '\0' && binary[1] == '\xff' && binary[2] == '\x80');
+
+    constexpr auto url = base64url::encode(std::array<char, 4>{'\xfb', '\xff', '\xbf', 'A'});
+    static_assert(std::string_view(url.data(), url.size()) == "-_-_QQ");
+    constexpr auto url_decoded = base64url::decode<"-_-_QQ">();
+    static_assert(std::string_view(url_decoded.data(), url_decoded.size()) == "\xfb\xff\xbf" "A");
+    constexpr auto mime = base64_mime::encode<"xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx">();
+    static_assert(std::string_view(mime.data(), mime.size()).substr(76) == "\r\neA==");
+
+    // THE SAME RESULTS AT RUNTIME
+    EXPECT_EQ(base64_encode("Hello, world!"), std::string(encoded.begin(), encoded.end()));
+    EXPECT_EQ(base64_mime::encode(std::string(58, 'x')), std::string(mime.begin(), mime.end()));
+    EXPECT_EQ("-_-_QQ", std::string(url.begin(), url.end()));
+}
+
+TEST(Base64BatchFunctions, EncodeManyInputsIntoOneBuffer) {
+    using namespace pinepp;
+    std::vector<std::string> strings;
+    for (size_t len = 0; len < 300; len += 11)
+        strings.emplace_back(len, static_cast<char>('a' + len % 26));
+    const std::vector<std::string_view> inputs(strings.begin(), strings.end());
+
+    const auto batch = base64_encode_batch(inputs);
+    ASSERT_EQ(inputs.size(), batch.size());
+    EXPECT_EQ(inputs.size() + 1, batch.offsets().size());
+    EXPECT_EQ(batch.data().size(), batch.offsets().back());
+    for (size_t i = 0; i < inputs.size(); ++i)
+        EXPECT_EQ(base64_encode(inputs[i]), batch[i]);
+
+    const auto url_batch = base64url::encode_batch(inputs);
+    const auto mime_batch = base64_mime::encode_batch(inputs);
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        EXPECT_EQ(base64url::encode(inputs[i]), url_batch[i]);
+        EXPECT_EQ(base64_mime::encode(inputs[i]), mime_batch[i]);
+    }
+
+    std::vector<char> dst(base64::batch_encoded_size(inputs));
+    std::vector<size_t> offsets(inputs.size() + 1);
+    EXPECT_EQ(dst.size(), base64::encode_batch(inputs, dst, offsets));
+    EXPECT_EQ(batch.data(), std::string(dst.begin(), dst.end()));
+    dst.pop_back();
+    EXPECT_THROW(base64::encode_batch(inputs, dst, offsets), std::invalid_argument);
+    offsets.pop_back();
+    EXPECT_THROW(base64::encode_batch(inputs, dst, offsets), std::invalid_argument);
+    EXPECT_EQ(0, base64_encode_batch({}).size());
+}
@@ -0,0 +1,53 @@
+//
+// Created by konstantin on 17.10.26.
+//
+
+#include "gtest/gtest.h"
+#include "base85.hpp"
+
+TEST(Base85EncodeFunction, EncodesGroupsPartialGroupsAndZeros) {
+    using namespace pinepp;
+    EXPECT_EQ("", base85_encode(""));
+    EXPECT_EQ("87cURD]i,\"Ebo80", base85_encode("Hello World!"));
+    EXPECT_EQ("87cURD]i,\"Ebo7", base85_encode("Hello World"));
+    EXPECT_EQ("9jqo^BlbD-BleB1DJ+*+F(f,q", base85_encode("Man is distinguished"));
+    EXPECT_EQ("z", base85_encode(std::string(4, '\0')));
+    EXPECT_EQ("z!!", base85_encode(std::string(5, '\0')));
+    EXPECT_EQ("s8W-!", base85_encode("\xff\xff\xff\xff"));
+    EXPECT_EQ(base85_max_encoded_size(11), base85_encode("Hello World").size());
+}
+
+TEST(Base85DecodeFunction, SkipsWhitespaceAndRejectsInvalidGroups) {
+    using namespace pinepp;
+    EXPECT_EQ("Hello World!", base85_decode("87cURD]i,\"Ebo80"));
+    EXPECT_EQ("Hello World", base85_decode("87cUR D]i,\n\"Ebo7\r\n"));
+    EXPECT_EQ(std::string(9, '\0'), base85_decode("zz!!"));
+    EXPECT_EQ(11u, base85_decoded_size("87cUR D]i,\n\"Ebo7"));
+    EXPECT_EQ("", base85_decode(""));
+
+    EXPECT_THROW(base85_decode("87cURD]i,\"Ebo8v"), std::invalid_argument);
+    EXPECT_THROW(base85_decode("87cURD]i,\"Ebo8~"), std::invalid_argument);
+    // 'z' IS ONLY ALLOWED IN PLACE OF A WHOLE GROUP
+    EXPECT_THROW(base85_decode("87z"), std::invalid_argument);
+    // A GROUP MUST FIT 32 BITS
+    EXPECT_THROW(base85_decode("s8W-\""), std::invalid_argument);
+    EXPECT_THROW(base85_decode("uuuuu"), std::invalid_argument);
+    // A LONE DIGIT CAN'T HOLD A BYTE
+    EXPECT_THROW(base85_decode("87cURD"), std::invalid_argument);
+
+    char small[4];
+    EXPECT_THROW(base85_decode("87cURD]", std::span{small}), std::invalid_argument);
+}
+
+TEST(Base85, RoundTripsArbitraryBytes) {
+    using namespace pinepp;
+    std::string input;
+    for (int i = 0; i < 1000; ++i)
+        input.push_back(static_cast<char>(i % 13 < 6 ? 0 : (i * 7919 + 13) % 256));
+    for (size_t len = 0; len <= input.size(); len += 7) {
+        const auto encoding = base85_encode(input.substr(0, len));
+        EXPECT_LE(encoding.size(), base85_max_encoded_size(len));
+        EXPECT_EQ(len, base85_decoded_size(encoding));
+        EXPECT_EQ(input.substr(0, len), base85_decode(encoding));
+    }
+}
@@ -1,7 +1,11 @@
 //
 // Created by konstantin on 05.08.23.
 //
+#include <algorithm>
 #include <regex>
+#include <sstream>
+#include <thread>
+#include <unordered_set>
 #include "bit_pattern.hpp"
 #include "utility.hpp"
 #include "gtest/gtest.h"
@@ -49,6 +53,17 @@ TEST(BitPatternStringConstructor, RecognizesHexStringAndConstructsTheObjectFromI
     EXPECT_EQ(output, "11111111000001001010");
 }
 
+TEST(BitPatternSizeConstructor, CreatesAPatternWithAllBitsSetToTheGivenValue) {
+    using namespace pinepp;
+    EXPECT_EQ("00000", bit_pattern(size_t{5}).str());
+    EXPECT_EQ("1111111", bit_pattern(size_t{7}, true).str());
+    bit_pattern bp(size_t{200}, true);
+    EXPECT_EQ(200, bp.size());
+    EXPECT_EQ(std::string(200, '1'), bp.str());
+    EXPECT_EQ(std::string(200, '0'), (~bp).str());
+    EXPECT_EQ(0, bit_pattern(size_t{0}).size());
+}
+
 TEST(BitPatternCopyConstructor, PerformsADeepCopy) {
     using namespace pinepp;
     bit_pattern bp1{"0x8000"};
@@ -194,6 +209,55 @@ TEST(SetBitFunction, SetsABitWhereIndexZeroIsTheRightmostBitWhenPrintingToCout)
 
 }
 
+TEST(SetBitFunction, RejectsIndicesOutOfRange) {
+    using namespace pinepp;
+    bit_pattern bp{size_t{65}};
+    bp.set_bit(64, true);
+    EXPECT_EQ(1, bp.count());
+    EXPECT_THROW(bp.set_bit(65, true), std::out_of_range);
+    EXPECT_THROW(bp.set_bit(static_cast<size_t>(-1), true), std::out_of_range);
+    EXPECT_THROW(bit_pattern{}.set_bit(0, false), std::out_of_range);
+    EXPECT_EQ(1, bp.count());
+}
+
+TEST(BitPatternBracketsOperator, WritesThroughTheReference) {
+    using namespace pinepp;
+    bit_pattern bp{"100101010111"};
+    bp[0] = false;
+    bp[3] = 1;
+    bp[11].flip();
+    EXPECT_EQ("000101011110", bp.str());
+    EXPECT_FALSE(bp[0]);
+    EXPECT_TRUE(bp[3]);
+    EXPECT_TRUE(~bp[0]);
+
+    // REFERENCES ASSIGN AND SWAP THE BITS THEY REFER TO
+    bp[0] = bp[3];
+    swap(bp[5], bp[1]);
+    EXPECT_EQ("000101111101", bp.str());
+    bit_pattern other{size_t{70}};
+    other[69] = bp[3];
+    EXPECT_EQ(1, other.count());
+    EXPECT_EQ(69, other.find_first());
+
+    // PROXIES CAN BE STORED AND SWAPPED LIKE THE ONES OF std::vector<bool>
+    bit_pattern wide{size_t{200}};
+    for (size_t i = 0; i < wide.size(); i += 3)
+        wide[i] = true;
+    EXPECT_EQ(67, wide.count());
+    EXPECT_EQ(67, wide.rank1(200));
+    for (size_t i = 0; i < 100; ++i) {
+        auto a = wide[i];
+        auto b = wide[199 - i];
+        swap(a, b);
+    }
+    bit_pattern expected{size_t{200}};
+    for (size_t i = 0; i < 200; i += 3)
+        expected[199 - i] = true;
+    EXPECT_EQ(expected, wide);
+    EXPECT_EQ(67, wide.rank1(200));
+}
+
 TEST(BitPatternReverseFunction, ReversesThePattern) {
     using namespace pinepp;
     bit_pattern bp{"100101010111"};
@@ -211,6 +275,26 @@ TEST(BitPatternReverseFunction, ReversesThePattern) {
     EXPECT_EQ(output, "011");
 }
 
+TEST(BitPatternReverseFunction, MatchesAStringReferenceWithEveryKernel) {
+    using namespace pinepp;
+    const auto initial = bit_pattern_active_kernel();
+    for (auto kernel : {bit_pattern_kernel::SCALAR, bit_pattern_kernel::AVX2, bit_pattern_kernel::AVX512}) {
+        if (!bit_pattern_select_kernel(kernel))
+            continue;
+        for (size_t len : {0ul, 1ul, 63ul, 64ul, 65ul, 255ul, 256ul, 511ul, 520ul, 1000ul, 4097ul}) {
+            std::string str(len, '0');
+            for (size_t i = 0; i < len; ++i)
+                str[i] = (i * 7919 + 5) % 3 == 0 ? '1' : '0';
+            bit_pattern bp{str};
+            bp.reverse();
+            std::reverse(str.begin(), str.end());
+            EXPECT_EQ(str, bp.str()) << len;
+            EXPECT_EQ(bit_pattern{str}, bp);
+        }
+    }
+    bit_pattern_select_kernel(initial);
+}
+
 TEST(BitPatternBracketsOperator, AllowsReadOnlyAccessToBits) {
     using namespace pinepp;
     bit_pattern bp{"100101010111"};
@@ -315,93 +399,156 @@ TEST(BitPatternTildeOperator, ShouldPerformALogicalNegationAndReturnTheResult) {
     EXPECT_EQ(output, "0101");
 }
 
-TEST(BitPatternLeftShiftOperator, ShiftsTheBitsInThePatternLeftByNCharactersAndAttachesOverflowingBitsOnTheRight) {
+TEST(BitPatternRotlFunction, RotatesTheBitsInThePatternLeftByNCharactersAndAttachesOverflowingBitsOnTheRight) {
     using namespace pinepp;
     bit_pattern bp{"1011101010010100"};
     testing::internal::CaptureStdout();
-    std::cout << (bp << 3);
+    std::cout << rotl(bp, 3);
     std::string output = testing::internal::GetCapturedStdout();
     EXPECT_EQ(output, "1101010010100101");
 }
 
-TEST(BitPatternLeftShiftOperator, CanShiftDistancesLongerThanOneByte) {
+TEST(BitPatternRotlFunction, CanShiftDistancesLongerThanOneByte) {
     using namespace pinepp;
     bit_pattern bp{"1011101010010100"};
     testing::internal::CaptureStdout();
-    std::cout << (bp << 10);
+    std::cout << rotl(bp, 10);
     std::string output = testing::internal::GetCapturedStdout();
     EXPECT_EQ(output, "0101001011101010");
 
     testing::internal::CaptureStdout();
-    std::cout << (bp << 20);
+    std::cout << rotl(bp, 20);
     output = testing::internal::GetCapturedStdout();
     EXPECT_EQ(output, "1010100101001011");
 }
 
-TEST(BitPatternLeftShiftOperator, CanHandlePatternsWhoseLengthIsntAMultipleOfEight) {
+TEST(BitPatternRotlFunction, CanHandlePatternsWhoseLengthIsntAMultipleOfEight) {
     using namespace pinepp;
     bit_pattern bp{"1001011101010010100"};
     testing::internal::CaptureStdout();
-    std::cout << (bp << 10);
+    std::cout << rotl(bp, 10);
     std::string output = testing::internal::GetCapturedStdout();
     EXPECT_EQ(output, "0100101001001011101");
 
     testing::internal::CaptureStdout();
-    std::cout << (bp << 20);
+    std::cout << rotl(bp, 20);
     output = testing::internal::GetCapturedStdout();
     EXPECT_EQ(output, "0010111010100101001");
 
     bp = bit_pattern{"10010"};
     testing::internal::CaptureStdout();
-    std::cout << (bp << 3);
+    std::cout << rotl(bp, 3);
     output = testing::internal::GetCapturedStdout();
     EXPECT_EQ(output, "10100");
 }
 
 
-TEST(BitPatternRightShiftOperator, ShiftsTheBitsInThePatternRightByNCharactersAndAttachesOverflowingBitsOnTheLeft) {
+TEST(BitPatternRotrFunction, RotatesTheBitsInThePatternRightByNCharactersAndAttachesOverflowingBitsOnTheLeft) {
     using namespace pinepp;
     bit_pattern bp{"1011101010010100"};
     testing::internal::CaptureStdout();
-    std::cout << (bp >> 3);
+    std::cout << rotr(bp, 3);
     std::string output = testing::internal::GetCapturedStdout();
     EXPECT_EQ(output, "1001011101010010");
 }
 
-TEST(BitPatternRightShiftOperator, CanShiftDistancesLongerThanOneByte) {
+TEST(BitPatternRotrFunction, CanShiftDistancesLongerThanOneByte) {
     using namespace pinepp;
     bit_pattern bp{"1011101010010100"};
     testing::internal::CaptureStdout();
-    std::cout << (bp >> 10);
+    std::cout << rotr(bp, 10);
     std::string output = testing::internal::GetCapturedStdout();
     EXPECT_EQ(output, "1010010100101110");
 
     testing::internal::CaptureStdout();
-    std::cout << (bp >> 20);
+    std::cout << rotr(bp, 20);
     output = testing::internal::GetCapturedStdout();
     EXPECT_EQ(output, "0100101110101001");
 }
 
-TEST(BitPatternRightShiftOperator, CanHandlePatternsWhoseLengthIsntAMultipleOfEight) {
+TEST(BitPatternRotrFunction, CanHandlePatternsWhoseLengthIsntAMultipleOfEight) {
     using namespace pinepp;
     bit_pattern bp{"1001011101010010100"};
     testing::internal::CaptureStdout();
-    std::cout << (bp >> 10);
+    std::cout << rotr(bp, 10);
     std::string output = testing::internal::GetCapturedStdout();
     EXPECT_EQ(output, "1010010100100101110");
 
     testing::internal::CaptureStdout();
-    std::cout << (bp >> 20);
+    std::cout << rotr(bp, 20);
     output = testing::internal::GetCapturedStdout();
     EXPECT_EQ(output, "0100101110101001010");
 
     bp = bit_pattern{"10010"};
     testing::internal::CaptureStdout();
-    std::cout << (bp >> 3);
+    std::cout << rotr(bp, 3);
     output = testing::internal::GetCapturedStdout();
     EXPECT_EQ(output, "01010");
 }
 
+TEST(BitPatternShiftOperators, ShiftInZerosAndDropTheOverflowingBits) {
+    using namespace pinepp;
+    bit_pattern bp{"1001011101010010100"};
+    EXPECT_EQ("1011101010010100000", (bp << 3).str());
+    EXPECT_EQ("0001001011101010010", (bp >> 3).str());
+    EXPECT_EQ("0000000000000000000", (bp << 19).str());
+    EXPECT_EQ("0000000000000000000", (bp >> 100).str());
+
+    bp <<= 10;
+    EXPECT_EQ("0100101000000000000", bp.str());
+    bp >>= 12;
+    EXPECT_EQ("0000000000000100101", bp.str());
+    EXPECT_EQ(19, bp.size());
+}
+
+TEST(BitPatternShiftOperators, MatchAStringReferenceAcrossWordBoundaries) {
+    using namespace pinepp;
+    std::string str(300, '0');
+    for (size_t i = 0; i < str.size(); ++i)
+        str[i] = (i * 7919 + 13) % 3 == 0 ? '1' : '0';
+    const bit_pattern bp{str};
+    for (uint64_t n : {1, 7, 63, 64, 65, 128, 150, 299, 300, 601}) {
+        const auto shift = std::min<size_t>(n, str.size());
+        EXPECT_EQ(str.substr(shift) + std::string(shift, '0'), (bp << n).str());
+        EXPECT_EQ(std::string(shift, '0') + str.substr(0, str.size() - shift), (bp >> n).str());
+        const auto rotation = n % str.size();
+        EXPECT_EQ(str.substr(rotation) + str.substr(0, rotation), rotl(bp, n).str());
+        EXPECT_EQ(str.substr(str.size() - rotation) + str.substr(0, str.size() - rotation), rotr(bp, n).str());
+
+        auto copy = bp;
+        EXPECT_EQ(rotl(bp, n), copy.rotate_left(n));
+        EXPECT_EQ(bp, copy.rotate_right(n));
+        EXPECT_EQ(bp << n, copy <<= n);
+        copy = bp;
+        EXPECT_EQ(bp >> n, copy >>= n);
+    }
+}
+
+TEST(BitPatternRotateInPlace, MatchesRotlAndRotr) {
+    using namespace pinepp;
+    for (size_t len : {2, 63, 64, 65, 128, 200, 256, 1000}) {
+        bit_pattern bp{len};
+        for (size_t i = 0; i < len; ++i)
+            bp.set_bit(i, (i * 7919 + 13) % 3 == 0);
+        // SMALL AND LARGE ROTATIONS KEEP ASIDE THE BITS ON EITHER END
+        for (uint64_t n : {uint64_t{1}, uint64_t{31}, uint64_t{64}, uint64_t{len / 2}, uint64_t{len - 1},
+                           uint64_t{len + 3}, uint64_t{3 * len - 70}}) {
+            auto left = bp;
+            EXPECT_EQ(rotl(bp, n), left.rotate_left(n));
+            auto right = bp;
+            EXPECT_EQ(rotr(bp, n), right.rotate_right(n));
+            EXPECT_EQ(bp.count(), right.count());
+        }
+    }
+
+    // THE RANK DIRECTORY IS DROPPED
+    bit_pattern bp{"0001"};
+    EXPECT_EQ(1, bp.rank1(1));
+    bp.rotate_left(2);
+    EXPECT_EQ(0, bp.rank1(1));
+    EXPECT_EQ(1, bp.rank1(3));
+}
+
 TEST(BitPatternPlusOperator, ConcatenatesToBitPatterns) {
     using namespace pinepp;
     bit_pattern bp1{"1001011101010010100"};
@@ -418,6 +565,58 @@ TEST(BitPatternPlusOperator, ConcatenatesToBitPatterns) {
     EXPECT_EQ(output, "1001011101010010100");
 }
 
+TEST(BitPatternPlusOperator, MatchesStringConcatenationAcrossWordBoundaries) {
+    using namespace pinepp;
+    for (size_t len1 : {0ul, 1ul, 63ul, 64ul, 100ul, 200ul}) {
+        for (size_t len2 : {0ul, 1ul, 60ul, 64ul, 65ul, 129ul}) {
+            std::string str1(len1, '1');
+            std::string str2(len2, '0');
+            for (size_t i = 0; i < len1; i += 3)
+                str1[i] = '0';
+            for (size_t i = 0; i < len2; i += 5)
+                str2[i] = '1';
+            const bit_pattern bp1{str1};
+            const bit_pattern bp2{str2};
+            EXPECT_EQ(str1 + str2, (bp1 + bp2).str());
+            EXPECT_EQ(bit_pattern{str1 + str2}, bp1 + bp2);
+            EXPECT_EQ(str1 + str1, (bp1 + bp1).str());
+        }
+    }
+}
+
+TEST(BitPatternBuilders, PushBackAndAppendOnTheMostSignificantSide) {
+    using namespace pinepp;
+    bit_pattern bp{"01"};
+    bp.push_back(true).push_back(false).push_back(true);
+    EXPECT_EQ("10101", bp.str());
+    bp.append(0xff0, 8);
+    EXPECT_EQ("1111000010101", bp.str());
+    bp.append(0, 0);
+    EXPECT_EQ(13, bp.size());
+    EXPECT_THROW(bp.append(0, 65), std::invalid_argument);
+
+    // BUILDING BIT BY BIT AND BLOCK BY BLOCK GIVES THE SAME PATTERN AS PARSING
+    std::string reference;
+    bit_pattern pushed;
+    bit_pattern appended;
+    for (size_t i = 0; i < 1000; ++i) {
+        const bool value = (i * 2654435761u) % 7 < 3;
+        reference.insert(reference.begin(), value ? '1' : '0');
+        pushed.push_back(value);
+    }
+    for (size_t i = 0; i < 1000; i += 37) {
+        const auto n = std::min<size_t>(37, 1000 - i);
+        uint64_t bits = 0;
+        for (size_t j = 0; j < n; ++j)
+            bits |= uint64_t{reference[reference.size() - 1 - i - j] == '1'} << j;
+        appended.append(bits | ~uint64_t{0} << n, n);
+    }
+    EXPECT_EQ(reference, pushed.str());
+    EXPECT_EQ(bit_pattern{reference}, pushed);
+    EXPECT_EQ(pushed, appended);
+    EXPECT_EQ(pushed.count(), static_cast<size_t>(std::count(reference.begin(), reference.end(), '1')));
+}
+
 TEST(BitPatternCopyAssignmentOperator, PerformsADeepCopy) {
     using namespace pinepp;
     bit_pattern bp1{"1001011101010010100"};
@@ -473,6 +672,23 @@ TEST(BitPatternResizeFunction, DoesntDoAnythingIfTheNewSizeIsTheSameAsTheOldOne)
     EXPECT_EQ(output, "000001011101");
 }
 
+TEST(BitPatternResizeFunction, KeepsTheLeastSignificantBitsAcrossWordBoundaries) {
+    using namespace pinepp;
+    const std::string str = "1011" + std::string(150, '1') + "0110";
+    for (size_t n : {0ul, 1ul, 63ul, 64ul, 65ul, 128ul, 129ul, 158ul, 300ul}) {
+        bit_pattern bp{str};
+        bp.resize(n);
+        const auto expected = n < str.size() ? str.substr(str.size() - n) : std::string(n - str.size(), '0') + str;
+        EXPECT_EQ(expected, bp.str()) << n;
+        EXPECT_EQ(bit_pattern{expected}, bp);
+        EXPECT_EQ(bit_pattern{expected}.count(), bp.count());
+    }
+    // BITS CUT OFF BY SHRINKING DON'T COME BACK WHEN GROWING AGAIN
+    bit_pattern bp(200, true);
+    bp.resize(70).resize(200);
+    EXPECT_EQ(70, bp.count());
+}
+
 TEST(BitPattern, EqualsOperator) {
     using namespace pinepp;
     bit_pattern bp1{"0111011101"};
@@ -487,17 +703,461 @@ TEST(BitPattern, EqualsOperator) {
     EXPECT_TRUE(bp1 != bp4);
 }
 
+TEST(BitPattern, EqualityIgnoresHowThePatternWasBuilt) {
+    using namespace pinepp;
+    bit_pattern shrunk{std::string(200, '1')};
+    shrunk.resize(100);
+    shrunk.flip();
+    shrunk.flip();
+    EXPECT_EQ(bit_pattern(std::string(100, '1')), shrunk);
+    EXPECT_EQ((bit_pattern{100, true}), shrunk);
+    EXPECT_NE((bit_pattern{101, true}), shrunk);
+    EXPECT_NE(bit_pattern{"0"}, bit_pattern{"00"});
+}
+
+TEST(BitPattern, OrdersBySizeAndThenNumerically) {
+    using namespace pinepp;
+    EXPECT_LT(bit_pattern{"111"}, bit_pattern{"0000"});
+    EXPECT_LT(bit_pattern{"0110"}, bit_pattern{"1000"});
+    EXPECT_GT(bit_pattern{"1001"}, bit_pattern{"1000"});
+    EXPECT_EQ(std::strong_ordering::equal, bit_pattern{"1010"} <=> bit_pattern{"1010"});
+    EXPECT_LE(bit_pattern{}, bit_pattern{});
+
+    // SAME SIZE ORDERS LIKE THE STRINGS, ACROSS WORD BOUNDARIES
+    std::vector<std::string> strings;
+    for (int i = 0; i < 64; ++i) {
+        std::string str(150, '0');
+        for (size_t j = 0; j < str.size(); j += static_cast<size_t>(i % 7 + 1))
+            str[(j * 31 + static_cast<size_t>(i)) % str.size()] = '1';
+        strings.push_back(str);
+    }
+    for (const auto& a : strings) {
+        for (const auto& b : strings)
+            EXPECT_EQ(a <=> b, bit_pattern{a} <=> bit_pattern{b}) << a << ' ' << b;
+    }
+}
+
+TEST(BitPattern, HashesLikeItCompares) {
+    using namespace pinepp;
+    const std::hash<bit_pattern> hasher{};
+    bit_pattern shrunk{std::string(300, '1')};
+    shrunk.resize(130);
+    EXPECT_EQ(hasher(bit_pattern{130, true}), hasher(shrunk));
+    EXPECT_EQ(hasher(bit_pattern{}), hasher(bit_pattern{}));
+    EXPECT_NE(hasher(bit_pattern{"0"}), hasher(bit_pattern{"00"}));
+
+    // EVERY SINGLE BIT PATTERN OF EVERY LENGTH UP TO 300 BITS IS DISTINCT
+    std::unordered_set<bit_pattern> patterns;
+    std::unordered_set<size_t> hashes;
+    size_t inserted = 0;
+    for (size_t len = 1; len <= 300; len += 13) {
+        for (size_t bit = 0; bit < len; ++bit) {
+            bit_pattern bp{len};
+            bp.set_bit(bit, true);
+            patterns.insert(bp);
+            patterns.insert(bit_pattern{bp});
+            hashes.insert(bp.hash());
+            inserted++;
+        }
+    }
+    EXPECT_EQ(inserted, patterns.size());
+    EXPECT_EQ(inserted, hashes.size());
+}
+
 TEST(BitPattern, Coverage) {
     using namespace pinepp;
     bit_pattern bp{"0111000101110"};
+    EXPECT_EQ(bp, rotl(bp, 0));
+    EXPECT_EQ(bp, rotr(bp, 0));
     EXPECT_EQ(bp, bp << 0);
     EXPECT_EQ(bp, bp >> 0);
     bp = "1";
-    EXPECT_EQ(bp, bp << 12);
-    EXPECT_EQ(bp, bp >> 12);
+    EXPECT_EQ(bp, rotl(bp, 12));
+    EXPECT_EQ(bp, rotr(bp, 12));
 
     EXPECT_EQ(bit_pattern() + bp, bp);
     EXPECT_EQ(bit_pattern() + bit_pattern(), bit_pattern());
 
     EXPECT_TRUE(bp.begin() == bp.begin());
-}
\ No newline at end of file
+}
+
+TEST(BitPatternKernels, AllSupportedKernelsProduceTheSameResultAsABitByBitReference) {
+    using namespace pinepp;
+    const auto initial = bit_pattern_active_kernel();
+    // LENGTHS AROUND THE WORD AND REGISTER BOUNDARIES AND THE UNROLLED LOOPS OF THE KERNELS
+    for (size_t len : {1, 63, 64, 65, 255, 256, 511, 1000, 1024, 1093, 4096}) {
+        std::string a(len, '0');
+        std::string b(len + 37, '0');
+        for (size_t i = 0; i < a.size(); ++i)
+            a[i] = (i * 7919 + 13) % 5 < 2 ? '1' : '0';
+        for (size_t i = 0; i < b.size(); ++i)
+            b[i] = (i * 104729 + 7) % 3 == 0 ? '1' : '0';
+        const bit_pattern bp1{a};
+        const bit_pattern bp2{b};
+
+        for (auto kernel : {bit_pattern_kernel::SCALAR, bit_pattern_kernel::AVX2, bit_pattern_kernel::AVX512}) {
+            if (!bit_pattern_select_kernel(kernel))
+                continue;
+            EXPECT_EQ(kernel, bit_pattern_active_kernel());
+            const auto conjunction = bp1 & bp2;
+            const auto disjunction = bp2 | bp1;
+            const auto exclusive = bp1 ^ bp2;
+            const auto negation = ~bp2;
+            ASSERT_EQ(len, conjunction.size());
+            ASSERT_EQ(len, disjunction.size());
+            ASSERT_EQ(len, exclusive.size());
+            ASSERT_EQ(len + 37, negation.size());
+            for (unsigned i = 0; i < len; ++i) {
+                EXPECT_EQ(bp1[i] & bp2[i], conjunction[i]);
+                EXPECT_EQ(bp1[i] | bp2[i], disjunction[i]);
+                EXPECT_EQ(bp1[i] ^ bp2[i], exclusive[i]);
+            }
+            for (unsigned i = 0; i < len + 37; ++i)
+                EXPECT_EQ(1 - bp2[i], negation[i]);
+            // THE BITS OF THE LONGER OPERAND PAST THE LENGTH OF THE RESULT MUST NOT LEAK INTO IT
+            EXPECT_EQ(std::string(len, '1'), (bp1 | ~bit_pattern{std::string(len + 37, '0')}).str());
+            EXPECT_EQ(bp2, ~negation);
+        }
+    }
+    bit_pattern_select_kernel(initial);
+}
+
+TEST(BitPatternCountFunctions, CountAndTestTheSetBits) {
+    using namespace pinepp;
+    bit_pattern bp{"100101010111"};
+    EXPECT_EQ(7, bp.count());
+    EXPECT_TRUE(bp.any());
+    EXPECT_FALSE(bp.none());
+    EXPECT_FALSE(bp.all());
+
+    EXPECT_TRUE(bit_pattern{"111"}.all());
+    EXPECT_TRUE(bit_pattern(size_t{64}, true).all());
+    EXPECT_TRUE(bit_pattern(size_t{130}, true).all());
+    EXPECT_EQ(130, bit_pattern(size_t{130}, true).count());
+    EXPECT_FALSE((bit_pattern(size_t{130}, true) >> 1).all());
+    EXPECT_TRUE(bit_pattern(size_t{130}).none());
+
+    // AN EMPTY PATTERN HAS NO BIT SET AND NO BIT UNSET
+    EXPECT_EQ(0, bit_pattern{}.count());
+    EXPECT_TRUE(bit_pattern{}.none());
+    EXPECT_TRUE(bit_pattern{}.all());
+}
+
+TEST(BitPatternCountFunctions, AllKernelsCountTheSameBits) {
+    using namespace pinepp;
+    const auto initial = bit_pattern_active_kernel();
+    bit_pattern bp{size_t{1000}};
+    size_t expected = 0;
+    for (int i = 0; i < 1000; ++i) {
+        bp.set_bit(i, (i * 7919 + 13) % 7 < 3);
+        expected += (i * 7919 + 13) % 7 < 3;
+    }
+    for (auto kernel : {bit_pattern_kernel::SCALAR, bit_pattern_kernel::AVX2, bit_pattern_kernel::AVX512}) {
+        if (!bit_pattern_select_kernel(kernel))
+            continue;
+        EXPECT_EQ(expected, bp.count());
+    }
+    bit_pattern_select_kernel(initial);
+}
+
+TEST(BitPatternFindFunctions, VisitTheSetBitsInOrder) {
+    using namespace pinepp;
+    bit_pattern bp{size_t{300}};
+    const std::vector<size_t> set{3, 63, 64, 65, 127, 200, 299};
+    for (auto i : set)
+        bp.set_bit(i, true);
+
+    std::vector<size_t> found;
+    for (auto i = bp.find_first(); i != bit_pattern::npos; i = bp.find_next(i))
+        found.push_back(i);
+    EXPECT_EQ(set, found);
+    EXPECT_EQ(299, bp.find_last());
+    EXPECT_EQ(3, bp.countr_zero());
+    EXPECT_EQ(0, bp.countl_zero());
+    EXPECT_EQ(bit_pattern::npos, bp.find_next(299));
+    EXPECT_EQ(bit_pattern::npos, bp.find_next(1000));
+
+    bp.set_bit(299, false);
+    EXPECT_EQ(200, bp.find_last());
+    EXPECT_EQ(99, bp.countl_zero());
+
+    const bit_pattern empty{size_t{100}};
+    EXPECT_EQ(bit_pattern::npos, empty.find_first());
+    EXPECT_EQ(bit_pattern::npos, empty.find_last());
+    EXPECT_EQ(100, empty.countl_zero());
+    EXPECT_EQ(100, empty.countr_zero());
+    EXPECT_EQ(bit_pattern::npos, bit_pattern{}.find_first());
+    EXPECT_EQ(bit_pattern::npos, bit_pattern{}.find_next(0));
+}
+
+TEST(BitPatternFindFunctions, SetBitsVisitsTheSameBitsAsFindNext) {
+    using namespace pinepp;
+    bit_pattern bp{size_t{300}};
+    const std::vector<size_t> set{0, 3, 63, 64, 65, 127, 200, 299};
+    for (auto i : set)
+        bp.set_bit(i, true);
+    EXPECT_EQ(set, std::vector<size_t>(bp.set_bits().begin(), bp.set_bits().end()));
+
+    static_assert(std::forward_iterator<bit_pattern::set_bit_iterator>);
+    const auto range = bp.set_bits();
+    EXPECT_EQ(set.size(), static_cast<size_t>(std::distance(range.begin(), range.end())));
+    EXPECT_EQ(2, std::ranges::count_if(range, [](size_t i) { return i % 64 == 63; }));
+    EXPECT_EQ(range.begin(), range.begin());
+    EXPECT_NE(range.begin(), range.end());
+
+    for (size_t len : {0ul, 1ul, 64ul, 1000ul}) {
+        const bit_pattern empty{len};
+        EXPECT_EQ(empty.set_bits().begin(), empty.set_bits().end());
+        const bit_pattern full{len, true};
+        size_t expected = 0;
+        for (size_t i : full.set_bits())
+            EXPECT_EQ(expected++, i);
+        EXPECT_EQ(len, expected);
+    }
+}
+
+TEST(BitPatternRankSelect, MatchesALinearScan) {
+    using namespace pinepp;
+    // DENSE AND SPARSE REGIONS, SO THE SEARCH BETWEEN TWO SAMPLES SPANS BOTH FEW AND MANY LOWER BLOCKS
+    bit_pattern bp{size_t{100000}};
+    for (int i = 0; i < 100000; ++i)
+        bp.set_bit(i, i < 40000 ? (i * 7919 + 13) % 3 != 0 : i % 997 == 0);
+
+    size_t ones = 0;
+    for (size_t i = 0; i < bp.size(); ++i) {
+        ASSERT_EQ(ones, bp.rank1(i));
+        if (bp[static_cast<unsigned>(i)]) {
+            ASSERT_EQ(i, bp.select1(ones));
+            ++ones;
+        }
+    }
+    EXPECT_EQ(ones, bp.rank1(bp.size()));
+    EXPECT_EQ(ones, bp.rank1(bit_pattern::npos));
+    EXPECT_EQ(bit_pattern::npos, bp.select1(ones));
+    EXPECT_EQ(bp.find_first(), bp.select1(0));
+    EXPECT_EQ(bp.find_last(), bp.select1(ones - 1));
+}
+
+TEST(BitPatternRankSelect, IsRebuiltAfterThePatternChanges) {
+    using namespace pinepp;
+    bit_pattern bp{"1010"};
+    EXPECT_EQ(1, bp.rank1(2));
+    EXPECT_EQ(3, bp.select1(1));
+
+    bp.set_bit(0, true);
+    EXPECT_EQ(2, bp.rank1(2));
+    EXPECT_EQ(1, bp.select1(1));
+
+    // A COPY SHARES THE DIRECTORY UNTIL ONE OF THEM CHANGES
+    auto copy = bp;
+    copy.set_bit(2, true);
+    EXPECT_EQ(2, bp.rank1(2));
+    EXPECT_EQ(3, copy.rank1(3));
+
+    copy <<= 1;
+    EXPECT_EQ(2, copy.rank1(3));
+    copy = "0000";
+    EXPECT_EQ(0, copy.rank1(4));
+    EXPECT_EQ(bit_pattern::npos, copy.select1(0));
+    EXPECT_EQ(bit_pattern::npos, bit_pattern{}.select1(0));
+    EXPECT_EQ(0, bit_pattern{}.rank1(0));
+}
+
+TEST(BitPatternRankSelect, CanBeBuiltByConcurrentReaders) {
+    using namespace pinepp;
+    bit_pattern bp{size_t{200000}};
+    for (size_t i = 0; i < bp.size(); i += 3)
+        bp.set_bit(i, true);
+
+    // EVERY THREAD RACES TO BUILD THE DIRECTORY OF THE SAME FRESH PATTERN
+    std::vector<size_t> ranks(4);
+    std::vector<size_t> selects(4);
+    std::vector<std::thread> readers;
+    for (size_t t = 0; t < ranks.size(); ++t) {
+        readers.emplace_back([&, t] {
+            ranks[t] = bp.rank1(150000);
+            selects[t] = bp.select1(50000);
+        });
+    }
+    for (auto& reader : readers)
+        reader.join();
+    for (size_t t = 0; t < ranks.size(); ++t) {
+        EXPECT_EQ(50000, ranks[t]);
+        EXPECT_EQ(150000, selects[t]);
+    }
+}
+
+TEST(BitPatternCompoundAssignment, CombinesInPlace) {
+    using namespace pinepp;
+    bit_pattern bp{"1100"};
+    bp &= bit_pattern{"1010"};
+    EXPECT_EQ("1000", bp.str());
+    bp |= bit_pattern{"0011"};
+    EXPECT_EQ("1011", bp.str());
+    bp ^= bit_pattern{"1110"};
+    EXPECT_EQ("0101", bp.str());
+    bp.flip();
+    EXPECT_EQ("1010", bp.str());
+    EXPECT_EQ(2, bp.rank1(4));
+
+    // LIKE THE BINARY OPERATORS, THE RESULT HAS THE LENGTH OF THE SHORTER PATTERN
+    bit_pattern longer{"111111"};
+    longer |= bit_pattern{"0000"};
+    EXPECT_EQ("1111", longer.str());
+    EXPECT_EQ(4, longer.count());
+    bp &= bp;
+    EXPECT_EQ("1010", bp.str());
+}
+
+TEST(BitPatternExpressions, MatchTheStepByStepResult) {
+    using namespace pinepp;
+    // SPANS MORE THAN ONE BLOCK OF THE EVALUATION
+    const size_t len = BIT_EXPRESSION_BLOCK * 64 * 3 + 77;
+    bit_pattern a(len), b(len + 100), c(len), d(len + 3);
+    for (size_t i = 0; i < len; ++i) {
+        a.set_bit(i, i % 3 == 0);
+        b.set_bit(i, i % 5 < 2);
+        c.set_bit(i, i % 7 == 1);
+        d.set_bit(i, (i * 31) % 11 < 4);
+    }
+    b.set_bit(len + 50, true);
+
+    const bit_pattern fused = (a & b) | ~(c ^ d);
+    bit_pattern step = c;
+    step ^= d;
+    step.flip();
+    bit_pattern conjunction = a;
+    conjunction &= b;
+    step |= conjunction;
+    EXPECT_EQ(len, fused.size());
+    EXPECT_EQ(step, fused);
+
+    // THE DESTINATION MAY BE AN OPERAND AT ANY DEPTH OF THE EXPRESSION
+    bit_pattern dst = a;
+    dst = (b & c) | (dst ^ d);
+    EXPECT_EQ(bit_pattern{(b & c) | (a ^ d)}, dst);
+    dst = a;
+    dst ^= b & ~dst;
+    EXPECT_EQ(bit_pattern{a | b}, dst);
+}
+
+TEST(BitPatternExpressions, AreLazyAndOwnTemporaries) {
+    using namespace pinepp;
+    const bit_pattern bp{"1100"};
+    const auto expression = bp ^ bit_pattern{"0110"} ^ bit_pattern{"1111"};
+    EXPECT_EQ(4, expression.size());
+    EXPECT_EQ(1, expression[0]);
+    EXPECT_EQ(0, expression[1]);
+    EXPECT_EQ("0101", expression.str());
+    EXPECT_EQ("0101", expression.eval().str());
+
+    testing::internal::CaptureStdout();
+    std::cout << ~expression;
+    EXPECT_EQ("1010", testing::internal::GetCapturedStdout());
+    EXPECT_EQ(0, bit_pattern{bit_pattern{} & bp}.size());
+}
+
+TEST(BitPatternSmallBuffer, CopiesAndMovesAcrossTheInlineLimit) {
+    using namespace pinepp;
+    // 128 BITS FIT INLINE, 129 BITS DON'T
+    for (size_t len : {1ul, 64ul, 127ul, 128ul, 129ul, 1000ul}) {
+        bit_pattern original(len);
+        for (size_t i = 0; i < len; i += 3)
+            original.set_bit(i, true);
+
+        bit_pattern copy{original};
+        EXPECT_EQ(original, copy);
+        bit_pattern moved{std::move(copy)};
+        EXPECT_EQ(original, moved);
+        EXPECT_EQ(0, copy.size());
+
+        // ASSIGNMENTS BETWEEN A SMALL AND A LARGE PATTERN IN BOTH DIRECTIONS
+        bit_pattern small{"101"};
+        bit_pattern large(500, true);
+        small = original;
+        large = original;
+        EXPECT_EQ(original, small);
+        EXPECT_EQ(original, large);
+        small = bit_pattern(500, true);
+        large = bit_pattern{"101"};
+        EXPECT_EQ(500, small.count());
+        EXPECT_EQ("101", large.str());
+        small = std::move(moved);
+        EXPECT_EQ(original, small);
+
+        // A PATTERN CAN OUTGROW ITS INLINE WORDS AND GET BACK UNDER THE LIMIT
+        auto grown = original;
+        grown.resize(len + 200);
+        EXPECT_EQ(original.count(), grown.count());
+        grown.resize(len);
+        EXPECT_EQ(original, grown);
+    }
+}
+
+TEST(BitPatternParsing, MatchesTheCharactersWithEveryKernel) {
+    using namespace pinepp;
+    const auto initial = bit_pattern_active_kernel();
+    for (auto kernel : {bit_pattern_kernel::SCALAR, bit_pattern_kernel::AVX2, bit_pattern_kernel::AVX512}) {
+        if (!bit_pattern_select_kernel(kernel))
+            continue;
+        for (size_t len : {1ul, 63ul, 64ul, 65ul, 128ul, 200ul, 20000ul}) {
+            std::string binary(len, '0');
+            std::string hex = "0x" + std::string(len, '0');
+            for (size_t i = 0; i < len; ++i) {
+                binary[i] = (i * 7919 + 13) % 3 == 0 ? '1' : '0';
+                hex[i + 2] = "0123456789abcdefABCDEF"[(i * 104729 + 7) % 22];
+            }
+            const bit_pattern from_binary{binary};
+            ASSERT_EQ(len, from_binary.size());
+            EXPECT_EQ(binary, from_binary.str());
+            for (size_t i = 0; i < len; ++i)
+                ASSERT_EQ(binary[len - 1 - i] - '0', from_binary[static_cast<unsigned>(i)]);
+
+            const bit_pattern from_hex{hex};
+            ASSERT_EQ(4 * len, from_hex.size());
+            std::string lower = hex;
+            std::transform(lower.begin(), lower.end(), lower.begin(), [](char c) {
+                return static_cast<char>(std::tolower(c));
+            });
+            EXPECT_EQ(lower, from_hex.hex_str());
+
+            // ONE INVALID CHARACTER ANYWHERE MAKES THE WHOLE STRING INVALID
+            for (size_t position : {size_t{0}, len / 2, len - 1}) {
+                auto invalid = binary;
+                invalid[position] = '2';
+                EXPECT_EQ(0, bit_pattern{invalid}.size());
+                invalid = hex;
+                invalid[position + 2] = 'g';
+                EXPECT_EQ(0, bit_pattern{invalid}.size());
+            }
+        }
+    }
+    bit_pattern_select_kernel(initial);
+    EXPECT_EQ(0, bit_pattern{"0x"}.size());
+    EXPECT_EQ(0, bit_pattern{"0X/"}.size());
+    EXPECT_EQ(0, bit_pattern{""}.size());
+    EXPECT_EQ("0000000100011010", bit_pattern{"0X011a"}.str());
+}
+
+TEST(BitPatternFormatting, WritesBinaryAndHex) {
+    using namespace pinepp;
+    const bit_pattern bp{"110100111"};
+    EXPECT_EQ("0x1a7", bp.hex_str());
+    EXPECT_EQ("", bit_pattern{}.hex_str());
+
+    std::ostringstream output;
+    output << bp << ' ' << std::hex << bp << ' ' << std::showbase << bp;
+    EXPECT_EQ("110100111 1a7 0x1a7", output.str());
+
+    // LONGER THAN THE BUFFER OF THE OSTREAM OPERATOR
+    bit_pattern large(10000);
+    for (size_t i = 0; i < large.size(); i += 7)
+        large.set_bit(i, true);
+    std::ostringstream binary;
+    std::ostringstream hex;
+    binary << large;
+    hex << std::hex << large;
+    EXPECT_EQ(large.str(), binary.str());
+    EXPECT_EQ(large.hex_str().substr(2), hex.str());
+    EXPECT_EQ(large, bit_pattern{large.hex_str()});
+}
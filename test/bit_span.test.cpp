@@ -0,0 +1,171 @@
+//
+// Created by konstantin on 17.10.26.
+//
+#include <random>
+#include <string>
+#include "bit_span.hpp"
+#include "gtest/gtest.h"
+
+namespace {
+    /**
+     * @details Fills a pattern of \p n bits with random bits and returns it with its bits as a reference string,
+     * indexed like the pattern rather than printed like str().
+     */
+    std::pair<pinepp::bit_pattern, std::string> make_random_pattern(size_t n, uint32_t seed) {
+        std::mt19937 gen{seed};
+        pinepp::bit_pattern pattern{n};
+        std::string bits(n, '0');
+        for (size_t i = 0; i < n; ++i) {
+            if (gen() % 3 == 0) {
+                pattern[i] = true;
+                bits[i] = '1';
+            }
+        }
+        return {pattern, bits};
+    }
+
+    std::string bits_of(const pinepp::bit_pattern& pattern) {
+        std::string rv(pattern.size(), '0');
+        for (size_t i = 0; i < pattern.size(); ++i)
+            rv[i] = pattern[i] ? '1' : '0';
+        return rv;
+    }
+
+    template <typename Span>
+    concept writable_span = requires(Span span) { span.set_range(0, 1); };
+
+    const std::vector<std::pair<size_t, size_t>> RANGES{
+            {0, 0}, {0, 1}, {5, 3}, {0, 64}, {1, 63}, {63, 2}, {64, 64}, {3, 125}, {70, 300}, {0, 1000}, {999, 1}};
+}
+
+TEST(BitSpan, ViewsAPatternWithoutCopying) {
+    using namespace pinepp;
+    auto [pattern, bits] = make_random_pattern(1000, 1);
+    const bit_span all{pattern};
+    EXPECT_EQ(1000, all.size());
+    EXPECT_EQ(pattern.count(), all.count());
+    EXPECT_TRUE(bit_span{}.empty());
+
+    for (const auto& [first, n] : RANGES) {
+        const auto view = all.subspan(first, n);
+        ASSERT_EQ(n, view.size());
+        for (size_t i = 0; i < n; ++i)
+            ASSERT_EQ(bits[first + i] - '0', view[i]);
+        const auto expected = static_cast<size_t>(std::count(bits.begin() + static_cast<ptrdiff_t>(first),
+                                                             bits.begin() + static_cast<ptrdiff_t>(first + n), '1'));
+        EXPECT_EQ(expected, view.count()) << first << ' ' << n;
+        EXPECT_EQ(expected, all.count_range(first, n));
+        EXPECT_EQ(bits.substr(first, n), bits_of(view.to_bit_pattern()));
+        EXPECT_EQ(view.count(), bit_span(pattern, first, n).count());
+    }
+
+    // WRITES THROUGH THE VIEW ARE VISIBLE IN THE PATTERN
+    all.subspan(100, 50).set_bit(7, !pattern[107]);
+    EXPECT_NE(bits[107] - '0', pattern[107]);
+}
+
+TEST(BitSpan, SetsResetsAndFlipsRanges) {
+    using namespace pinepp;
+    for (const auto& [first, n] : RANGES) {
+        for (int op = 0; op < 3; ++op) {
+            auto [pattern, bits] = make_random_pattern(1000, static_cast<uint32_t>(first + n));
+            const bit_span view{pattern};
+            if (op == 0)
+                view.set_range(first, n);
+            else if (op == 1)
+                view.reset_range(first, n);
+            else
+                view.flip_range(first, n);
+            for (size_t i = first; i < first + n; ++i)
+                bits[i] = op == 0 ? '1' : op == 1 ? '0' : static_cast<char>('0' + '1' - bits[i]);
+            EXPECT_EQ(bits, bits_of(pattern)) << first << ' ' << n << ' ' << op;
+        }
+    }
+}
+
+TEST(BitSpan, CombinesUnalignedSpansWithEveryKernel) {
+    using namespace pinepp;
+    const auto initial = bit_pattern_active_kernel();
+    for (auto kernel : {bit_pattern_kernel::SCALAR, bit_pattern_kernel::AVX2, bit_pattern_kernel::AVX512}) {
+        if (!bit_pattern_select_kernel(kernel))
+            continue;
+        const auto [src, src_bits] = make_random_pattern(3000, 2);
+        for (size_t dst_first : {0ul, 1ul, 64ul, 100ul}) {
+            for (size_t src_first : {0ul, 7ul, 64ul, 100ul, 163ul}) {
+                for (size_t n : {0ul, 1ul, 60ul, 64ul, 200ul, 2700ul}) {
+                    for (int op = 0; op < 4; ++op) {
+                        auto [dst, dst_bits] = make_random_pattern(3000, 3);
+                        const bit_span to{dst, dst_first, n};
+                        const const_bit_span from{src, src_first, n};
+                        if (op == 0)
+                            to &= from;
+                        else if (op == 1)
+                            to |= from;
+                        else if (op == 2)
+                            to ^= from;
+                        else
+                            to.assign(from);
+                        for (size_t i = 0; i < n; ++i) {
+                            const bool a = dst_bits[dst_first + i] == '1';
+                            const bool b = src_bits[src_first + i] == '1';
+                            const bool r = op == 0 ? a && b : op == 1 ? a || b : op == 2 ? a != b : b;
+                            dst_bits[dst_first + i] = r ? '1' : '0';
+                        }
+                        ASSERT_EQ(dst_bits, bits_of(dst)) << dst_first << ' ' << src_first << ' ' << n << ' ' << op;
+                    }
+                }
+            }
+        }
+    }
+    bit_pattern_select_kernel(initial);
+}
+
+TEST(BitSpan, ViewsRawWords) {
+    using namespace pinepp;
+    uint64_t words[3]{0, ~uint64_t{0}, 0};
+    const bit_span view{words, 60, 130};
+    EXPECT_EQ(64, view.count());
+    view.flip_range(0, 130);
+    EXPECT_EQ(66, view.count());
+    EXPECT_EQ(0xf000000000000000, words[0]);
+    EXPECT_EQ(0, words[1]);
+    EXPECT_EQ(0x3fffffffffffffff, words[2]);
+
+    const uint64_t constant[1]{0xff};
+    const const_bit_span read_only{constant, 4, 8};
+    EXPECT_EQ(4, read_only.count());
+    // BITS 4 TO 11 OF 0xff ARE 0x0f, WHICH END UP IN BITS 62 TO 69 OF THE WORDS
+    view.subspan(2, 8).assign(read_only);
+    EXPECT_EQ(0xf000000000000000, words[0]);
+    EXPECT_EQ(0x3, words[1]);
+}
+
+TEST(BitSpan, ChecksRangesAndKeepsTheRankDirectoryCurrent) {
+    using namespace pinepp;
+    bit_pattern pattern{size_t{200}};
+    const bit_span view{pattern, 10, 100};
+    EXPECT_THROW(bit_span(pattern, 150, 51), std::out_of_range);
+    EXPECT_THROW(static_cast<void>(view.subspan(90, 11)), std::out_of_range);
+    EXPECT_THROW(view.set_range(101, 0), std::out_of_range);
+    EXPECT_THROW(view.set_bit(100, true), std::out_of_range);
+    EXPECT_THROW(static_cast<void>(view.count_range(50, 51)), std::out_of_range);
+    EXPECT_THROW(view &= view.subspan(0, 99), std::invalid_argument);
+    view.set_range(100, 0);
+
+    EXPECT_EQ(0, pattern.rank1(200));
+    view.set_range(0, 100);
+    EXPECT_EQ(100, pattern.rank1(200));
+    EXPECT_EQ(10, pattern.select1(0));
+    view.subspan(0, 50) ^= view.subspan(50, 50);
+    EXPECT_EQ(50, pattern.rank1(200));
+    EXPECT_EQ(60, pattern.select1(0));
+
+    // READ-ONLY VIEWS OF CONST PATTERNS, AND WRITABLE VIEWS CONVERT TO THEM
+    const bit_pattern& constant = pattern;
+    const const_bit_span read_only{constant, 60, 50};
+    EXPECT_EQ(50, read_only.count());
+    const const_bit_span converted = view;
+    EXPECT_EQ(50, converted.count());
+    static_assert(!writable_span<const_bit_span>);
+    static_assert(writable_span<bit_span>);
+}
@@ -0,0 +1,197 @@
+//
+// Created by konstantin on 17.10.26.
+//
+#include <random>
+#include <sstream>
+#include <vector>
+#include "compressed_bit_pattern.hpp"
+#include "gtest/gtest.h"
+
+namespace {
+    /**
+     * @details Builds a pattern spanning a few chunks with a sparse, a dense, a clustered and an empty chunk, so
+     * every container kind takes part.
+     */
+    pinepp::bit_pattern make_mixed_pattern(size_t n, uint32_t seed) {
+        pinepp::bit_pattern rv(n);
+        std::mt19937 gen{seed};
+        for (size_t i = 0; i < n; ++i) {
+            const auto chunk = i / 65536 % 4;
+            if ((chunk == 0 && gen() % 100 == 0) || (chunk == 1 && gen() % 2 == 0) ||
+                (chunk == 2 && i / (500 + seed) % 3 == 0))
+                rv.set_bit(i, true);
+        }
+        return rv;
+    }
+}
+
+TEST(CompressedBitPatternConstructor, StartsWithAllBitsCleared) {
+    using namespace pinepp;
+
+    compressed_bit_pattern cbp{1000};
+    EXPECT_EQ(cbp.size(), 1000);
+    EXPECT_EQ(cbp.count(), 0);
+    EXPECT_TRUE(cbp.none());
+    EXPECT_EQ(cbp.memory_usage(), 0);
+    EXPECT_EQ(cbp.find_first(), compressed_bit_pattern::npos);
+    EXPECT_EQ(compressed_bit_pattern{}.size(), 0);
+}
+
+TEST(CompressedBitPatternConversion, RoundTripsThroughBitPattern) {
+    using namespace pinepp;
+
+    for (size_t n : {1ul, 63ul, 65536ul, 65537ul, 300000ul}) {
+        const auto bp = make_mixed_pattern(n, 7);
+        const compressed_bit_pattern cbp{bp};
+        EXPECT_EQ(cbp.size(), n);
+        EXPECT_EQ(cbp.count(), bp.count());
+        EXPECT_EQ(cbp.to_bit_pattern(), bp);
+    }
+}
+
+TEST(CompressedBitPatternOutput, WritesLikeBitPattern) {
+    using namespace pinepp;
+
+    const bit_pattern bp{"1001101"};
+    std::ostringstream expected;
+    std::ostringstream output;
+    expected << bp;
+    output << compressed_bit_pattern{bp};
+    EXPECT_EQ(output.str(), expected.str());
+}
+
+TEST(CompressedBitPatternOperators, MatchBitPattern) {
+    using namespace pinepp;
+
+    const auto a = make_mixed_pattern(300000, 3);
+    const auto b = make_mixed_pattern(300000, 11);
+    const compressed_bit_pattern ca{a};
+    const compressed_bit_pattern cb{b};
+    EXPECT_EQ((ca & cb).to_bit_pattern(), a & b);
+    EXPECT_EQ((ca | cb).to_bit_pattern(), a | b);
+    EXPECT_EQ((ca ^ cb).to_bit_pattern(), a ^ b);
+    EXPECT_EQ((~ca).to_bit_pattern(), ~a);
+    EXPECT_EQ(~~ca, ca);
+    EXPECT_EQ((ca ^ ca).count(), 0);
+}
+
+TEST(CompressedBitPatternOperators, UseTheLengthOfTheShorterPattern) {
+    using namespace pinepp;
+
+    const auto a = make_mixed_pattern(300000, 5);
+    const auto b = make_mixed_pattern(100000, 9);
+    const compressed_bit_pattern ca{a};
+    const compressed_bit_pattern cb{b};
+    bit_pattern a_short(100000);
+    for (size_t i = 0; i < 100000; ++i)
+        a_short.set_bit(i, a[i]);
+    EXPECT_EQ((ca | cb).size(), 100000);
+    EXPECT_EQ((ca | cb).to_bit_pattern(), a_short | b);
+    EXPECT_EQ((cb ^ ca).to_bit_pattern(), b ^ a_short);
+    EXPECT_EQ((ca & cb).to_bit_pattern(), a_short & b);
+}
+
+TEST(CompressedBitPatternSetBit, ChangesContainersAsTheyFill) {
+    using namespace pinepp;
+
+    compressed_bit_pattern cbp{70000};
+    bit_pattern bp(70000);
+    // AN ARRAY GROWS INTO A BITMAP AND SHRINKS BACK
+    for (size_t i = 0; i < 5000; ++i) {
+        cbp.set_bit(i * 13, true);
+        bp.set_bit(i * 13, true);
+    }
+    EXPECT_EQ(cbp.count(), 5000);
+    EXPECT_EQ(cbp.to_bit_pattern(), bp);
+    for (size_t i = 0; i < 5000; i += 2) {
+        cbp.set_bit(i * 13, false);
+        bp.set_bit(i * 13, false);
+    }
+    EXPECT_EQ(cbp.count(), 2500);
+    EXPECT_EQ(cbp.to_bit_pattern(), bp);
+
+    // A RUN IS SPLIT BY CLEARING A BIT IN THE MIDDLE
+    auto full = ~compressed_bit_pattern{70000};
+    full.set_bit(66000, false);
+    EXPECT_EQ(full.count(), 69999);
+    EXPECT_EQ(full[66000], 0);
+    EXPECT_EQ(full[66001], 1);
+    EXPECT_EQ(full.find_next(65999), 66001);
+
+    EXPECT_THROW(cbp.set_bit(70000, true), std::out_of_range);
+}
+
+TEST(CompressedBitPatternSetBit, DropsEmptyChunks) {
+    using namespace pinepp;
+
+    compressed_bit_pattern cbp{200000};
+    cbp.set_bit(150000, true);
+    EXPECT_GT(cbp.memory_usage(), 0);
+    cbp.set_bit(150000, false);
+    EXPECT_TRUE(cbp.none());
+    EXPECT_EQ(cbp.memory_usage(), 0);
+    EXPECT_EQ(cbp, compressed_bit_pattern{200000});
+}
+
+TEST(CompressedBitPatternFind, VisitsEverySetBit) {
+    using namespace pinepp;
+
+    const auto bp = make_mixed_pattern(300000, 13);
+    const compressed_bit_pattern cbp{bp};
+    size_t visited = 0;
+    for (auto i = cbp.find_first(); i != compressed_bit_pattern::npos; i = cbp.find_next(i)) {
+        EXPECT_EQ(bp[i], 1);
+        visited++;
+    }
+    EXPECT_EQ(visited, bp.count());
+
+    size_t set = 0;
+    for (int bit : cbp)
+        set += static_cast<size_t>(bit);
+    EXPECT_EQ(set, bp.count());
+}
+
+TEST(CompressedBitPatternFind, SetBitsWalksEveryContainer) {
+    using namespace pinepp;
+
+    const auto bp = make_mixed_pattern(300000, 7);
+    const compressed_bit_pattern cbp{bp};
+    const auto range = cbp.set_bits();
+    EXPECT_EQ(std::vector<size_t>(range.begin(), range.end()),
+              std::vector<size_t>(bp.set_bits().begin(), bp.set_bits().end()));
+
+    // RUNS ARE SPLIT AND THE LAST CHUNK IS PARTIAL
+    auto full = ~compressed_bit_pattern{70000};
+    full.set_bit(0, false);
+    full.set_bit(66000, false);
+    std::vector<size_t> expected;
+    for (size_t i = 1; i < 70000; ++i) {
+        if (i != 66000)
+            expected.push_back(i);
+    }
+    EXPECT_EQ(std::vector<size_t>(full.set_bits().begin(), full.set_bits().end()), expected);
+
+    const compressed_bit_pattern empty{200000};
+    EXPECT_EQ(empty.set_bits().begin(), empty.set_bits().end());
+}
+
+TEST(CompressedBitPatternMemory, StaysSmallForSparseHugePatterns) {
+    using namespace pinepp;
+
+    // 2^32 BITS WOULD TAKE 512 MIB UNCOMPRESSED
+    const size_t n = size_t{1} << 32;
+    compressed_bit_pattern cbp{n};
+    for (size_t i = 0; i < 1000; ++i)
+        cbp.set_bit(i * 4294967ul, true);
+    cbp.set_bit(n - 1, true);
+    EXPECT_EQ(cbp.count(), 1001);
+    EXPECT_LT(cbp.memory_usage(), 128 * 1024);
+    EXPECT_EQ(cbp.find_next(999 * 4294967ul), n - 1);
+
+    // THE COMPLEMENT IS MADE OF RUNS
+    const auto complement = ~cbp;
+    EXPECT_EQ(complement.count(), n - 1001);
+    EXPECT_LT(complement.memory_usage(), 16 * 1024 * 1024);
+    EXPECT_EQ((complement & cbp).count(), 0);
+    EXPECT_EQ((complement | cbp).count(), n);
+}
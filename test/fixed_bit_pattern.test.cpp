@@ -0,0 +1,96 @@
+//
+// Created by konstantin on 17.10.26.
+//
+#include <sstream>
+#include "fixed_bit_pattern.hpp"
+#include "gtest/gtest.h"
+
+namespace {
+    using pinepp::fixed_bit_pattern;
+
+    // EVERYTHING BUT THE CONVERSIONS AND THE OUTPUT IS USABLE AT COMPILE-TIME
+    constexpr fixed_bit_pattern<8> FLAGS{"10110010"};
+    static_assert(FLAGS.count() == 4);
+    static_assert(FLAGS.find_first() == 1 && FLAGS.find_next(1) == 4 && FLAGS.find_last() == 7);
+    static_assert((FLAGS & fixed_bit_pattern<8>{0x0f}) == fixed_bit_pattern<8>{"0010"});
+    static_assert((FLAGS | fixed_bit_pattern<8>{0x0f}) == fixed_bit_pattern<8>{"0xbf"});
+    static_assert((FLAGS ^ FLAGS).none());
+    static_assert((FLAGS | ~FLAGS).all());
+    static_assert((FLAGS << 1) == fixed_bit_pattern<8>{"01100100"});
+    static_assert((FLAGS >> 3) == fixed_bit_pattern<8>{"10110"});
+    static_assert(pinepp::rotl(FLAGS, 3) == fixed_bit_pattern<8>{"10010101"});
+    static_assert(pinepp::rotr(FLAGS, 3) == fixed_bit_pattern<8>{"01010110"});
+    static_assert(fixed_bit_pattern<8>{FLAGS}.reverse() == fixed_bit_pattern<8>{"01001101"});
+    static_assert(fixed_bit_pattern<8>{FLAGS}.set_bit(0, true).count() == 5);
+    static_assert(FLAGS + fixed_bit_pattern<4>{"0011"} == fixed_bit_pattern<12>{"101100100011"});
+    static_assert(fixed_bit_pattern<0>{}.none() && fixed_bit_pattern<0>{}.all());
+    static_assert(fixed_bit_pattern<4>{0xff}.count() == 4);
+
+    /**
+     * @returns A pattern of N bits with an irregular mix of bits across word boundaries
+     */
+    template <size_t N>
+    constexpr fixed_bit_pattern<N> make_pattern(size_t seed) {
+        fixed_bit_pattern<N> rv;
+        for (size_t i = 0; i < N; ++i)
+            rv.set_bit(i, (i * 7919 + seed) % 5 < 2);
+        return rv;
+    }
+}
+
+TEST(FixedBitPatternConstructor, RejectsInvalidStrings) {
+    EXPECT_THROW(fixed_bit_pattern<8>{"102"}, std::invalid_argument);
+    EXPECT_THROW(fixed_bit_pattern<8>{""}, std::invalid_argument);
+    EXPECT_THROW(fixed_bit_pattern<8>{"0xfg"}, std::invalid_argument);
+    EXPECT_THROW(fixed_bit_pattern<8>{"100000000"}, std::invalid_argument);
+    EXPECT_THROW(fixed_bit_pattern<6>{"0xff"}, std::invalid_argument);
+    // LEADING ZEROS DON'T NEED TO FIT
+    EXPECT_EQ(fixed_bit_pattern<6>{"0x3f"}, fixed_bit_pattern<6>{"000111111"});
+    EXPECT_THROW(fixed_bit_pattern<8>{}.set_bit(8, true), std::out_of_range);
+}
+
+TEST(FixedBitPatternConversion, RoundTripsThroughBitPattern) {
+    using namespace pinepp;
+    constexpr auto fixed = make_pattern<200>(3);
+    const auto dynamic = fixed.to_bit_pattern();
+    EXPECT_EQ(200, dynamic.size());
+    EXPECT_EQ(fixed.str(), dynamic.str());
+    EXPECT_EQ(fixed, fixed_bit_pattern<200>{dynamic});
+
+    // CUT OR PADDED TO THE SIZE OF THE FIXED PATTERN
+    EXPECT_EQ(fixed_bit_pattern<130>{dynamic}.str(), dynamic.str().substr(70));
+    EXPECT_EQ(fixed_bit_pattern<300>{dynamic}.str(), std::string(100, '0') + dynamic.str());
+}
+
+TEST(FixedBitPatternOperators, MatchBitPattern) {
+    using namespace pinepp;
+    constexpr size_t n = 333;
+    const auto a = make_pattern<n>(1);
+    const auto b = make_pattern<n>(4);
+    const auto da = a.to_bit_pattern();
+    const auto db = b.to_bit_pattern();
+
+    EXPECT_EQ((a & b).to_bit_pattern(), da & db);
+    EXPECT_EQ((a | b).to_bit_pattern(), da | db);
+    EXPECT_EQ((a ^ b).to_bit_pattern(), da ^ db);
+    EXPECT_EQ((~a).to_bit_pattern(), ~da);
+    EXPECT_EQ(a.count(), da.count());
+    EXPECT_EQ(a.countl_zero(), da.countl_zero());
+    EXPECT_EQ(a.countr_zero(), da.countr_zero());
+    for (size_t shift : {0ul, 1ul, 63ul, 64ul, 65ul, 200ul, 332ul, 333ul, 1000ul}) {
+        EXPECT_EQ((a << shift).to_bit_pattern(), da << shift);
+        EXPECT_EQ((a >> shift).to_bit_pattern(), da >> shift);
+        EXPECT_EQ(rotl(a, shift).to_bit_pattern(), rotl(da, shift));
+        EXPECT_EQ(rotr(a, shift).to_bit_pattern(), rotr(da, shift));
+    }
+    auto reversed = da;
+    reversed.reverse();
+    EXPECT_EQ(fixed_bit_pattern<n>{a}.reverse().to_bit_pattern(), reversed);
+    EXPECT_EQ((a + b).to_bit_pattern(), da + db);
+}
+
+TEST(FixedBitPatternOutput, WritesLikeBitPattern) {
+    std::ostringstream output;
+    output << fixed_bit_pattern<6>{"0x2b"};
+    EXPECT_EQ("101011", output.str());
+}